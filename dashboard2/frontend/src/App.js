@@ -62,7 +62,8 @@ function App() {
         .map((item) => {
           try {
             const parsed = JSON.parse(item.payload);
-            if (item.eventType !== 'gps') return null;
+            // Fire predictions arrive on the alert topic with the same payload
+            if (item.eventType !== 'gps' && item.eventType !== 'alert') return null;
 
             const cleanPayload = parsed.Payload.replace(/\s+/g, ' ').trim();
             const matches = {
@@ -0,0 +1,298 @@
+#ifndef DUCK_BATCH_H
+#define DUCK_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "DuckPayload.h"
+
+// Time-series batch of readings from one MamaDuck packed into a single CDP
+// payload, Gorilla style: timestamps are delta-of-delta coded and every
+// quantized value is delta coded against the previous reading, both with
+// variable-length prefix buckets so unchanged values cost a single bit.
+//
+// Layout: u8 MAGIC, u8 VERSION, u8 reading count, then a bit stream (MSB
+// first). The first reading is stored raw; each later reading stores
+//   timestamp delta-of-delta, counter delta - 1, then deltas of temp,
+//   humidity, pressure, gas, latitude, longitude, altitude, and 2 flag bits.
+// Quantization matches DuckPayload; timestamps are in 0.1 s of node uptime.
+namespace DuckBatch {
+
+static const uint8_t MAGIC = 0x0B;   // not printable, not a DuckPayload version byte
+static const uint8_t VERSION = 1;
+static const size_t HEADER_SIZE = 3;
+static const size_t MAX_PAYLOAD = 229;  // CDP maximum data length
+static const uint8_t MAX_READINGS = 255;
+
+struct Entry {
+    uint32_t timestamp;  // 0.1 s
+    uint32_t counter;
+    int32_t temp;
+    int32_t humidity;
+    int32_t pressure;
+    int32_t gas;
+    int32_t latitude;
+    int32_t longitude;
+    int32_t altitude;
+    uint8_t flags;       // DuckPayload::FLAG_*
+};
+
+inline Entry fromReading(const DuckPayload::Reading& r, uint32_t timestampMs) {
+    Entry e;
+    e.timestamp = timestampMs / 100;
+    e.counter = r.counter & 0xFFFFFF;
+    e.temp = DuckPayload::quantize(r.temp, 100, INT16_MIN, INT16_MAX);
+    e.humidity = DuckPayload::quantize(r.humidity, 100, 0, UINT16_MAX);
+    e.pressure = DuckPayload::quantize(r.pressure, 10, 0, 0xFFFFFF);
+    e.gas = DuckPayload::quantize(r.gas, 1, 0, 0xFFFFFF);
+    e.latitude = DuckPayload::quantize(r.hasGPS ? r.latitude : 0, 1e7, INT32_MIN, INT32_MAX);
+    e.longitude = DuckPayload::quantize(r.hasGPS ? r.longitude : 0, 1e7, INT32_MIN, INT32_MAX);
+    e.altitude = DuckPayload::quantize(r.hasGPS ? r.altitude + 500.0 : 0, 10, 0, UINT16_MAX);
+    e.flags = (r.prediction ? DuckPayload::FLAG_PREDICTION : 0) |
+              (r.hasGPS ? DuckPayload::FLAG_GPS_FIX : 0);
+    return e;
+}
+
+inline void toReading(const Entry& e, DuckPayload::Reading& r) {
+    r.counter = e.counter;
+    r.temp = (int16_t)e.temp / 100.0f;
+    r.humidity = e.humidity / 100.0f;
+    r.pressure = e.pressure / 10.0f;
+    r.gas = (float)e.gas;
+    r.prediction = (e.flags & DuckPayload::FLAG_PREDICTION) ? 1 : 0;
+    r.hasGPS = (e.flags & DuckPayload::FLAG_GPS_FIX) != 0;
+    r.latitude = e.latitude / 1e7;
+    r.longitude = e.longitude / 1e7;
+    r.altitude = r.hasGPS ? e.altitude / 10.0f - 500.0f : 0.0f;
+}
+
+class BitWriter {
+private:
+    uint8_t* buffer;
+    size_t capacityBits;
+    size_t position;
+
+public:
+    BitWriter(uint8_t* buffer, size_t capacityBytes)
+        : buffer(buffer), capacityBits(capacityBytes * 8), position(0) {}
+
+    // Returns false, writing nothing, if the bits do not fit
+    bool write(uint32_t value, uint8_t bits) {
+        if (position + bits > capacityBits) {
+            return false;
+        }
+        for (int8_t i = bits - 1; i >= 0; i--) {
+            uint8_t& byte = buffer[position >> 3];
+            uint8_t mask = 0x80 >> (position & 7);
+            if ((value >> i) & 1) byte |= mask;
+            else byte &= ~mask;
+            position++;
+        }
+        return true;
+    }
+
+    size_t bitPosition() const { return position; }
+    void rewind(size_t bitPosition) { position = bitPosition; }
+    size_t bytes() const { return (position + 7) >> 3; }
+};
+
+class BitReader {
+private:
+    const uint8_t* buffer;
+    size_t lengthBits;
+    size_t position;
+
+public:
+    BitReader(const uint8_t* buffer, size_t lengthBytes)
+        : buffer(buffer), lengthBits(lengthBytes * 8), position(0) {}
+
+    bool read(uint32_t& value, uint8_t bits) {
+        if (position + bits > lengthBits) {
+            return false;
+        }
+        value = 0;
+        for (uint8_t i = 0; i < bits; i++) {
+            value = (value << 1) | ((buffer[position >> 3] >> (7 - (position & 7))) & 1);
+            position++;
+        }
+        return true;
+    }
+};
+
+inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// Prefix buckets: 0 | 10+7 | 110+12 | 1110+20 | 1111+32 bits of zigzag value
+inline bool writeDelta(BitWriter& w, int32_t delta) {
+    uint32_t z = zigzag(delta);
+    if (z == 0) return w.write(0, 1);
+    if (z < (1u << 7)) return w.write(0x2, 2) && w.write(z, 7);
+    if (z < (1u << 12)) return w.write(0x6, 3) && w.write(z, 12);
+    if (z < (1u << 20)) return w.write(0xE, 4) && w.write(z, 20);
+    return w.write(0xF, 4) && w.write(z, 32);
+}
+
+inline bool readDelta(BitReader& r, int32_t& delta) {
+    static const uint8_t BUCKET_BITS[] = {0, 7, 12, 20, 32};
+    uint8_t ones = 0;
+    uint32_t bit;
+    while (ones < 4) {
+        if (!r.read(bit, 1)) return false;
+        if (!bit) break;
+        ones++;
+    }
+    uint32_t z = 0;
+    if (BUCKET_BITS[ones] && !r.read(z, BUCKET_BITS[ones])) return false;
+    delta = unzigzag(z);
+    return true;
+}
+
+class Encoder {
+private:
+    uint8_t buffer[MAX_PAYLOAD];
+    size_t limit;
+    BitWriter writer;
+    Entry previous;
+    int32_t previousInterval;
+    uint8_t readingCount;
+
+    bool writeFirst(const Entry& e) {
+        return writer.write(e.timestamp, 32) && writer.write(e.counter, 24) &&
+               writer.write((uint32_t)e.temp, 16) && writer.write((uint32_t)e.humidity, 16) &&
+               writer.write((uint32_t)e.pressure, 24) && writer.write((uint32_t)e.gas, 24) &&
+               writer.write((uint32_t)e.latitude, 32) && writer.write((uint32_t)e.longitude, 32) &&
+               writer.write((uint32_t)e.altitude, 16) && writer.write(e.flags, 2);
+    }
+
+    bool writeNext(const Entry& e, int32_t interval) {
+        return writeDelta(writer, interval - previousInterval) &&
+               writeDelta(writer, (int32_t)(e.counter - previous.counter) - 1) &&
+               writeDelta(writer, e.temp - previous.temp) &&
+               writeDelta(writer, e.humidity - previous.humidity) &&
+               writeDelta(writer, e.pressure - previous.pressure) &&
+               writeDelta(writer, e.gas - previous.gas) &&
+               writeDelta(writer, e.latitude - previous.latitude) &&
+               writeDelta(writer, e.longitude - previous.longitude) &&
+               writeDelta(writer, e.altitude - previous.altitude) &&
+               writer.write(e.flags, 2);
+    }
+
+public:
+    explicit Encoder(size_t payloadLimit = MAX_PAYLOAD)
+        : limit(payloadLimit < MAX_PAYLOAD ? payloadLimit : MAX_PAYLOAD),
+          writer(buffer + HEADER_SIZE, limit - HEADER_SIZE) {
+        reset();
+    }
+
+    void reset() {
+        writer = BitWriter(buffer + HEADER_SIZE, limit - HEADER_SIZE);
+        previousInterval = 0;
+        readingCount = 0;
+    }
+
+    // Returns false, leaving the batch unchanged, if the entry does not fit
+    bool append(const Entry& e) {
+        if (readingCount == MAX_READINGS) {
+            return false;
+        }
+        size_t mark = writer.bitPosition();
+        int32_t interval = readingCount ? (int32_t)(e.timestamp - previous.timestamp) : 0;
+        bool fits = readingCount ? writeNext(e, interval) : writeFirst(e);
+        if (!fits) {
+            writer.rewind(mark);
+            return false;
+        }
+        previousInterval = interval;
+        previous = e;
+        readingCount++;
+        return true;
+    }
+
+    uint8_t count() const { return readingCount; }
+    bool empty() const { return readingCount == 0; }
+    // Timestamp of the most recent reading, 0.1 s
+    uint32_t lastTimestamp() const { return readingCount ? previous.timestamp : 0; }
+
+    // Finalize the header; the returned pointer stays valid until reset()
+    const uint8_t* data() {
+        buffer[0] = MAGIC;
+        buffer[1] = VERSION;
+        buffer[2] = readingCount;
+        return buffer;
+    }
+
+    size_t size() const { return HEADER_SIZE + writer.bytes(); }
+};
+
+inline bool isBatch(const uint8_t* data, size_t length) {
+    return length > HEADER_SIZE && data[0] == MAGIC && data[1] == VERSION;
+}
+
+class Decoder {
+private:
+    BitReader reader;
+    uint8_t total;
+    uint8_t decoded;
+    Entry previous;
+    int32_t previousInterval;
+
+    bool readValue(int32_t& value, int32_t base) {
+        int32_t delta;
+        if (!readDelta(reader, delta)) return false;
+        value = base + delta;
+        return true;
+    }
+
+public:
+    Decoder(const uint8_t* data, size_t length)
+        : reader(data + HEADER_SIZE, length > HEADER_SIZE ? length - HEADER_SIZE : 0),
+          total(isBatch(data, length) ? data[2] : 0), decoded(0), previousInterval(0) {}
+
+    uint8_t count() const { return total; }
+
+    bool next(Entry& e) {
+        if (decoded >= total) {
+            return false;
+        }
+        uint32_t v;
+        if (decoded == 0) {
+            if (!reader.read(e.timestamp, 32) || !reader.read(e.counter, 24)) return false;
+            if (!reader.read(v, 16)) return false;
+            e.temp = (int16_t)v;
+            if (!reader.read(v, 16)) return false;
+            e.humidity = v;
+            if (!reader.read(v, 24)) return false;
+            e.pressure = v;
+            if (!reader.read(v, 24)) return false;
+            e.gas = v;
+            if (!reader.read(v, 32)) return false;
+            e.latitude = (int32_t)v;
+            if (!reader.read(v, 32)) return false;
+            e.longitude = (int32_t)v;
+            if (!reader.read(v, 16)) return false;
+            e.altitude = v;
+        } else {
+            int32_t dod, counterDelta;
+            if (!readDelta(reader, dod) || !readDelta(reader, counterDelta)) return false;
+            int32_t interval = previousInterval + dod;
+            e.timestamp = previous.timestamp + interval;
+            e.counter = previous.counter + counterDelta + 1;
+            if (!readValue(e.temp, previous.temp) || !readValue(e.humidity, previous.humidity) ||
+                !readValue(e.pressure, previous.pressure) || !readValue(e.gas, previous.gas) ||
+                !readValue(e.latitude, previous.latitude) || !readValue(e.longitude, previous.longitude) ||
+                !readValue(e.altitude, previous.altitude)) {
+                return false;
+            }
+            previousInterval = interval;
+        }
+        if (!reader.read(v, 2)) return false;
+        e.flags = v;
+        previous = e;
+        decoded++;
+        return true;
+    }
+};
+
+} // namespace DuckBatch
+
+#endif // DUCK_BATCH_H
@@ -0,0 +1,149 @@
+#ifndef DUCK_PAYLOAD_H
+#define DUCK_PAYLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Versioned fixed-point telemetry record shared by the MamaDuck encoder and
+// the PapaDuck decoder. Replaces the ~110 byte ASCII message
+// "Counter:.. Temp:.. Hum:.. Press:.. Gas:.. Pred:.. Lat:.. Lng:.. Alt:..".
+//
+// Layout (24 bytes, little endian):
+//   0  u8   version << 4 | flags (bit0 prediction, bit1 GPS fix)
+//   1  u24  counter
+//   4  i16  temperature, 0.01 degC
+//   6  u16  humidity, 0.01 %
+//   8  u24  pressure, 0.1 Pa
+//   11 u24  gas resistance, ohm
+//   14 i32  latitude, 1e-7 deg
+//   18 i32  longitude, 1e-7 deg
+//   22 u16  altitude + 500 m, 0.1 m
+//
+// The first byte is always below 0x20, so a binary record can never be
+// mistaken for the printable ASCII format it replaces.
+namespace DuckPayload {
+
+static const uint8_t VERSION = 1;
+static const size_t RECORD_SIZE = 24;
+static const size_t TEXT_SIZE = 160;  // enough for the legacy ASCII form
+
+static const uint8_t FLAG_PREDICTION = 0x01;
+static const uint8_t FLAG_GPS_FIX = 0x02;
+
+struct Reading {
+    uint32_t counter;
+    float temp;
+    float humidity;
+    float pressure;
+    float gas;
+    int prediction;
+    bool hasGPS;
+    double latitude;
+    double longitude;
+    float altitude;
+};
+
+inline int32_t quantize(double value, double scale, int32_t minValue, int32_t maxValue) {
+    double scaled = round(value * scale);
+    if (scaled < minValue) return minValue;
+    if (scaled > maxValue) return maxValue;
+    return (int32_t)scaled;
+}
+
+inline void putLE(uint8_t*& p, uint32_t value, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        *p++ = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+inline uint32_t getLE(const uint8_t*& p, uint8_t bytes) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bytes; i++) {
+        value |= (uint32_t)(*p++) << (8 * i);
+    }
+    return value;
+}
+
+// Writes RECORD_SIZE bytes; returns bytes written or 0 if the buffer is too small
+inline size_t encode(const Reading& r, uint8_t* buffer, size_t bufferSize) {
+    if (bufferSize < RECORD_SIZE) {
+        return 0;
+    }
+    uint8_t flags = (r.prediction ? FLAG_PREDICTION : 0) | (r.hasGPS ? FLAG_GPS_FIX : 0);
+    uint8_t* p = buffer;
+    *p++ = (VERSION << 4) | flags;
+    putLE(p, r.counter & 0xFFFFFF, 3);
+    putLE(p, (uint16_t)(int16_t)quantize(r.temp, 100, INT16_MIN, INT16_MAX), 2);
+    putLE(p, quantize(r.humidity, 100, 0, UINT16_MAX), 2);
+    putLE(p, quantize(r.pressure, 10, 0, 0xFFFFFF), 3);
+    putLE(p, quantize(r.gas, 1, 0, 0xFFFFFF), 3);
+    putLE(p, (uint32_t)quantize(r.hasGPS ? r.latitude : 0, 1e7, INT32_MIN, INT32_MAX), 4);
+    putLE(p, (uint32_t)quantize(r.hasGPS ? r.longitude : 0, 1e7, INT32_MIN, INT32_MAX), 4);
+    putLE(p, quantize(r.hasGPS ? r.altitude + 500.0 : 0, 10, 0, UINT16_MAX), 2);
+    return p - buffer;
+}
+
+inline bool isBinary(const uint8_t* data, size_t length) {
+    return length == RECORD_SIZE && (data[0] >> 4) == VERSION;
+}
+
+inline bool decode(const uint8_t* data, size_t length, Reading& r) {
+    if (!isBinary(data, length)) {
+        return false;
+    }
+    const uint8_t* p = data;
+    uint8_t flags = *p++ & 0x0F;
+    r.prediction = (flags & FLAG_PREDICTION) ? 1 : 0;
+    r.hasGPS = (flags & FLAG_GPS_FIX) != 0;
+    r.counter = getLE(p, 3);
+    r.temp = (int16_t)getLE(p, 2) / 100.0f;
+    r.humidity = getLE(p, 2) / 100.0f;
+    r.pressure = getLE(p, 3) / 10.0f;
+    r.gas = (float)getLE(p, 3);
+    r.latitude = (int32_t)getLE(p, 4) / 1e7;
+    r.longitude = (int32_t)getLE(p, 4) / 1e7;
+    r.altitude = r.hasGPS ? getLE(p, 2) / 10.0f - 500.0f : 0.0f;
+    return true;
+}
+
+// Formats a reading exactly like the legacy ASCII payload so downstream
+// consumers (dashboard regexes on Temp:, Pred:, Lat: ...) keep working
+inline int toText(const Reading& r, char* buffer, size_t bufferSize) {
+    int length = snprintf(buffer, bufferSize,
+                          "Counter:%lu Temp:%.2f Hum:%.3f Press:%.2f Gas:%.2f Pred:%d ",
+                          (unsigned long)r.counter, r.temp, r.humidity, r.pressure, r.gas,
+                          r.prediction);
+    if (length < 0 || (size_t)length >= bufferSize) {
+        return length;
+    }
+    int gpsLength = r.hasGPS
+        ? snprintf(buffer + length, bufferSize - length, "Lat:%.5f Lng:%.4f Alt:%.2f",
+                   r.latitude, r.longitude, r.altitude)
+        : snprintf(buffer + length, bufferSize - length, "NO_FIX");
+    return gpsLength < 0 ? gpsLength : length + gpsLength;
+}
+
+// Parses the legacy ASCII payload back into a reading; text must be NUL
+// terminated. Returns false if it is not MamaDuck telemetry.
+inline bool fromText(const char* text, Reading& r) {
+    unsigned long counter;
+    if (sscanf(text, "Counter:%lu Temp:%f Hum:%f Press:%f Gas:%f Pred:%d",
+               &counter, &r.temp, &r.humidity, &r.pressure, &r.gas, &r.prediction) != 6) {
+        return false;
+    }
+    r.counter = counter;
+    const char* gps = strstr(text, "Lat:");
+    r.hasGPS = gps && sscanf(gps, "Lat:%lf Lng:%lf Alt:%f", &r.latitude, &r.longitude, &r.altitude) == 3;
+    if (!r.hasGPS) {
+        r.latitude = r.longitude = 0;
+        r.altitude = 0;
+    }
+    return true;
+}
+
+} // namespace DuckPayload
+
+#endif // DUCK_PAYLOAD_H
@@ -0,0 +1,114 @@
+#ifndef DUCK_REPORT_POLICY_H
+#define DUCK_REPORT_POLICY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "DuckPayload.h"
+
+// Report-by-exception policy. A reading is sent when the prediction
+// changes, when any value leaves the deadband around the last *sent*
+// reading, or when nothing has been sent for a heartbeat interval;
+// everything else is suppressed and only counted.
+namespace DuckReport {
+
+enum class Reason : uint8_t {
+    SUPPRESSED = 0,
+    FIRST,         // nothing sent yet since boot
+    PREDICTION,    // prediction differs from the last sent reading
+    DEADBAND,      // a value moved outside its deadband
+    HEARTBEAT,     // heartbeat interval expired
+    COUNT
+};
+
+struct Thresholds {
+    float temp;            // degC
+    float humidity;        // %RH
+    float pressure;        // Pa
+    float gasFraction;     // relative change of gas resistance
+    double position;       // degrees of latitude or longitude
+    uint32_t heartbeatMs;
+};
+
+static const uint8_t HEALTH_TYPE_REPORT_POLICY = 0x03;
+// type, version, suppressed u32, sent per reason u32 x4
+static const size_t HEALTH_PACKET_SIZE = 2 + 4 + 4 * ((size_t)Reason::COUNT - 1);
+
+class Policy {
+private:
+    Thresholds thresholds;
+    DuckPayload::Reading lastSent;
+    uint32_t lastSentAt;
+    bool hasSent;
+    uint32_t counts[(size_t)Reason::COUNT];
+
+    static bool outside(float value, float reference, float band) {
+        return fabsf(value - reference) > band;
+    }
+
+    Reason classify(const DuckPayload::Reading& r, uint32_t nowMs) const {
+        if (!hasSent) return Reason::FIRST;
+        if (r.prediction != lastSent.prediction) return Reason::PREDICTION;
+        if (outside(r.temp, lastSent.temp, thresholds.temp) ||
+            outside(r.humidity, lastSent.humidity, thresholds.humidity) ||
+            outside(r.pressure, lastSent.pressure, thresholds.pressure) ||
+            outside(r.gas, lastSent.gas, fabsf(lastSent.gas) * thresholds.gasFraction) ||
+            r.hasGPS != lastSent.hasGPS ||
+            (r.hasGPS && (fabs(r.latitude - lastSent.latitude) > thresholds.position ||
+                          fabs(r.longitude - lastSent.longitude) > thresholds.position))) {
+            return Reason::DEADBAND;
+        }
+        if (nowMs - lastSentAt >= thresholds.heartbeatMs) return Reason::HEARTBEAT;
+        return Reason::SUPPRESSED;
+    }
+
+    static void putU32(uint8_t*& p, uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            *p++ = (v >> (8 * i)) & 0xFF;
+        }
+    }
+
+public:
+    explicit Policy(const Thresholds& thresholds)
+        : thresholds(thresholds), lastSentAt(0), hasSent(false), counts() {}
+
+    // Decide whether to send a reading; a send becomes the new reference
+    Reason evaluate(const DuckPayload::Reading& r, uint32_t nowMs) {
+        Reason reason = classify(r, nowMs);
+        counts[(size_t)reason]++;
+        if (reason != Reason::SUPPRESSED) {
+            lastSent = r;
+            lastSentAt = nowMs;
+            hasSent = true;
+        }
+        return reason;
+    }
+
+    uint32_t count(Reason reason) const { return counts[(size_t)reason]; }
+    uint32_t suppressed() const { return counts[(size_t)Reason::SUPPRESSED]; }
+
+    uint32_t sent() const {
+        uint32_t total = 0;
+        for (size_t i = 1; i < (size_t)Reason::COUNT; i++) total += counts[i];
+        return total;
+    }
+
+    // Serialize the counters for the CDP health topic; returns bytes written or 0
+    size_t encodeHealth(uint8_t* buffer, size_t bufferSize) const {
+        if (bufferSize < HEALTH_PACKET_SIZE) {
+            return 0;
+        }
+        uint8_t* p = buffer;
+        *p++ = HEALTH_TYPE_REPORT_POLICY;
+        *p++ = 1;  // format version
+        putU32(p, suppressed());
+        for (size_t i = 1; i < (size_t)Reason::COUNT; i++) {
+            putU32(p, counts[i]);
+        }
+        return p - buffer;
+    }
+};
+
+} // namespace DuckReport
+
+#endif // DUCK_REPORT_POLICY_H
@@ -0,0 +1,213 @@
+#ifndef DUCK_SCHEDULE_H
+#define DUCK_SCHEDULE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Transmit slots for MamaDucks sharing one LoRa channel.
+//
+// Time is cut into frames of one sensing interval and frames into slots.
+// A duck transmits in the same slot every frame, picked by hashing its
+// device ID. With a recent GPS fix frames are aligned to UTC and every
+// duck agrees on them; without one the duck uses its own clock and a
+// random seed instead of the ID, which still spreads ducks that booted
+// together. Two ducks that hash to the same slot would collide every
+// frame, so a duck re-draws its slot when packets go unacked, skipping
+// slots it recently heard other traffic in. The
+// sensing cycle is started early enough that the reading is ready when
+// the slot opens, and never less than half a frame after the last one.
+namespace DuckSchedule {
+
+static const uint32_t DAY_MS = 86400000;
+static const size_t MAX_SLOTS = 64;
+
+struct Timing {
+    uint32_t frameMs;         // sensing interval, must divide a day
+    uint32_t slotMs;          // longest expected frame airtime plus guard
+    uint32_t maxSyncAgeMs;    // GPS time older than this falls back to jitter
+    uint32_t senseMarginMs;   // started this much earlier than the slowest cycle
+    uint32_t busyFrames;      // a slot heard in is avoided for this many frames
+};
+
+struct Stats {
+    uint32_t syncs;           // GPS time updates
+    uint32_t cycles;          // sensing cycles scheduled
+    uint32_t syncedCycles;    // of which aligned to GPS time
+    uint32_t late;            // cycles that finished after their slot opened
+    uint32_t reselections;    // slots re-drawn after a lost packet
+};
+
+// FNV-1a over the device ID
+inline uint32_t hashId(const uint8_t* id, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ id[i]) * 16777619u;
+    }
+    return h;
+}
+
+// Murmur3 finalizer, spreads consecutive generations over all slots
+inline uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+class Scheduler {
+private:
+    Timing timing;
+    uint32_t slots;
+    uint32_t idHash;
+    uint32_t jitterSeed;
+    // Shared by the sensing and transmit tasks. A read that mixes two syncs
+    // is off by the clock drift between them only.
+    std::atomic<bool> hasSync;
+    std::atomic<uint32_t> syncUtc;      // ms since midnight at syncAt
+    std::atomic<uint32_t> syncAt;       // millis() of the GPS time
+    std::atomic<uint32_t> generation;   // bumped to re-draw the slot
+    std::atomic<uint32_t> heardIn[MAX_SLOTS];  // frame + 1 other traffic was last heard in
+    uint8_t misses;                     // packets lost in a row
+    uint32_t lead;                      // slowest recent sensing cycle
+    uint32_t lastBegin;                 // start of the last sensing cycle
+    uint32_t target;                    // slot the current cycle is for
+    Stats stats;
+
+    // Position in the schedule: ms since the start of the time base, which
+    // is midnight UTC when synced and boot otherwise
+    uint32_t position(uint32_t now, bool& synced) const {
+        synced = isSynced(now);
+        if (!synced) {
+            return now;
+        }
+        return syncUtc.load() + (now - syncAt.load());
+    }
+
+    uint32_t slotOf(uint32_t gen, bool synced) const {
+        return mix((synced ? idHash : jitterSeed) ^ gen) % slots;
+    }
+
+    uint32_t slotStart(uint32_t frame, bool synced) const {
+        return frame * timing.frameMs + slotOf(generation.load(), synced) * timing.slotMs;
+    }
+
+    // Moves to the next generation whose slot was not heard busy lately
+    void reselect(uint32_t now) {
+        bool synced;
+        uint32_t frame = position(now, synced) / timing.frameMs;
+        uint32_t gen = generation.load();
+        for (uint32_t tries = 0; tries < slots; tries++) {
+            uint32_t heard = heardIn[slotOf(++gen, synced)].load();
+            if (heard == 0 || frame + 1 - heard >= timing.busyFrames) break;
+        }
+        generation.store(gen);
+        stats.reselections++;
+    }
+
+    // ms from now until the first own slot opening at least notBefore ms
+    // from now
+    uint32_t untilSlot(uint32_t now, uint32_t notBefore) const {
+        bool synced;
+        uint32_t t = position(now, synced);
+        uint32_t frame = t / timing.frameMs;
+        for (uint32_t k = 0;; k++) {
+            uint32_t start = slotStart(frame + k, synced);
+            if (start >= t && start - t >= notBefore) {
+                return start - t;
+            }
+        }
+    }
+
+public:
+    explicit Scheduler(const Timing& timing)
+        : timing(timing),
+          slots(timing.frameMs / timing.slotMs < MAX_SLOTS ? timing.frameMs / timing.slotMs : MAX_SLOTS),
+          idHash(0), jitterSeed(0), hasSync(false), syncUtc(0), syncAt(0), generation(0), misses(0),
+          lead(0), lastBegin(0), target(0), stats() {
+        for (size_t i = 0; i < MAX_SLOTS; i++) heardIn[i].store(0);
+    }
+
+    void begin(const uint8_t* id, size_t length, uint32_t randomSeed) {
+        idHash = hashId(id, length);
+        jitterSeed = randomSeed;
+    }
+
+    // GPS UTC time of day in ms, and the millis() it was received at
+    void sync(uint32_t utcMs, uint32_t at) {
+        syncUtc.store(utcMs % DAY_MS);
+        syncAt.store(at);
+        hasSync.store(true);
+        stats.syncs++;
+    }
+
+    bool isSynced(uint32_t now) const {
+        return hasSync.load() && now - syncAt.load() < timing.maxSyncAgeMs;
+    }
+
+    // Transmit task: whether the last packet was acked. Another duck in the
+    // same slot loses every packet while mesh loss is sporadic, so the slot
+    // is re-drawn after a second loss in a row.
+    void outcome(bool delivered, uint32_t now) {
+        if (delivered) {
+            misses = 0;
+        } else if (++misses >= 2) {
+            misses = 0;
+            reselect(now);
+        }
+    }
+
+    // Radio task: a packet from another duck was received at now
+    void heard(uint32_t now) {
+        bool synced;
+        uint32_t t = position(now, synced);
+        heardIn[(t % timing.frameMs) / timing.slotMs % slots].store(t / timing.frameMs + 1);
+    }
+
+    // Sensing task: ms to sleep before the next cycle so it completes just
+    // before an own slot opens. Cycles start half a frame apart at least,
+    // which keeps the velocity features meaningful across slot changes.
+    uint32_t senseDelay(uint32_t now) {
+        uint32_t early = lead + timing.senseMarginMs;
+        uint32_t elapsed = now - lastBegin;
+        uint32_t spacing = elapsed < timing.frameMs / 2 ? timing.frameMs / 2 - elapsed : 0;
+        uint32_t wait = untilSlot(now, early + spacing);
+        target = now + wait;
+        stats.cycles++;
+        if (isSynced(now)) stats.syncedCycles++;
+        return wait - early;
+    }
+
+    // Sensing task: the cycle started at begin and its reading was handed
+    // over at now. The lead follows slower cycles at once and faster ones
+    // slowly, so one quick GPS read does not make the next cycle late.
+    void sensed(uint32_t begin, uint32_t now) {
+        uint32_t cycle = now - begin;
+        lastBegin = begin;
+        lead = cycle > lead ? cycle : lead - (lead - cycle) / 64;
+        if (stats.cycles && (int32_t)(now - target) > 0) stats.late++;
+    }
+
+    // Transmit task: whether an own slot is open
+    bool inSlot(uint32_t now) const {
+        bool synced;
+        uint32_t t = position(now, synced);
+        uint32_t frame = t / timing.frameMs;
+        return t - slotStart(frame, synced) < timing.slotMs;
+    }
+
+    // Transmit task: ms until an own slot is open, 0 if one is
+    uint32_t timeUntilSlot(uint32_t now) const {
+        return inSlot(now) ? 0 : untilSlot(now, 0);
+    }
+
+    uint32_t slotCount() const { return slots; }
+    uint32_t senseLead() const { return lead; }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace DuckSchedule
+
+#endif // DUCK_SCHEDULE_H
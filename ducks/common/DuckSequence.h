@@ -0,0 +1,392 @@
+#ifndef DUCK_SEQUENCE_H
+#define DUCK_SEQUENCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// End-to-end delivery for MamaDuck telemetry over the CDP mesh.
+//
+// Every telemetry payload (record or batch) is prefixed with a 16-bit
+// sequence number. The PapaDuck tracks the numbers it has received per
+// device and answers each packet with an ack addressed to that device:
+//
+//   data  u8 DATA_MAGIC, u16 sequence, payload
+//   ack   u8 ACK_MAGIC, u16 next, u32 received
+//
+// next is the lowest number not yet received; bit i of received is set
+// when next + 1 + i has arrived. The MamaDuck keeps each packet in a small
+// window until it is acked and resends only the ones the gateway reports
+// missing (numbers below the newest it has, after a holdoff) or that are
+// not acked before a timeout, up to a transmission limit. A resend the
+// gateway already has is reported as a duplicate and only acked again.
+//
+// Both magic bytes are below 0x20 and differ from the DuckPayload version
+// byte and the DuckBatch magic, so neither can be confused with a bare
+// payload. Sequence numbers compare in serial arithmetic and start at a
+// random value on boot, so a restarted node is not mistaken for a
+// retransmission.
+namespace DuckSequence {
+
+static const uint8_t DATA_MAGIC = 0x0C;
+static const uint8_t ACK_MAGIC = 0x0D;
+static const size_t HEADER_SIZE = 3;
+static const size_t ACK_SIZE = 7;
+static const uint8_t ACK_BITS = 32;
+// Jumps further back than a window, or further ahead than this, are a
+// sender restart rather than loss
+static const uint16_t RESYNC_DISTANCE = 1024;
+
+static const uint8_t HEALTH_TYPE_DELIVERY = 0x04;
+// type, version, u32 x6 SenderStats
+static const size_t HEALTH_PACKET_SIZE = 2 + 4 * 6;
+
+inline int16_t distance(uint16_t from, uint16_t to) { return (int16_t)(uint16_t)(to - from); }
+
+// Writes header and payload; returns bytes written or 0 if they do not fit
+inline size_t wrap(uint16_t sequence, const uint8_t* payload, size_t length, uint8_t* out, size_t capacity) {
+    if (capacity < HEADER_SIZE + length) {
+        return 0;
+    }
+    out[0] = DATA_MAGIC;
+    out[1] = sequence & 0xFF;
+    out[2] = sequence >> 8;
+    memcpy(out + HEADER_SIZE, payload, length);
+    return HEADER_SIZE + length;
+}
+
+// Strips the header in place; false, leaving data untouched, for a payload
+// without one
+inline bool unwrap(const uint8_t*& data, size_t& length, uint16_t& sequence) {
+    if (length <= HEADER_SIZE || data[0] != DATA_MAGIC) {
+        return false;
+    }
+    sequence = data[1] | (uint16_t)data[2] << 8;
+    data += HEADER_SIZE;
+    length -= HEADER_SIZE;
+    return true;
+}
+
+struct Ack {
+    uint16_t next;
+    uint32_t received;
+};
+
+inline size_t encodeAck(const Ack& ack, uint8_t* out, size_t capacity) {
+    if (capacity < ACK_SIZE) {
+        return 0;
+    }
+    out[0] = ACK_MAGIC;
+    out[1] = ack.next & 0xFF;
+    out[2] = ack.next >> 8;
+    for (int i = 0; i < 4; i++) {
+        out[3 + i] = (ack.received >> (8 * i)) & 0xFF;
+    }
+    return ACK_SIZE;
+}
+
+inline bool decodeAck(const uint8_t* data, size_t length, Ack& ack) {
+    if (length != ACK_SIZE || data[0] != ACK_MAGIC) {
+        return false;
+    }
+    ack.next = data[1] | (uint16_t)data[2] << 8;
+    ack.received = 0;
+    for (int i = 0; i < 4; i++) {
+        ack.received |= (uint32_t)data[3 + i] << (8 * i);
+    }
+    return true;
+}
+
+inline bool acked(const Ack& ack, uint16_t sequence) {
+    int16_t d = distance(ack.next, sequence);
+    if (d < 0) return d > -(int16_t)RESYNC_DISTANCE;
+    return d > 0 && d <= ACK_BITS && (ack.received >> (d - 1)) & 1;
+}
+
+// Newest sequence number the ack reports as received
+inline uint16_t newest(const Ack& ack) {
+    uint16_t newest = ack.next - 1;
+    for (uint8_t i = 0; i < ACK_BITS; i++) {
+        if ((ack.received >> i) & 1) newest = ack.next + 1 + i;
+    }
+    return newest;
+}
+
+struct ReceiverStats {
+    uint32_t received;     // new packets
+    uint32_t duplicates;   // resends of packets already received
+    uint32_t lost;         // numbers skipped for good
+    uint32_t resyncs;      // sender restarts
+};
+
+// Gateway-side state for one sender
+class Receiver {
+private:
+    uint16_t nextExpected;
+    uint32_t bitmap;
+    bool started;
+
+    // nextExpected has been received or given up: move past it and
+    // everything contiguous after it
+    void settle() {
+        nextExpected++;
+        while (bitmap & 1) {
+            bitmap >>= 1;
+            nextExpected++;
+        }
+        bitmap >>= 1;
+    }
+
+public:
+    Receiver() : nextExpected(0), bitmap(0), started(false) {}
+
+    void reset() { started = false; }
+
+    // Whether an arrival would be a resend of one already received,
+    // without recording it
+    bool received(uint16_t sequence) const {
+        int16_t d = distance(nextExpected, sequence);
+        if (!started || d <= -(int16_t)RESYNC_DISTANCE || d >= (int16_t)RESYNC_DISTANCE) {
+            return false;
+        }
+        return d < 0 || (d > 0 && d <= ACK_BITS && (bitmap >> (d - 1)) & 1);
+    }
+
+    // Records an arrival; false if it was already received
+    bool receive(uint16_t sequence, ReceiverStats& stats) {
+        int16_t d = distance(nextExpected, sequence);
+        if (!started || d <= -(int16_t)RESYNC_DISTANCE || d >= (int16_t)RESYNC_DISTANCE) {
+            if (started) stats.resyncs++;
+            started = true;
+            nextExpected = sequence;
+            bitmap = 0;
+            d = 0;
+        }
+        if (received(sequence)) {
+            stats.duplicates++;
+            return false;
+        }
+        // Slide the window until the number fits, giving up on the gaps it passes
+        while (d > ACK_BITS) {
+            stats.lost++;
+            settle();
+            d = distance(nextExpected, sequence);
+        }
+        stats.received++;
+        if (d > 0) {
+            bitmap |= 1u << (d - 1);
+        } else {
+            settle();
+        }
+        return true;
+    }
+
+    Ack ack() const {
+        Ack a = {nextExpected, bitmap};
+        return a;
+    }
+};
+
+struct Timing {
+    uint32_t ackTimeoutMs;     // resend when nothing acked it by then
+    uint32_t holdoffMs;        // minimum age before a reported gap is resent
+    uint8_t maxTransmissions;  // including the first
+};
+
+struct SenderStats {
+    uint32_t packets;          // packets queued
+    uint32_t transmissions;    // first transmissions
+    uint32_t retransmissions;
+    uint32_t acked;
+    uint32_t expired;          // given up after maxTransmissions, or evicted
+    uint32_t acks;             // acks received
+    uint32_t unacked;          // gaps and ack timeouts found, not in the health packet
+};
+
+// MamaDuck-side retention window of N packets of up to SIZE payload bytes.
+// All calls must come from the same task.
+template <size_t N, size_t SIZE>
+class Window {
+    static_assert(N <= ACK_BITS, "Window must fit in one ack bitmap");
+
+public:
+    enum class State : uint8_t { FREE, QUEUED, SENDING, WAITING };
+
+    struct Slot {
+        State state;
+        bool urgent;
+        uint8_t topic;
+        uint8_t transmissions;
+        uint16_t sequence;
+        uint16_t length;
+        uint32_t sentAt;
+        uint8_t data[HEADER_SIZE + SIZE];
+    };
+
+private:
+    Timing timing;
+    Slot slots[N];
+    uint16_t nextSequence;
+    SenderStats stats;
+
+    Slot* freeSlot(bool urgent) {
+        Slot* victim = NULL;
+        for (size_t i = 0; i < N; i++) {
+            Slot& s = slots[i];
+            if (s.state == State::FREE) return &s;
+            if (urgent && !s.urgent && s.state != State::SENDING &&
+                (!victim || distance(s.sequence, victim->sequence) > 0)) {
+                victim = &s;
+            }
+        }
+        // An urgent packet displaces the oldest routine one
+        if (victim) stats.expired++;
+        return victim;
+    }
+
+    void expireOrQueue(Slot& s) {
+        stats.unacked++;
+        if (s.transmissions >= timing.maxTransmissions) {
+            s.state = State::FREE;
+            stats.expired++;
+        } else {
+            s.state = State::QUEUED;
+        }
+    }
+
+    static void putU32(uint8_t*& p, uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            *p++ = (v >> (8 * i)) & 0xFF;
+        }
+    }
+
+public:
+    explicit Window(const Timing& timing) : timing(timing), nextSequence(0), stats() {
+        for (size_t i = 0; i < N; i++) slots[i].state = State::FREE;
+    }
+
+    void begin(uint16_t firstSequence) { nextSequence = firstSequence; }
+
+    // Assigns the next sequence number and queues the packet for sending;
+    // NULL when every slot is in use (an urgent packet only fails if all
+    // slots hold urgent packets or are being sent)
+    Slot* add(uint8_t topic, const uint8_t* payload, size_t length, bool urgent) {
+        if (length > SIZE) return NULL;
+        Slot* s = freeSlot(urgent);
+        if (!s) return NULL;
+        s->sequence = nextSequence++;
+        s->length = (uint16_t)wrap(s->sequence, payload, length, s->data, sizeof(s->data));
+        s->topic = topic;
+        s->urgent = urgent;
+        s->transmissions = 0;
+        s->state = State::QUEUED;
+        stats.packets++;
+        return s;
+    }
+
+    bool hasRoom() const {
+        for (size_t i = 0; i < N; i++) {
+            if (slots[i].state == State::FREE) return true;
+        }
+        return false;
+    }
+
+    // The queued packet to send next, urgent first, then oldest first
+    Slot* due() {
+        Slot* best = NULL;
+        for (size_t i = 0; i < N; i++) {
+            Slot& s = slots[i];
+            if (s.state != State::QUEUED) continue;
+            if (!best || (s.urgent && !best->urgent) ||
+                (s.urgent == best->urgent && distance(s.sequence, best->sequence) > 0)) {
+                best = &s;
+            }
+        }
+        return best;
+    }
+
+    // The transmitter took the slot; it stays put until sent() is called
+    void sending(Slot* s) { s->state = State::SENDING; }
+    void requeue(Slot* s) { s->state = State::QUEUED; }
+
+    // End of one transmission attempt. A local failure counts as a
+    // transmission and waits for the ack timeout like a lost packet.
+    void sent(Slot* s, uint32_t now) {
+        if (s->transmissions++) stats.retransmissions++;
+        else stats.transmissions++;
+        s->sentAt = now;
+        s->state = State::WAITING;
+    }
+
+    // Frees what the ack covers and queues the gaps below the newest
+    // packet the gateway has
+    void onAck(const Ack& ack, uint32_t now) {
+        stats.acks++;
+        uint16_t newestReceived = newest(ack);
+        for (size_t i = 0; i < N; i++) {
+            Slot& s = slots[i];
+            if (s.state != State::WAITING && s.state != State::QUEUED) continue;
+            if (acked(ack, s.sequence)) {
+                s.state = State::FREE;
+                stats.acked++;
+            } else if (s.state == State::WAITING && distance(s.sequence, newestReceived) > 0 &&
+                       now - s.sentAt >= timing.holdoffMs) {
+                expireOrQueue(s);
+            }
+        }
+    }
+
+    // Resends packets whose ack timed out
+    void poll(uint32_t now) {
+        for (size_t i = 0; i < N; i++) {
+            Slot& s = slots[i];
+            if (s.state == State::WAITING && now - s.sentAt >= timing.ackTimeoutMs) {
+                expireOrQueue(s);
+            }
+        }
+    }
+
+    // Milliseconds until poll() has an ack timeout to handle, or UINT32_MAX
+    // if nothing is waiting for one
+    uint32_t timeUntilDue(uint32_t now) const {
+        uint32_t next = UINT32_MAX;
+        for (size_t i = 0; i < N; i++) {
+            const Slot& s = slots[i];
+            if (s.state != State::WAITING) continue;
+            uint32_t age = now - s.sentAt;
+            uint32_t wait = age >= timing.ackTimeoutMs ? 0 : timing.ackTimeoutMs - age;
+            if (wait < next) next = wait;
+        }
+        return next;
+    }
+
+    size_t inUse() const {
+        size_t n = 0;
+        for (size_t i = 0; i < N; i++) n += slots[i].state != State::FREE;
+        return n;
+    }
+
+    static size_t capacity() { return N; }
+    const SenderStats& counters() const { return stats; }
+
+    // Serialize the counters for the CDP health topic; returns bytes written or 0
+    size_t encodeHealth(uint8_t* buffer, size_t bufferSize) const {
+        if (bufferSize < HEALTH_PACKET_SIZE) {
+            return 0;
+        }
+        uint8_t* p = buffer;
+        *p++ = HEALTH_TYPE_DELIVERY;
+        *p++ = 1;  // format version
+        putU32(p, stats.packets);
+        putU32(p, stats.transmissions);
+        putU32(p, stats.retransmissions);
+        putU32(p, stats.acked);
+        putU32(p, stats.expired);
+        putU32(p, stats.acks);
+        return p - buffer;
+    }
+};
+
+} // namespace DuckSequence
+
+#endif // DUCK_SEQUENCE_H
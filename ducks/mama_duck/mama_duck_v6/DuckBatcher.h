@@ -0,0 +1,85 @@
+#ifndef DUCK_BATCHER_H
+#define DUCK_BATCHER_H
+
+#include <Arduino.h>
+#include "DuckConfig.h"
+#include "DuckBatch.h"
+#include "DuckSequence.h"
+
+// Accumulates routine readings into a DuckBatch until it holds MAX_READINGS,
+// is MAX_AGE old or the next reading would not fit in one CDP payload after
+// the sequence header. A sealed batch is copied to the in-flight buffer so
+// readings keep accumulating until it has been handed on.
+class DuckBatcher {
+private:
+    static DuckBatch::Encoder open;
+    static uint32_t openedAt;
+    static uint8_t inFlight[DuckBatch::MAX_PAYLOAD];
+    static size_t inFlightLength;
+    static uint8_t inFlightCount;
+    static bool inFlightBusy;
+
+public:
+    // Returns false when the open batch is full; seal() it and add again
+    static bool add(const DuckPayload::Reading& reading, uint32_t nowMs) {
+        if (open.count() >= DuckConfig::BatchConfig::MAX_READINGS) {
+            return false;
+        }
+        if (!open.append(DuckBatch::fromReading(reading, nowMs))) {
+            return false;
+        }
+        if (open.count() == 1) {
+            openedAt = nowMs;
+        }
+        return true;
+    }
+
+    static bool flushDue(uint32_t nowMs) {
+        return !open.empty() &&
+               (open.count() >= DuckConfig::BatchConfig::MAX_READINGS ||
+                nowMs - openedAt >= DuckConfig::BatchConfig::MAX_AGE);
+    }
+
+    // Milliseconds until the open batch ages out, or UINT32_MAX if it is empty
+    static uint32_t timeUntilDue(uint32_t nowMs) {
+        if (open.empty()) {
+            return UINT32_MAX;
+        }
+        uint32_t age = nowMs - openedAt;
+        return age >= DuckConfig::BatchConfig::MAX_AGE ? 0 : DuckConfig::BatchConfig::MAX_AGE - age;
+    }
+
+    // Move the open batch to the in-flight buffer; false if there is nothing
+    // to send or the previous batch is still being retried
+    static bool seal() {
+        if (open.empty() || inFlightBusy) {
+            return false;
+        }
+        inFlightLength = open.size();
+        inFlightCount = open.count();
+        memcpy(inFlight, open.data(), inFlightLength);
+        open.reset();
+        inFlightBusy = true;
+        return true;
+    }
+
+    static const uint8_t* data() { return inFlight; }
+    static size_t length() { return inFlightLength; }
+    static uint8_t count() { return inFlightCount; }
+    static uint8_t pending() { return open.count(); }
+
+    // Free the in-flight buffer once the batch is sent or abandoned
+    static void complete() {
+        inFlightBusy = false;
+    }
+};
+
+// Initialize static members
+DuckBatch::Encoder DuckBatcher::open(DuckBatch::MAX_PAYLOAD - DuckSequence::HEADER_SIZE);
+uint32_t DuckBatcher::openedAt = 0;
+uint8_t DuckBatcher::inFlight[DuckBatch::MAX_PAYLOAD];
+size_t DuckBatcher::inFlightLength = 0;
+uint8_t DuckBatcher::inFlightCount = 0;
+bool DuckBatcher::inFlightBusy = false;
+
+#endif // DUCK_BATCHER_H
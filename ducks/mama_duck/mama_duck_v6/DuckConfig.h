@@ -13,9 +13,8 @@ namespace DuckConfig {
         static const uint32_t TRANSMISSION_RETRY_DELAY = 1000; // 1 second
         
         // Buffer sizes
-        static const size_t GPS_BUFFER_SIZE = 100;
-        static const size_t MESSAGE_BUFFER_SIZE = 256;
         static const size_t HISTORY_WINDOW_SIZE = 5;
+        static const size_t RECORD_POOL_SIZE = 8;             // must be a power of two
         
         // Task configuration
         static const uint32_t ML_STACK_SIZE = 32 * 1024;      // 32KB stack
@@ -29,6 +28,81 @@ namespace DuckConfig {
         
         // Retry configuration
         static const uint8_t MAX_RETRY_COUNT = 3;
+        static const uint32_t MAX_RETRY_BACKOFF = 30000;      // 30 seconds
+        static const size_t MAX_PENDING_RETRIES = 4;          // concurrent async retries
+        static const size_t MAX_RETRY_OPERATIONS = 8;         // distinct operation names tracked
+        static const uint8_t ALERT_MAX_RETRY_COUNT = 6;
+        static const uint32_t ALERT_MAX_RETRY_BACKOFF = 4000; // 4 seconds
+        static const size_t ALERT_RESERVED_RETRIES = 1;       // slots routine retries cannot use
+    };
+
+    // Power management configuration
+    struct PowerConfig {
+        static const uint32_t RADIO_POLL_INTERVAL = 20;       // ms between duck.run() calls
+#ifdef DUCK_RADIO_IRQ_PIN
+        static const int RADIO_IRQ_PIN = DUCK_RADIO_IRQ_PIN;  // LoRa interrupt GPIO, set per board env
+#else
+        static const int RADIO_IRQ_PIN = -1;                  // none: light sleep cannot wake on packets
+#endif
+        static const bool LIGHT_SLEEP_ENABLED = true;         // needs tickless idle in the framework
+        static const int MAX_CPU_FREQ_MHZ = 240;
+        static const int MIN_CPU_FREQ_MHZ = 80;
+        static const uint32_t WAKE_REPORT_INTERVAL = 60000;   // 1 minute, DUCK_WAKE_STATS builds only
+    };
+
+    // Deferred logger configuration
+    struct LogConfig {
+        static const size_t RING_SIZE = 64;                   // records, must be a power of two
+        static const size_t LINE_BUFFER_SIZE = 128;
+        static const uint32_t DRAIN_STACK_SIZE = 4 * 1024;    // 4KB stack
+    };
+
+    // Health telemetry configuration
+    struct HealthConfig {
+        static const uint32_t LATENCY_REPORT_INTERVAL = 600000;  // 10 minutes
+        static const uint32_t RUNTIME_REPORT_INTERVAL = 900000;  // 15 minutes
+        static const size_t MAX_SYSTEM_TASKS = 32;                 // uxTaskGetSystemState buffer
+        static const size_t MAX_PROFILED_TASKS = 16;               // tasks included in a report
+    };
+
+    // Static memory configuration
+    struct MemoryConfig {
+        static const size_t STATIC_RAM_BUDGET = 72 * 1024;    // checked at build time
+    };
+
+    // Time-series batching of routine readings
+    struct BatchConfig {
+        static const bool ENABLED = true;
+        static const uint8_t MAX_READINGS = 12;               // flush after this many readings
+        static const uint32_t MAX_AGE = 120000;               // or 2 minutes after the first one
+    };
+
+    // End-to-end acks from the PapaDuck; unacked packets are resent
+    struct AckConfig {
+        static const size_t WINDOW = 8;                       // packets kept until acked
+        static const uint32_t ACK_TIMEOUT = 20000;            // 20 seconds, several mesh hops each way
+        static const uint32_t RESEND_HOLDOFF = 5000;          // age before a reported gap is resent
+        static const uint8_t MAX_TRANSMISSIONS = 4;           // including the first
+        static const size_t ACK_QUEUE = 4;                    // acks from the radio task
+    };
+
+    // Transmit slots: one per sensing interval, GPS-aligned when there is a fix
+    struct ScheduleConfig {
+        static const uint32_t SLOT_LENGTH = 300;              // a 12 reading batch at SF7/125 kHz plus guard
+        static const uint32_t MAX_SYNC_AGE = 60000;           // 1 minute of clock drift without a fix
+        static const uint32_t SENSE_MARGIN = 200;             // ms between reading and slot
+        static const uint32_t BUSY_FRAMES = 30;               // 5 minutes; slots heard in are avoided
+    };
+
+    // Report-by-exception deadbands, relative to the last reading sent
+    struct ReportConfig {
+        static const bool ENABLED = true;
+        static constexpr float TEMP_DEADBAND = 1.0f;          // degC
+        static constexpr float HUMIDITY_DEADBAND = 5.0f;      // %RH
+        static constexpr float PRESSURE_DEADBAND = 100.0f;    // Pa
+        static constexpr float GAS_DEADBAND = 0.10f;          // fraction of the last gas reading
+        static constexpr double POSITION_DEADBAND = 0.0005;   // degrees, about 50 m
+        static const uint32_t HEARTBEAT_INTERVAL = 600000;    // 10 minutes
     };
 
     // Sensor bounds for validation
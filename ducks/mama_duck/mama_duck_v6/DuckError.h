@@ -2,8 +2,8 @@
 #define DUCK_ERROR_H
 
 #include <Arduino.h>
-#include <functional>
 #include "DuckConfig.h"
+#include "DuckLog.h"
 
 enum class DuckStatus {
     OK,
@@ -18,18 +18,160 @@ enum class DuckStatus {
     WARNING_GPS_NO_FIX
 };
 
+// Asynchronous retry callbacks. An attempt returns true on success; the
+// completion callback runs once, after success or the last failed attempt.
+typedef bool (*RetryAttempt)(void* context);
+typedef void (*RetryComplete)(void* context, bool success);
+
+// Alert retries run before routine ones, have their own attempt budget and
+// backoff cap, and may take a slot from a routine retry when none is free
+enum class RetryPriority : uint8_t {
+    ROUTINE,
+    ALERT
+};
+
+struct RetryStats {
+    const char* operation;
+    uint32_t successes;
+    uint32_t failedAttempts;
+    uint32_t abandoned;
+};
+
 class DuckErrorHandler {
 private:
+    struct PendingRetry {
+        const char* operation;
+        RetryAttempt attempt;
+        RetryComplete complete;
+        void* context;
+        uint32_t nextAttemptAt;
+        uint8_t attempts;
+        uint8_t maxAttempts;
+        RetryPriority priority;
+        bool active;
+    };
+
     static DuckStatus currentStatus;
     static char lastErrorMessage[50];
+    static PendingRetry pendingRetries[DuckConfig::SystemConfig::MAX_PENDING_RETRIES];
+    static RetryStats retryStats[DuckConfig::SystemConfig::MAX_RETRY_OPERATIONS];
 
-public:
-    static void setError(DuckStatus status, const char* message = nullptr) {
+    static RetryStats* statsFor(const char* operation) {
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_RETRY_OPERATIONS; i++) {
+            RetryStats& stats = retryStats[i];
+            if (stats.operation == operation || (stats.operation && strcmp(stats.operation, operation) == 0)) {
+                return &stats;
+            }
+            if (!stats.operation) {
+                stats.operation = operation;
+                return &stats;
+            }
+        }
+        return nullptr;
+    }
+
+    // Exponential backoff with equal jitter: half the delay is fixed, half random
+    static uint32_t backoffDelay(uint8_t attempts, uint32_t maxBackoff) {
+        uint32_t delayMs = DuckConfig::SystemConfig::TRANSMISSION_RETRY_DELAY;
+        for (uint8_t i = 1; i < attempts && delayMs < maxBackoff; i++) {
+            delayMs *= 2;
+        }
+        if (delayMs > maxBackoff) {
+            delayMs = maxBackoff;
+        }
+        return delayMs / 2 + esp_random() % (delayMs / 2 + 1);
+    }
+
+    static void recordError(DuckStatus status, const char* message) {
         currentStatus = status;
         if (message) {
             strncpy(lastErrorMessage, message, sizeof(lastErrorMessage) - 1);
             lastErrorMessage[sizeof(lastErrorMessage) - 1] = '\0';
         }
+    }
+
+    // Run one attempt; returns true when the operation is finished. Runs on
+    // the TX task, so it logs through DuckLog with the operation's index in
+    // retryStats rather than its name.
+    static bool runAttempt(PendingRetry& retry) {
+        RetryStats* stats = statsFor(retry.operation);
+        unsigned operation = stats ? (unsigned)(stats - retryStats) : DuckConfig::SystemConfig::MAX_RETRY_OPERATIONS;
+        retry.attempts++;
+        if (retry.attempt(retry.context)) {
+            if (stats) stats->successes++;
+            if (retry.attempts > 1) {
+                DUCK_LOGI(LogId::RETRY_SUCCEEDED, operation, retry.attempts - 1);
+            }
+            if (retry.complete) retry.complete(retry.context, true);
+            return true;
+        }
+
+        if (stats) stats->failedAttempts++;
+        if (retry.attempts >= retry.maxAttempts) {
+            if (stats) stats->abandoned++;
+            recordError(DuckStatus::ERROR_TRANSMISSION, retry.operation);
+            DUCK_LOGE(LogId::RETRY_ABANDONED, operation, retry.attempts);
+            if (retry.complete) retry.complete(retry.context, false);
+            return true;
+        }
+
+        uint32_t delayMs = backoffDelay(retry.attempts, retry.priority == RetryPriority::ALERT
+                                                        ? DuckConfig::SystemConfig::ALERT_MAX_RETRY_BACKOFF
+                                                        : DuckConfig::SystemConfig::MAX_RETRY_BACKOFF);
+        retry.nextAttemptAt = millis() + delayMs;
+        DUCK_LOGW(LogId::RETRY_FAILED, operation, retry.attempts, retry.maxAttempts, delayMs);
+        return false;
+    }
+
+    // A free slot for the given priority. Routine retries leave
+    // ALERT_RESERVED_RETRIES slots free; an alert with no free slot evicts
+    // the routine retry that has failed most often, which is abandoned.
+    static PendingRetry* slotFor(RetryPriority priority) {
+        PendingRetry* freeSlot = nullptr;
+        PendingRetry* victim = nullptr;
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_PENDING_RETRIES; i++) {
+            PendingRetry& retry = pendingRetries[i];
+            if (!retry.active) {
+                if (!freeSlot) freeSlot = &retry;
+            } else if (retry.priority == RetryPriority::ROUTINE &&
+                       (!victim || retry.attempts > victim->attempts)) {
+                victim = &retry;
+            }
+        }
+        if (priority == RetryPriority::ROUTINE) {
+            return routineSlotAvailable() ? freeSlot : nullptr;
+        }
+        if (freeSlot || !victim) {
+            return freeSlot;
+        }
+        RetryStats* stats = statsFor(victim->operation);
+        if (stats) stats->abandoned++;
+        victim->active = false;
+        if (victim->complete) victim->complete(victim->context, false);
+        return victim;
+    }
+
+    static size_t activeRoutine() {
+        size_t count = 0;
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_PENDING_RETRIES; i++) {
+            if (pendingRetries[i].active && pendingRetries[i].priority == RetryPriority::ROUTINE) count++;
+        }
+        return count;
+    }
+
+    static void runDue(RetryPriority priority, uint32_t now) {
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_PENDING_RETRIES; i++) {
+            PendingRetry& retry = pendingRetries[i];
+            if (retry.active && retry.priority == priority &&
+                (int32_t)(now - retry.nextAttemptAt) >= 0) {
+                retry.active = !runAttempt(retry);
+            }
+        }
+    }
+
+public:
+    static void setError(DuckStatus status, const char* message = nullptr) {
+        recordError(status, message);
         // Log error
         Serial.printf("[MAMA] Error: %s\n", message ? message : "Unknown error");
     }
@@ -42,8 +184,9 @@ public:
         return currentStatus;
     }
 
-    // Modified retry function to accept std::function
-    static bool retry(const char* operation, std::function<bool()> func, uint8_t maxRetries = DuckConfig::SystemConfig::MAX_RETRY_COUNT) {
+    // Blocking retry for setup-time use; func is any callable returning bool
+    template <typename Func>
+    static bool retry(const char* operation, Func func, uint8_t maxRetries = DuckConfig::SystemConfig::MAX_RETRY_COUNT) {
         uint8_t attempts = 0;
         while (attempts < maxRetries) {
             if (func()) {
@@ -62,6 +205,80 @@ public:
         return false;
     }
 
+    // Non-blocking retry. The first attempt runs immediately; failures are
+    // rescheduled with exponential backoff and jitter and run from
+    // processRetries(). All async retry calls must come from the same task.
+    // Returns false, without attempting, if no retry slot is available.
+    static bool retryAsync(const char* operation, RetryAttempt attempt, void* context,
+                           RetryComplete complete = nullptr,
+                           uint8_t maxAttempts = DuckConfig::SystemConfig::MAX_RETRY_COUNT,
+                           RetryPriority priority = RetryPriority::ROUTINE) {
+        PendingRetry* retry = slotFor(priority);
+        if (!retry) {
+            return false;
+        }
+        retry->operation = operation;
+        retry->attempt = attempt;
+        retry->complete = complete;
+        retry->context = context;
+        retry->attempts = 0;
+        retry->maxAttempts = maxAttempts;
+        retry->priority = priority;
+        retry->active = !runAttempt(*retry);
+        return true;
+    }
+
+    // Whether retryAsync() would accept a routine retry right now
+    static bool routineSlotAvailable() {
+        return activeRoutine() < DuckConfig::SystemConfig::MAX_PENDING_RETRIES -
+                                 DuckConfig::SystemConfig::ALERT_RESERVED_RETRIES;
+    }
+
+    // Run every retry whose backoff has expired, alerts first
+    static void processRetries() {
+        uint32_t now = millis();
+        runDue(RetryPriority::ALERT, now);
+        runDue(RetryPriority::ROUTINE, now);
+    }
+
+    // Milliseconds until the next scheduled retry, or UINT32_MAX if none
+    static uint32_t nextRetryDelay() {
+        uint32_t now = millis();
+        uint32_t next = UINT32_MAX;
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_PENDING_RETRIES; i++) {
+            const PendingRetry& retry = pendingRetries[i];
+            if (!retry.active) {
+                continue;
+            }
+            int32_t remaining = (int32_t)(retry.nextAttemptAt - now);
+            uint32_t wait = remaining > 0 ? (uint32_t)remaining : 0;
+            if (wait < next) {
+                next = wait;
+            }
+        }
+        return next;
+    }
+
+    static size_t pendingRetryCount() {
+        size_t count = 0;
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_PENDING_RETRIES; i++) {
+            if (pendingRetries[i].active) count++;
+        }
+        return count;
+    }
+
+    static void printRetryStats() {
+        for (size_t i = 0; i < DuckConfig::SystemConfig::MAX_RETRY_OPERATIONS; i++) {
+            const RetryStats& stats = retryStats[i];
+            if (!stats.operation) {
+                break;
+            }
+            Serial.printf("[MAMA] Retry %u %s: %lu ok, %lu failed attempts, %lu abandoned\n",
+                          (unsigned)i, stats.operation, (unsigned long)stats.successes,
+                          (unsigned long)stats.failedAttempts, (unsigned long)stats.abandoned);
+        }
+    }
+
     static void checkStackHealth(TaskHandle_t task, const char* taskName, size_t minStackWatermark) {
         UBaseType_t watermark = uxTaskGetStackHighWaterMark(task);
         if (watermark < minStackWatermark) {
@@ -74,5 +291,7 @@ public:
 // Initialize static members
 DuckStatus DuckErrorHandler::currentStatus = DuckStatus::OK;
 char DuckErrorHandler::lastErrorMessage[50] = {0};
+DuckErrorHandler::PendingRetry DuckErrorHandler::pendingRetries[DuckConfig::SystemConfig::MAX_PENDING_RETRIES] = {};
+RetryStats DuckErrorHandler::retryStats[DuckConfig::SystemConfig::MAX_RETRY_OPERATIONS] = {};
 
 #endif // DUCK_ERROR_H
\ No newline at end of file
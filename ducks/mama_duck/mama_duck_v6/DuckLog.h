@@ -0,0 +1,323 @@
+#ifndef DUCK_LOG_H
+#define DUCK_LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "DuckConfig.h"
+
+// Log levels; records above DUCK_LOG_LEVEL are removed at compile time,
+// including the evaluation of their arguments.
+#define DUCK_LOG_LEVEL_NONE  0
+#define DUCK_LOG_LEVEL_ERROR 1
+#define DUCK_LOG_LEVEL_WARN  2
+#define DUCK_LOG_LEVEL_INFO  3
+#define DUCK_LOG_LEVEL_DEBUG 4
+
+#ifndef DUCK_LOG_LEVEL
+#define DUCK_LOG_LEVEL DUCK_LOG_LEVEL_DEBUG
+#endif
+
+#define DUCK_LOG(level, id, ...) \
+    do { if ((level) <= DUCK_LOG_LEVEL) DuckLog::write(id, ##__VA_ARGS__); } while (0)
+
+#define DUCK_LOGE(id, ...) DUCK_LOG(DUCK_LOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#define DUCK_LOGW(id, ...) DUCK_LOG(DUCK_LOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#define DUCK_LOGI(id, ...) DUCK_LOG(DUCK_LOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#define DUCK_LOGD(id, ...) DUCK_LOG(DUCK_LOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+
+// Format IDs. Only numeric conversions (d, i, u, x, c, f, e, g) are
+// supported since arguments are stored as 32-bit words.
+enum class LogId : uint16_t {
+    REPORT_BEGIN,
+    REPORT_ENV,
+    TEMPERATURE,
+    HUMIDITY,
+    PRESSURE,
+    GAS,
+    REPORT_FEATURES,
+    SCALED_TEMP,
+    SCALED_HUMIDITY,
+    SCALED_PRESSURE,
+    SCALED_GAS,
+    TEMP_VOLATILITY,
+    HUMIDITY_VOLATILITY,
+    PRESSURE_VOLATILITY,
+    TEMP_VELOCITY,
+    HUMIDITY_VELOCITY,
+    PRESSURE_VELOCITY,
+    GAS_VELOCITY,
+    REPORT_GPS,
+    GPS_LATITUDE,
+    GPS_LONGITUDE,
+    GPS_ALTITUDE,
+    GPS_SATELLITES,
+    GPS_TIME,
+    GPS_SPEED,
+    REPORT_PREDICTION,
+    PREDICTION,
+    REPORT_END,
+    POOL_STATS,
+    TX_OK,
+    TX_FAILED,
+    BATCH_QUEUED,
+    BATCH_FAILED,
+    REPORT_SUPPRESSED,
+    REPORT_STATS,
+    ROUTINE_DROPPED,
+    DELIVERY_STATS,
+    SCHEDULE_STATS,
+    RETRY_SUCCEEDED,
+    RETRY_FAILED,
+    RETRY_ABANDONED,
+    HEALTH_SEND_FAILED,
+    COUNT
+};
+
+static const char* const LOG_FORMATS[] = {
+    "\n[MAMA] ======== SENSOR DATA REPORT ========",
+    "[MAMA] ----- Environmental Readings -----",
+    "[MAMA] Temperature: %.2f°C",
+    "[MAMA] Humidity: %.3f%%",
+    "[MAMA] Pressure: %.2f hPa",
+    "[MAMA] Gas: %.2f",
+    "[MAMA] ----- ML Feature Processing -----",
+    "[MAMA] Scaled Temp: %.4f",
+    "[MAMA] Scaled Humidity: %.4f",
+    "[MAMA] Scaled Pressure: %.4f",
+    "[MAMA] Scaled Gas: %.4f",
+    "[MAMA] Temp Volatility: %.4f",
+    "[MAMA] Humidity Volatility: %.4f",
+    "[MAMA] Pressure Volatility: %.4f",
+    "[MAMA] Temp Velocity: %.4f",
+    "[MAMA] Humidity Velocity: %.4f",
+    "[MAMA] Pressure Velocity: %.4f",
+    "[MAMA] Gas Velocity: %.4f",
+    "[MAMA] --------- GPS ---------",
+    "[MAMA] Latitude  : %.5f",
+    "[MAMA] Longitude : %.4f",
+    "[MAMA] Altitude  : %.2fM",
+    "[MAMA] Satellites: %u",
+    "[MAMA] Time      : %u:%u:%u",
+    "[MAMA] Speed     : %.2f",
+    "[MAMA] ----- ML Prediction -----",
+    "[MAMA] Prediction: %d",
+    "[MAMA] ===================================\n",
+    "[MAMA] Record pool: %u/%u in use, %u pending, high water %u, %u dropped",
+    "[MAMA] Packet transmission successful",
+    "[MAMA] Packet transmission failed",
+    "[MAMA] Batch of %u readings queued in %u bytes",
+    "[MAMA] Batch of %u readings failed",
+    "[MAMA] Reading suppressed (%u since boot)",
+    "[MAMA] Report policy: %u suppressed, sent %u first, %u prediction, %u deadband, %u heartbeat",
+    "[MAMA] Routine reading dropped under backpressure (%u total)",
+    "[MAMA] Delivery: %u packets, %u resent, %u acked, %u expired, %u awaiting ack",
+    "[MAMA] TX slots: %u of %u cycles GPS aligned, %u late, %u slot changes, lead %u ms",
+    "[MAMA] Retry %u succeeded after %u retries",
+    "[MAMA] Retry %u failed, attempt %u/%u, next in %u ms",
+    "[MAMA] Retry %u abandoned after %u attempts",
+    "[MAMA] Health report type %u transmission failed",
+};
+
+static_assert(sizeof(LOG_FORMATS) / sizeof(LOG_FORMATS[0]) == (size_t)LogId::COUNT,
+              "LOG_FORMATS must have one entry per LogId");
+
+// Deferred binary logger. Producers store a format ID plus raw 32-bit
+// arguments into a bounded lock-free ring (multi-producer, single consumer);
+// a low-priority task formats and prints them off the hot path. When the ring
+// is full new records are dropped and counted rather than blocking.
+class DuckLog {
+public:
+    static const size_t MAX_ARGS = 5;
+    static const size_t RING_SIZE = DuckConfig::LogConfig::RING_SIZE;
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "Log ring size must be a power of two");
+
+private:
+    struct Record {
+        std::atomic<uint32_t> sequence;
+        uint16_t id;
+        uint8_t argCount;
+        uint32_t args[MAX_ARGS];
+    };
+
+    static Record ring[RING_SIZE];
+    static std::atomic<uint32_t> enqueuePos;
+    static std::atomic<uint32_t> dequeuePos;    // only advanced by the drain task
+    static std::atomic<uint32_t> dropped;
+    static TaskHandle_t drainTask;
+    static StaticTask_t drainTaskBuffer;
+    static StackType_t drainStack[DuckConfig::LogConfig::DRAIN_STACK_SIZE];
+
+    static uint32_t toWord(float value) {
+        uint32_t word;
+        memcpy(&word, &value, sizeof(word));
+        return word;
+    }
+    static uint32_t toWord(double value) { return toWord(static_cast<float>(value)); }
+    template <typename T>
+    static uint32_t toWord(T value) { return static_cast<uint32_t>(value); }
+
+    static void push(LogId id, const uint32_t* args, uint8_t argCount) {
+        uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Record* record;
+        while (true) {
+            record = &ring[pos & (RING_SIZE - 1)];
+            uint32_t seq = record->sequence.load(std::memory_order_acquire);
+            int32_t diff = (int32_t)seq - (int32_t)pos;
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        record->id = static_cast<uint16_t>(id);
+        record->argCount = argCount;
+        memcpy(record->args, args, argCount * sizeof(uint32_t));
+        record->sequence.store(pos + 1, std::memory_order_release);
+
+        // Wake the drain task early if the ring is filling up
+        if (drainTask && (pos - dequeuePos.load(std::memory_order_relaxed)) == RING_SIZE / 2) {
+            xTaskNotifyGive(drainTask);
+        }
+    }
+
+    static bool pop(Record& out) {
+        uint32_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Record* record = &ring[pos & (RING_SIZE - 1)];
+        uint32_t seq = record->sequence.load(std::memory_order_acquire);
+        if ((int32_t)seq - (int32_t)(pos + 1) < 0) {
+            return false;
+        }
+        out.id = record->id;
+        out.argCount = record->argCount;
+        memcpy(out.args, record->args, sizeof(out.args));
+        record->sequence.store(pos + RING_SIZE, std::memory_order_release);
+        dequeuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Expand one record into text, formatting each conversion from its raw word
+    static void format(const Record& record, char* out, size_t outSize) {
+        const char* fmt = LOG_FORMATS[record.id];
+        size_t len = 0;
+        uint8_t arg = 0;
+
+        while (*fmt && len < outSize - 1) {
+            if (*fmt != '%') {
+                out[len++] = *fmt++;
+                continue;
+            }
+            if (fmt[1] == '%') {
+                out[len++] = '%';
+                fmt += 2;
+                continue;
+            }
+
+            char spec[16];
+            size_t specLen = 0;
+            while (*fmt && specLen < sizeof(spec) - 1) {
+                char c = *fmt++;
+                spec[specLen++] = c;
+                if (strchr("diuxXcfFeEgG", c)) break;
+            }
+            spec[specLen] = '\0';
+            char conversion = spec[specLen - 1];
+            uint32_t word = arg < record.argCount ? record.args[arg] : 0;
+            arg++;
+
+            int written;
+            if (strchr("fFeEgG", conversion)) {
+                float value;
+                memcpy(&value, &word, sizeof(value));
+                written = snprintf(out + len, outSize - len, spec, (double)value);
+            } else if (conversion == 'd' || conversion == 'i' || conversion == 'c') {
+                written = snprintf(out + len, outSize - len, spec, (int)word);
+            } else {
+                written = snprintf(out + len, outSize - len, spec, (unsigned int)word);
+            }
+            if (written > 0) {
+                len += (size_t)written < outSize - 1 - len ? (size_t)written : outSize - 1 - len;
+            }
+        }
+        out[len] = '\0';
+    }
+
+    static void drainLoop(void* parameter) {
+        (void)parameter;
+        static char line[DuckConfig::LogConfig::LINE_BUFFER_SIZE];
+        Record record;
+        uint32_t reportedDrops = 0;
+
+        while (true) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            while (pop(record)) {
+                format(record, line, sizeof(line));
+                Serial.println(line);
+            }
+            uint32_t drops = dropped.load(std::memory_order_relaxed);
+            if (drops != reportedDrops) {
+                Serial.printf("[MAMA] Log ring full, %lu records dropped\n", (unsigned long)drops);
+                reportedDrops = drops;
+            }
+        }
+    }
+
+public:
+    static const size_t RING_BYTES = sizeof(Record) * RING_SIZE;
+
+    static bool begin() {
+        for (size_t i = 0; i < RING_SIZE; i++) {
+            ring[i].sequence.store(i, std::memory_order_relaxed);
+        }
+#if DUCK_LOG_LEVEL > DUCK_LOG_LEVEL_NONE
+        drainTask = xTaskCreateStaticPinnedToCore(
+            drainLoop,
+            "Log_Drain",
+            DuckConfig::LogConfig::DRAIN_STACK_SIZE,
+            NULL,
+            tskIDLE_PRIORITY + 1,
+            drainStack,
+            &drainTaskBuffer,
+            1
+        );
+        return drainTask != NULL;
+#else
+        return true;
+#endif
+    }
+
+    template <typename... Args>
+    static void write(LogId id, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        uint32_t words[MAX_ARGS > 0 ? MAX_ARGS : 1] = {toWord(args)...};
+        push(id, words, sizeof...(Args));
+    }
+
+    // Ask the drain task to print what has been logged so far
+    static void flush() {
+        if (drainTask) {
+            xTaskNotifyGive(drainTask);
+        }
+    }
+
+    static uint32_t getDropped() {
+        return dropped.load(std::memory_order_relaxed);
+    }
+};
+
+// Initialize static members
+DuckLog::Record DuckLog::ring[DuckLog::RING_SIZE];
+std::atomic<uint32_t> DuckLog::enqueuePos{0};
+std::atomic<uint32_t> DuckLog::dequeuePos{0};
+std::atomic<uint32_t> DuckLog::dropped{0};
+TaskHandle_t DuckLog::drainTask = NULL;
+StaticTask_t DuckLog::drainTaskBuffer;
+StackType_t DuckLog::drainStack[DuckConfig::LogConfig::DRAIN_STACK_SIZE];
+
+#endif // DUCK_LOG_H
@@ -0,0 +1,96 @@
+#ifndef DUCK_MEMORY_H
+#define DUCK_MEMORY_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "DuckConfig.h"
+
+// A statically allocated memory region listed in the boot-time budget report
+struct MemoryRegion {
+    const char* name;
+    size_t size;
+};
+
+template <size_t N>
+constexpr size_t totalRegionSize(const MemoryRegion (&regions)[N], size_t i = 0) {
+    return i < N ? regions[i].size + totalRegionSize(regions, i + 1) : 0;
+}
+
+// Static memory budget report and steady-state heap allocation counter.
+// The counter is only active in DUCK_HEAP_AUDIT builds, which link with
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (see the heap_audit env).
+class DuckMemory {
+private:
+    static std::atomic<uint32_t> allocations;
+    static uint32_t steadyStateBaseline;
+
+public:
+    static void countAllocation() {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static bool isAuditEnabled() {
+#ifdef DUCK_HEAP_AUDIT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Call once setup has finished; later allocations count as steady state
+    static void markSteadyState() {
+        steadyStateBaseline = allocations.load(std::memory_order_relaxed);
+    }
+
+    static uint32_t steadyStateAllocations() {
+        return allocations.load(std::memory_order_relaxed) - steadyStateBaseline;
+    }
+
+    template <size_t N>
+    static void printBudget(const MemoryRegion (&regions)[N]) {
+        Serial.println("[MAMA] ----- Static memory budget -----");
+        for (size_t i = 0; i < N; i++) {
+            Serial.printf("[MAMA] %-24s %6u bytes\n", regions[i].name, (unsigned)regions[i].size);
+        }
+        Serial.printf("[MAMA] %-24s %6u / %u bytes\n", "total",
+                      (unsigned)totalRegionSize(regions),
+                      (unsigned)DuckConfig::MemoryConfig::STATIC_RAM_BUDGET);
+        Serial.printf("[MAMA] Heap free after setup: %u bytes\n", (unsigned)ESP.getFreeHeap());
+    }
+
+    static void printAllocations() {
+        if (isAuditEnabled()) {
+            Serial.printf("[MAMA] Heap allocations since setup: %lu\n",
+                          (unsigned long)steadyStateAllocations());
+        }
+    }
+};
+
+// Initialize static members
+std::atomic<uint32_t> DuckMemory::allocations{0};
+uint32_t DuckMemory::steadyStateBaseline = 0;
+
+#ifdef DUCK_HEAP_AUDIT
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    DuckMemory::countAllocation();
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    DuckMemory::countAllocation();
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    DuckMemory::countAllocation();
+    return __real_realloc(ptr, size);
+}
+}
+#endif
+
+#endif // DUCK_MEMORY_H
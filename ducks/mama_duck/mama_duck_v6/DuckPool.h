@@ -0,0 +1,142 @@
+#ifndef DUCK_POOL_H
+#define DUCK_POOL_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "DuckConfig.h"
+#include "DuckSensor.h"
+
+// Lock-free single-producer/single-consumer ring of pool slot indices.
+// Only one task may call push() and only one task may call pop().
+template <size_t N>
+class IndexRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "IndexRing size must be a power of two");
+
+private:
+    uint8_t slots[N];
+    std::atomic<uint32_t> head{0};  // advanced by the producer
+    std::atomic<uint32_t> tail{0};  // advanced by the consumer
+
+public:
+    bool push(uint8_t index) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        slots[h & (N - 1)] = index;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(uint8_t& index) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        index = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+};
+
+// Transmission lanes; the TX task always drains ALERT before ROUTINE
+enum class Lane : uint8_t {
+    ALERT,
+    ROUTINE
+};
+
+// Statically allocated pool of SensorData records shared by the ML and TX tasks.
+// The ML task acquires a free record, fills it in place and publishes its index;
+// the TX task receives the index, transmits straight from the record and releases it.
+// No record is ever copied between tasks. Ready records wait in one of two lanes.
+class SensorRecordPool {
+public:
+    static const size_t POOL_SIZE = DuckConfig::SystemConfig::RECORD_POOL_SIZE;
+
+private:
+    SensorData records[POOL_SIZE];
+    IndexRing<POOL_SIZE> freeRing;   // TX -> ML
+    IndexRing<POOL_SIZE> alertRing;  // ML -> TX, fire predictions
+    IndexRing<POOL_SIZE> readyRing;  // ML -> TX, routine readings
+
+    std::atomic<uint8_t> inUse{0};
+    SensorData* spare = nullptr;     // only touched by the ML task
+    uint8_t highWater = 0;           // only written by the ML task
+    uint32_t acquireFailures = 0;    // only written by the ML task
+
+    uint8_t indexOf(const SensorData* record) const {
+        return static_cast<uint8_t>(record - records);
+    }
+
+public:
+    void begin() {
+        for (size_t i = 0; i < POOL_SIZE; i++) {
+            freeRing.push(static_cast<uint8_t>(i));
+        }
+    }
+
+    // ML task: take a free record, or nullptr if every record is still queued for TX
+    SensorData* acquire() {
+        SensorData* record = spare;
+        if (record) {
+            spare = nullptr;
+        } else {
+            uint8_t index;
+            if (!freeRing.pop(index)) {
+                acquireFailures++;
+                return nullptr;
+            }
+            uint8_t used = inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (used > highWater) {
+                highWater = used;
+            }
+            record = &records[index];
+        }
+        record->reset();
+        return record;
+    }
+
+    // ML task: give back a record that will not be published. Only the TX
+    // task pushes to freeRing, so the record stays with the ML task and is
+    // handed out again by the next acquire().
+    void discard(SensorData* record) {
+        spare = record;
+    }
+
+    // ML task: hand a filled record over to the TX task
+    void publish(SensorData* record, Lane lane = Lane::ROUTINE) {
+        (lane == Lane::ALERT ? alertRing : readyRing).push(indexOf(record));
+    }
+
+    // TX task: next record in a lane, or nullptr if that lane is empty
+    SensorData* receive(Lane lane = Lane::ROUTINE) {
+        uint8_t index;
+        if (!(lane == Lane::ALERT ? alertRing : readyRing).pop(index)) {
+            return nullptr;
+        }
+        return &records[index];
+    }
+
+    // TX task: return a transmitted record to the pool
+    void release(SensorData* record) {
+        freeRing.push(indexOf(record));
+        inUse.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    size_t occupancy() const { return inUse.load(std::memory_order_relaxed); }
+    size_t pending() const { return alertRing.size() + readyRing.size(); }
+    size_t getHighWater() const { return highWater; }
+    uint32_t getAcquireFailures() const { return acquireFailures; }
+
+    void printStats() const {
+        Serial.printf("[MAMA] Record pool: %u/%u in use, %u pending, high water %u, %lu dropped\n",
+                      (unsigned)occupancy(), (unsigned)POOL_SIZE, (unsigned)pending(),
+                      (unsigned)getHighWater(), (unsigned long)getAcquireFailures());
+    }
+};
+
+#endif // DUCK_POOL_H
@@ -0,0 +1,129 @@
+#ifndef DUCK_POWER_H
+#define DUCK_POWER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_idf_version.h>
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#include "DuckConfig.h"
+
+// Wake-up sources counted in DUCK_WAKE_STATS builds
+enum class WakeSource : uint8_t {
+    ML_TASK,
+    TX_TASK,
+    RADIO_POLL,
+    COUNT
+};
+
+class DuckPower {
+private:
+#if CONFIG_PM_ENABLE
+    static esp_pm_lock_handle_t noSleepLock;
+#endif
+    static bool lightSleepEnabled;
+    static std::atomic<uint32_t> wakeCounts[(size_t)WakeSource::COUNT];
+    static uint32_t lastReportTime;
+
+public:
+    // Enable dynamic frequency scaling and automatic light sleep when the
+    // framework was built with power management and tickless idle support.
+    // The radio IRQ pin is kept as a GPIO wake-up source so LoRa reception
+    // (and mesh relaying) still wakes the CPU.
+    static bool begin() {
+#if CONFIG_PM_ENABLE
+        if (esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "duck_awake", &noSleepLock) != ESP_OK) {
+            return false;
+        }
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+        esp_pm_config_t pmConfig = {};
+#elif CONFIG_IDF_TARGET_ESP32S3
+        esp_pm_config_esp32s3_t pmConfig = {};
+#else
+        esp_pm_config_esp32_t pmConfig = {};
+#endif
+        pmConfig.max_freq_mhz = DuckConfig::PowerConfig::MAX_CPU_FREQ_MHZ;
+        pmConfig.min_freq_mhz = DuckConfig::PowerConfig::MIN_CPU_FREQ_MHZ;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+        pmConfig.light_sleep_enable = DuckConfig::PowerConfig::LIGHT_SLEEP_ENABLED;
+#endif
+        if (esp_pm_configure(&pmConfig) != ESP_OK) {
+            Serial.println("[MAMA] Power management configuration failed");
+            return false;
+        }
+
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#ifndef DUCK_RADIO_IRQ_PIN
+#error "Light sleep wakes on the LoRa interrupt: set -DDUCK_RADIO_IRQ_PIN in the board's platformio.ini env"
+#endif
+        if (DuckConfig::PowerConfig::LIGHT_SLEEP_ENABLED) {
+            gpio_wakeup_enable((gpio_num_t)DuckConfig::PowerConfig::RADIO_IRQ_PIN, GPIO_INTR_HIGH_LEVEL);
+            esp_sleep_enable_gpio_wakeup();
+            lightSleepEnabled = true;
+        }
+#endif
+        Serial.printf("[MAMA] Power management enabled, light sleep %s\n",
+                      lightSleepEnabled ? "on" : "off");
+        return true;
+#else
+        Serial.println("[MAMA] Power management not available in this framework build");
+        return false;
+#endif
+    }
+
+    static bool isLightSleepEnabled() {
+        return lightSleepEnabled;
+    }
+
+    // Keep the CPU out of light sleep while peripherals that do not survive it
+    // (GPS UART, LoRa TX over SPI) are in use. Calls must be balanced.
+    static void stayAwake() {
+#if CONFIG_PM_ENABLE
+        if (noSleepLock) esp_pm_lock_acquire(noSleepLock);
+#endif
+    }
+
+    static void allowSleep() {
+#if CONFIG_PM_ENABLE
+        if (noSleepLock) esp_pm_lock_release(noSleepLock);
+#endif
+    }
+
+    static void countWake(WakeSource source) {
+#ifdef DUCK_WAKE_STATS
+        wakeCounts[(size_t)source].fetch_add(1, std::memory_order_relaxed);
+#endif
+    }
+
+    // Print wake-ups per minute for each source and reset the counters
+    static void reportWakeStats() {
+#ifdef DUCK_WAKE_STATS
+        uint32_t now = millis();
+        uint32_t elapsed = now - lastReportTime;
+        if (elapsed < DuckConfig::PowerConfig::WAKE_REPORT_INTERVAL) {
+            return;
+        }
+        lastReportTime = now;
+
+        uint32_t ml = wakeCounts[(size_t)WakeSource::ML_TASK].exchange(0);
+        uint32_t tx = wakeCounts[(size_t)WakeSource::TX_TASK].exchange(0);
+        uint32_t radio = wakeCounts[(size_t)WakeSource::RADIO_POLL].exchange(0);
+        float minutes = elapsed / 60000.0f;
+        Serial.printf("[MAMA] Wake-ups/min: ML %.1f, TX %.1f, radio poll %.1f, total %.1f (light sleep %s)\n",
+                      ml / minutes, tx / minutes, radio / minutes,
+                      (ml + tx + radio) / minutes, lightSleepEnabled ? "on" : "off");
+#endif
+    }
+};
+
+// Initialize static members
+#if CONFIG_PM_ENABLE
+esp_pm_lock_handle_t DuckPower::noSleepLock = nullptr;
+#endif
+bool DuckPower::lightSleepEnabled = false;
+std::atomic<uint32_t> DuckPower::wakeCounts[(size_t)WakeSource::COUNT] = {};
+uint32_t DuckPower::lastReportTime = 0;
+
+#endif // DUCK_POWER_H
@@ -0,0 +1,218 @@
+#ifndef DUCK_PROBE_H
+#define DUCK_PROBE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_timer.h>
+#define PROBE_PRINTF(fmt, ...) Serial.printf("[MAMA] " fmt, ##__VA_ARGS__)
+#else
+#include <chrono>
+#define PROBE_PRINTF(fmt, ...) printf(fmt, ##__VA_ARGS__)
+#endif
+
+// Pipeline stages timed by the latency probes
+enum class ProbeStage : uint8_t {
+    SENSOR_READ,
+    PROCESS,
+    GPS,
+    PREDICT,
+    QUEUE,
+    SEND,
+    CYCLE,
+    ALERT_QUEUE,   // fire prediction published -> first transmission attempt
+    COUNT
+};
+
+static const char* const PROBE_STAGE_NAMES[] = {
+    "sensor", "process", "gps", "predict", "queue", "send", "cycle", "alert"
+};
+
+// Fixed-bucket latency histogram in microseconds. Buckets are log-linear:
+// SUB_BUCKETS linear steps per power of two, from 1 us up to 2^OCTAVES us
+// (~33 s), so percentiles are accurate to within 25%.
+class LatencyHistogram {
+public:
+    static const uint8_t SUB_BUCKETS = 4;
+    static const uint8_t OCTAVES = 24;
+    static const uint16_t BUCKETS = SUB_BUCKETS * OCTAVES;
+
+private:
+    uint32_t counts[BUCKETS];
+    uint32_t total;
+    uint32_t maxValue;
+
+    static uint16_t bucketFor(uint32_t us) {
+        if (us < SUB_BUCKETS) {
+            return us;
+        }
+        uint8_t octave = 31 - __builtin_clz(us);               // floor(log2(us)), >= 2
+        uint8_t sub = (us >> (octave - 2)) & (SUB_BUCKETS - 1);  // next two bits
+        uint16_t bucket = (octave - 1) * SUB_BUCKETS + sub;
+        return bucket < BUCKETS ? bucket : BUCKETS - 1;
+    }
+
+    // Largest value that falls into a bucket
+    static uint32_t bucketUpperBound(uint16_t bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        uint8_t octave = bucket / SUB_BUCKETS + 1;
+        uint8_t sub = bucket % SUB_BUCKETS;
+        uint64_t lower = (uint64_t)(SUB_BUCKETS + sub) << (octave - 2);
+        uint64_t upper = lower + ((uint64_t)1 << (octave - 2)) - 1;
+        return upper > UINT32_MAX ? UINT32_MAX : (uint32_t)upper;
+    }
+
+public:
+    LatencyHistogram() { reset(); }
+
+    void reset() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        maxValue = 0;
+    }
+
+    void record(uint32_t us) {
+        counts[bucketFor(us)]++;
+        total++;
+        if (us > maxValue) {
+            maxValue = us;
+        }
+    }
+
+    // Upper bound of the bucket holding the given percentile (0-100)
+    uint32_t percentile(uint8_t pct) const {
+        if (total == 0) {
+            return 0;
+        }
+        uint32_t rank = ((uint64_t)total * pct + 99) / 100;
+        uint32_t seen = 0;
+        for (uint16_t i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank && seen > 0) {
+                uint32_t bound = bucketUpperBound(i);
+                return bound < maxValue ? bound : maxValue;
+            }
+        }
+        return maxValue;
+    }
+
+    uint32_t count() const { return total; }
+    uint32_t max() const { return maxValue; }
+};
+
+// Per-stage latency probes. Each stage has a single writer task, so
+// recording is a plain increment; readers tolerate a slightly stale view.
+class DuckProbe {
+public:
+    // Health packet payload types (first byte on the CDP health topic)
+    static const uint8_t HEALTH_TYPE_LATENCY = 0x01;
+    static const size_t STAGE_COUNT = (size_t)ProbeStage::COUNT;
+    // type, version, stage count, then per stage: count u16, p50/p95/max u32 (little endian)
+    static const size_t HEALTH_PACKET_SIZE = 3 + STAGE_COUNT * 14;
+
+private:
+    static LatencyHistogram histograms[STAGE_COUNT];
+    static uint32_t lastReportTime;
+
+    static void putU16(uint8_t*& p, uint16_t v) {
+        *p++ = v & 0xFF;
+        *p++ = v >> 8;
+    }
+
+    static void putU32(uint8_t*& p, uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            *p++ = (v >> (8 * i)) & 0xFF;
+        }
+    }
+
+public:
+    static uint32_t now() {
+#ifdef ARDUINO
+        return (uint32_t)esp_timer_get_time();
+#else
+        return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    static void record(ProbeStage stage, uint32_t us) {
+        histograms[(size_t)stage].record(us);
+    }
+
+    static const LatencyHistogram& histogram(ProbeStage stage) {
+        return histograms[(size_t)stage];
+    }
+
+    // Starts a new reporting interval. Called from the TX task while the
+    // other stages keep recording, so a sample taken during the reset may
+    // be lost; that is within the histogram's accuracy.
+    static void reset() {
+        for (size_t i = 0; i < STAGE_COUNT; i++) {
+            histograms[i].reset();
+        }
+    }
+
+    // True once per reporting interval; intervalMs is in the caller's clock
+    static bool reportDue(uint32_t nowMs, uint32_t intervalMs) {
+        if (nowMs - lastReportTime < intervalMs) {
+            return false;
+        }
+        lastReportTime = nowMs;
+        return true;
+    }
+
+    static void print() {
+        for (size_t i = 0; i < STAGE_COUNT; i++) {
+            const LatencyHistogram& h = histograms[i];
+            PROBE_PRINTF("Latency %-8s n=%lu p50=%luus p95=%luus max=%luus\n",
+                         PROBE_STAGE_NAMES[i], (unsigned long)h.count(),
+                         (unsigned long)h.percentile(50), (unsigned long)h.percentile(95),
+                         (unsigned long)h.max());
+        }
+    }
+
+    // Serialize p50/p95/max for every stage; returns bytes written or 0
+    static size_t encodeHealth(uint8_t* buffer, size_t bufferSize) {
+        if (bufferSize < HEALTH_PACKET_SIZE) {
+            return 0;
+        }
+        uint8_t* p = buffer;
+        *p++ = HEALTH_TYPE_LATENCY;
+        *p++ = 1;  // format version
+        *p++ = STAGE_COUNT;
+        for (size_t i = 0; i < STAGE_COUNT; i++) {
+            const LatencyHistogram& h = histograms[i];
+            putU16(p, h.count() > UINT16_MAX ? UINT16_MAX : h.count());
+            putU32(p, h.percentile(50));
+            putU32(p, h.percentile(95));
+            putU32(p, h.max());
+        }
+        return p - buffer;
+    }
+};
+
+// Records the lifetime of the enclosing scope against a stage
+class ProbeScope {
+private:
+    ProbeStage stage;
+    uint32_t start;
+
+public:
+    explicit ProbeScope(ProbeStage stage) : stage(stage), start(DuckProbe::now()) {}
+    ~ProbeScope() { DuckProbe::record(stage, DuckProbe::now() - start); }
+};
+
+#define DUCK_PROBE_CONCAT_(a, b) a##b
+#define DUCK_PROBE_CONCAT(a, b) DUCK_PROBE_CONCAT_(a, b)
+#define DUCK_PROBE(stage) ProbeScope DUCK_PROBE_CONCAT(probe_, __LINE__)(stage)
+
+// Initialize static members
+LatencyHistogram DuckProbe::histograms[DuckProbe::STAGE_COUNT];
+uint32_t DuckProbe::lastReportTime = 0;
+
+#endif // DUCK_PROBE_H
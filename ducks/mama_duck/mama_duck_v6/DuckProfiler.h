@@ -0,0 +1,204 @@
+#ifndef DUCK_PROFILER_H
+#define DUCK_PROFILER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+#include "DuckConfig.h"
+
+// Occupancy of the MamaDuck pipeline buffers, filled in by the caller
+struct PipelineStats {
+    uint8_t poolOccupancy;
+    uint8_t poolHighWater;
+    uint8_t poolCapacity;
+    uint16_t logDropped;
+};
+
+// Runtime profiler built on the FreeRTOS trace facility. Each report covers
+// the interval since the previous one: per-task CPU share (when run-time
+// stats are compiled in), stack high-water marks, heap fragmentation and
+// pipeline buffer occupancy.
+class DuckProfiler {
+public:
+    static const uint8_t HEALTH_TYPE_RUNTIME = 0x02;
+    static const size_t MAX_TASKS = DuckConfig::HealthConfig::MAX_PROFILED_TASKS;
+    static const size_t TASK_NAME_LENGTH = 6;
+    // type, version, uptime s u32, heap free/min/largest u32, fragmentation %,
+    // pool occupancy/high water/capacity, log drops u16, task count
+    static const size_t HEADER_SIZE = 2 + 4 + 12 + 1 + 3 + 2 + 1;
+    // name (truncated), CPU share in 0.5% units, stack high water in bytes u16
+    static const size_t TASK_ENTRY_SIZE = TASK_NAME_LENGTH + 1 + 2;
+    static const size_t HEALTH_PACKET_SIZE = HEADER_SIZE + MAX_TASKS * TASK_ENTRY_SIZE;
+
+    struct TaskSample {
+        char name[configMAX_TASK_NAME_LEN];
+        uint8_t cpuHalfPercent;   // 0xFF when run-time stats are unavailable
+        uint32_t stackFreeBytes;
+    };
+
+    struct Sample {
+        uint32_t uptimeSeconds;
+        uint32_t heapFree;
+        uint32_t heapMinFree;
+        uint32_t heapLargestBlock;
+        uint8_t heapFragmentation;
+        PipelineStats pipeline;
+        uint8_t taskCount;
+        TaskSample tasks[MAX_TASKS];
+    };
+
+private:
+#if configUSE_TRACE_FACILITY
+    static TaskStatus_t statusBuffer[DuckConfig::HealthConfig::MAX_SYSTEM_TASKS];
+#endif
+#if configGENERATE_RUN_TIME_STATS
+    static TaskHandle_t previousHandles[DuckConfig::HealthConfig::MAX_SYSTEM_TASKS];
+    static uint32_t previousRunTime[DuckConfig::HealthConfig::MAX_SYSTEM_TASKS];
+    static uint8_t previousCount;
+    static uint32_t previousTotalRunTime;
+
+    static uint32_t previousRunTimeFor(TaskHandle_t handle) {
+        for (uint8_t i = 0; i < previousCount; i++) {
+            if (previousHandles[i] == handle) return previousRunTime[i];
+        }
+        return 0;
+    }
+#endif
+    static uint32_t lastReportTime;
+
+    static void putU16(uint8_t*& p, uint16_t v) {
+        *p++ = v & 0xFF;
+        *p++ = v >> 8;
+    }
+
+    static void putU32(uint8_t*& p, uint32_t v) {
+        for (int i = 0; i < 4; i++) {
+            *p++ = (v >> (8 * i)) & 0xFF;
+        }
+    }
+
+public:
+    static bool reportDue(uint32_t nowMs) {
+        if (nowMs - lastReportTime < DuckConfig::HealthConfig::RUNTIME_REPORT_INTERVAL) {
+            return false;
+        }
+        lastReportTime = nowMs;
+        return true;
+    }
+
+    static void sample(Sample& out, const PipelineStats& pipeline) {
+        out.uptimeSeconds = millis() / 1000;
+        out.pipeline = pipeline;
+
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+        out.heapFree = info.total_free_bytes;
+        out.heapMinFree = info.minimum_free_bytes;
+        out.heapLargestBlock = info.largest_free_block;
+        out.heapFragmentation = info.total_free_bytes
+            ? 100 - (uint8_t)((uint64_t)info.largest_free_block * 100 / info.total_free_bytes)
+            : 0;
+
+        out.taskCount = 0;
+#if configUSE_TRACE_FACILITY
+        uint32_t totalRunTime = 0;
+        UBaseType_t count = uxTaskGetSystemState(statusBuffer,
+                                                 DuckConfig::HealthConfig::MAX_SYSTEM_TASKS,
+                                                 &totalRunTime);
+#if configGENERATE_RUN_TIME_STATS
+        uint32_t elapsed = totalRunTime - previousTotalRunTime;
+#if !CONFIG_FREERTOS_UNICORE
+        elapsed *= portNUM_PROCESSORS;  // per-task run time is per core
+#endif
+#endif
+        for (UBaseType_t i = 0; i < count && out.taskCount < MAX_TASKS; i++) {
+            const TaskStatus_t& status = statusBuffer[i];
+            TaskSample& task = out.tasks[out.taskCount++];
+            strncpy(task.name, status.pcTaskName, sizeof(task.name) - 1);
+            task.name[sizeof(task.name) - 1] = '\0';
+            // ESP-IDF reports the stack high-water mark in bytes
+            task.stackFreeBytes = status.usStackHighWaterMark;
+#if configGENERATE_RUN_TIME_STATS
+            uint32_t used = status.ulRunTimeCounter - previousRunTimeFor(status.xHandle);
+            uint32_t share = elapsed ? (uint64_t)used * 200 / elapsed : 0;
+            task.cpuHalfPercent = share > 200 ? 200 : share;
+#else
+            task.cpuHalfPercent = 0xFF;
+#endif
+        }
+
+#if configGENERATE_RUN_TIME_STATS
+        previousCount = count;
+        for (UBaseType_t i = 0; i < count; i++) {
+            previousHandles[i] = statusBuffer[i].xHandle;
+            previousRunTime[i] = statusBuffer[i].ulRunTimeCounter;
+        }
+        previousTotalRunTime = totalRunTime;
+#endif
+#endif
+    }
+
+    static void print(const Sample& s) {
+        Serial.printf("[MAMA] Runtime: up %lus, heap free %lu min %lu largest %lu (%u%% fragmented)\n",
+                      (unsigned long)s.uptimeSeconds, (unsigned long)s.heapFree,
+                      (unsigned long)s.heapMinFree, (unsigned long)s.heapLargestBlock,
+                      s.heapFragmentation);
+        Serial.printf("[MAMA] Runtime: record pool %u/%u (high water %u), log drops %u\n",
+                      s.pipeline.poolOccupancy, s.pipeline.poolCapacity,
+                      s.pipeline.poolHighWater, s.pipeline.logDropped);
+        for (uint8_t i = 0; i < s.taskCount; i++) {
+            const TaskSample& t = s.tasks[i];
+            if (t.cpuHalfPercent == 0xFF) {
+                Serial.printf("[MAMA] Task %-20s cpu   n/a  stack free %lu\n",
+                              t.name, (unsigned long)t.stackFreeBytes);
+            } else {
+                Serial.printf("[MAMA] Task %-20s cpu %5.1f%% stack free %lu\n",
+                              t.name, t.cpuHalfPercent / 2.0f, (unsigned long)t.stackFreeBytes);
+            }
+        }
+    }
+
+    // Serialize a sample for the CDP health topic; returns bytes written or 0
+    static size_t encodeHealth(const Sample& s, uint8_t* buffer, size_t bufferSize) {
+        size_t needed = HEADER_SIZE + s.taskCount * TASK_ENTRY_SIZE;
+        if (bufferSize < needed) {
+            return 0;
+        }
+        uint8_t* p = buffer;
+        *p++ = HEALTH_TYPE_RUNTIME;
+        *p++ = 1;  // format version
+        putU32(p, s.uptimeSeconds);
+        putU32(p, s.heapFree);
+        putU32(p, s.heapMinFree);
+        putU32(p, s.heapLargestBlock);
+        *p++ = s.heapFragmentation;
+        *p++ = s.pipeline.poolOccupancy;
+        *p++ = s.pipeline.poolHighWater;
+        *p++ = s.pipeline.poolCapacity;
+        putU16(p, s.pipeline.logDropped);
+        *p++ = s.taskCount;
+        for (uint8_t i = 0; i < s.taskCount; i++) {
+            const TaskSample& t = s.tasks[i];
+            strncpy((char*)p, t.name, TASK_NAME_LENGTH);  // zero padded, not terminated
+            p += TASK_NAME_LENGTH;
+            *p++ = t.cpuHalfPercent;
+            putU16(p, t.stackFreeBytes > UINT16_MAX ? UINT16_MAX : t.stackFreeBytes);
+        }
+        return p - buffer;
+    }
+};
+
+// Initialize static members
+#if configUSE_TRACE_FACILITY
+TaskStatus_t DuckProfiler::statusBuffer[DuckConfig::HealthConfig::MAX_SYSTEM_TASKS];
+#endif
+#if configGENERATE_RUN_TIME_STATS
+TaskHandle_t DuckProfiler::previousHandles[DuckConfig::HealthConfig::MAX_SYSTEM_TASKS];
+uint32_t DuckProfiler::previousRunTime[DuckConfig::HealthConfig::MAX_SYSTEM_TASKS];
+uint8_t DuckProfiler::previousCount = 0;
+uint32_t DuckProfiler::previousTotalRunTime = 0;
+#endif
+uint32_t DuckProfiler::lastReportTime = 0;
+
+#endif // DUCK_PROFILER_H
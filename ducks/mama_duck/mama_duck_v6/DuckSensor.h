@@ -30,15 +30,23 @@ struct SensorData {
     int prediction;
     
     // GPS data
-    char gpsData[DuckConfig::SystemConfig::GPS_BUFFER_SIZE];
+    double latitude;
+    double longitude;
+    float altitude;  // metres
     bool hasValidGPS;
     
     // Timestamp
     unsigned long timestamp;
+    uint32_t queuedAt;  // DuckProbe::now() when handed to the TX task
 
-    void setGPSData(const char* data) {
-        strncpy(gpsData, data, DuckConfig::SystemConfig::GPS_BUFFER_SIZE - 1);
-        gpsData[DuckConfig::SystemConfig::GPS_BUFFER_SIZE - 1] = '\0';
+    // Clear the fields that are not always overwritten during a cycle
+    void reset() {
+        temp = humidity = pressure = gas = 0.0f;
+        temp_velocity = humidity_velocity = pressure_velocity = gas_velocity = 0.0f;
+        prediction = 0;
+        latitude = longitude = 0.0;
+        altitude = 0.0f;
+        hasValidGPS = false;
     }
 
     bool validate() const {
@@ -75,13 +83,13 @@ private:
         float mean = 0.0f, stdDev = 0.0f;
         
         // Calculate mean
-        for(int i = 0; i < DuckConfig::SystemConfig::HISTORY_WINDOW_SIZE; i++) {
+        for(size_t i = 0; i < DuckConfig::SystemConfig::HISTORY_WINDOW_SIZE; i++) {
             mean += history[i];
         }
         mean /= DuckConfig::SystemConfig::HISTORY_WINDOW_SIZE;
         
         // Calculate standard deviation
-        for(int i = 0; i < DuckConfig::SystemConfig::HISTORY_WINDOW_SIZE; i++) {
+        for(size_t i = 0; i < DuckConfig::SystemConfig::HISTORY_WINDOW_SIZE; i++) {
             stdDev += pow(history[i] - mean, 2);
         }
         return sqrt(stdDev / DuckConfig::SystemConfig::HISTORY_WINDOW_SIZE);
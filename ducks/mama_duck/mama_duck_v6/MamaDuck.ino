@@ -6,6 +6,7 @@
 #include <string>
 #include <arduino-timer.h>
 #include <CDP.h>
+#include <CdpPacket.h>
 #include "FastLED.h"
 #include <bme68x.h>
 #include <bme68x_defs.h>
@@ -22,6 +23,17 @@
 #include "DuckConfig.h"
 #include "DuckError.h"
 #include "DuckSensor.h"
+#include "DuckPool.h"
+#include "DuckPower.h"
+#include "DuckLog.h"
+#include "DuckProbe.h"
+#include "DuckProfiler.h"
+#include "DuckMemory.h"
+#include "DuckPayload.h"
+#include "DuckBatcher.h"
+#include "DuckReportPolicy.h"
+#include "DuckSequence.h"
+#include "DuckSchedule.h"
 
 // BME688 Configuration
 struct bme68x_dev bme;
@@ -50,30 +62,111 @@ HardwareSerial GPS(1);
 // Constants
 const uint32_t SERIAL_SPEED = 115200;
 
-// Queue handles
-QueueHandle_t sensorQueue;
-QueueHandle_t transmitQueue;
+// Records handed from the ML task to the TX task
+SensorRecordPool recordPool;
 
 // Mutex handles
 SemaphoreHandle_t bmeMutex;
 SemaphoreHandle_t gpsMutex;
+StaticSemaphore_t bmeMutexBuffer;
+StaticSemaphore_t gpsMutexBuffer;
 
 // Task handles
 TaskHandle_t mlProcessingTask;
 TaskHandle_t packetTransmissionTask;
+StaticTask_t mlTaskBuffer;
+StaticTask_t txTaskBuffer;
+StackType_t mlTaskStack[DuckConfig::SystemConfig::ML_STACK_SIZE];
+StackType_t txTaskStack[DuckConfig::SystemConfig::TX_STACK_SIZE];
+
+// Preallocated packet buffers
+uint8_t payloadBuffer[DuckPayload::RECORD_SIZE];
+uint8_t healthBuffer[DuckProbe::HEALTH_PACKET_SIZE > DuckProfiler::HEALTH_PACKET_SIZE
+                     ? DuckProbe::HEALTH_PACKET_SIZE : DuckProfiler::HEALTH_PACKET_SIZE];
+DuckProfiler::Sample profilerSample;
+
+// Telemetry kept until the PapaDuck acks it; TX task only
+typedef DuckSequence::Window<DuckConfig::AckConfig::WINDOW,
+                             DuckBatch::MAX_PAYLOAD - DuckSequence::HEADER_SIZE> SendWindow;
+SendWindow sendWindow({
+    DuckConfig::AckConfig::ACK_TIMEOUT,
+    DuckConfig::AckConfig::RESEND_HOLDOFF,
+    DuckConfig::AckConfig::MAX_TRANSMISSIONS
+});
+
+// Acks the radio task (loop) hears, handed to the TX task
+QueueHandle_t ackQueue;
+StaticQueue_t ackQueueBuffer;
+uint8_t ackQueueStorage[DuckConfig::AckConfig::ACK_QUEUE * sizeof(DuckSequence::Ack)];
 
 // Global variables
 MamaDuck duck;
+std::array<byte, 8> duckId;
 auto timer = timer_create_default();
 int counter = 1;
+uint32_t routineDropped = 0;
 bool setupOK = false;
 SensorManager sensorManager;
+DuckReport::Policy reportPolicy({
+    DuckConfig::ReportConfig::TEMP_DEADBAND,
+    DuckConfig::ReportConfig::HUMIDITY_DEADBAND,
+    DuckConfig::ReportConfig::PRESSURE_DEADBAND,
+    DuckConfig::ReportConfig::GAS_DEADBAND,
+    DuckConfig::ReportConfig::POSITION_DEADBAND,
+    DuckConfig::ReportConfig::HEARTBEAT_INTERVAL
+});
+DuckSchedule::Scheduler txSchedule({
+    DuckConfig::SystemConfig::BME_READ_INTERVAL,
+    DuckConfig::ScheduleConfig::SLOT_LENGTH,
+    DuckConfig::ScheduleConfig::MAX_SYNC_AGE,
+    DuckConfig::ScheduleConfig::SENSE_MARGIN,
+    DuckConfig::ScheduleConfig::BUSY_FRAMES
+});
+
+// Every statically allocated runtime region, reported at boot
+constexpr MemoryRegion STATIC_REGIONS[] = {
+    {"ML task stack", sizeof(mlTaskStack) + sizeof(mlTaskBuffer)},
+    {"TX task stack", sizeof(txTaskStack) + sizeof(txTaskBuffer)},
+    {"Log drain stack", DuckConfig::LogConfig::DRAIN_STACK_SIZE + sizeof(StaticTask_t)},
+    {"Record pool", sizeof(SensorRecordPool)},
+    {"Log ring", DuckLog::RING_BYTES},
+    {"Latency histograms", sizeof(LatencyHistogram) * DuckProbe::STAGE_COUNT},
+    {"Profiler sample", sizeof(profilerSample)},
+    {"Profiler task table", sizeof(TaskStatus_t) * DuckConfig::HealthConfig::MAX_SYSTEM_TASKS},
+    {"Mutexes", sizeof(bmeMutexBuffer) + sizeof(gpsMutexBuffer)},
+    {"Payload buffer", sizeof(payloadBuffer)},
+    {"Batch buffers", sizeof(DuckBatch::Encoder) + DuckBatch::MAX_PAYLOAD},
+    {"Report policy", sizeof(reportPolicy)},
+    {"Health buffer", sizeof(healthBuffer)},
+    {"Send window", sizeof(SendWindow)},
+    {"Ack queue", sizeof(ackQueueStorage) + sizeof(ackQueueBuffer)},
+    {"TX schedule", sizeof(txSchedule)},
+};
+
+static_assert(totalRegionSize(STATIC_REGIONS) <= DuckConfig::MemoryConfig::STATIC_RAM_BUDGET,
+              "Static allocations exceed STATIC_RAM_BUDGET");
 
 // Function declarations
-bool sendData(std::vector<byte> message, topics value);
+bool sendPacket(const byte* data, size_t length, topics value);
+void toReading(const SensorData& data, DuckPayload::Reading& reading);
+bool queueRecord(const SensorData* record, topics value, bool urgent);
+bool transmitPacket(void* context);
+void onPacketTransmitted(void* context, bool success);
+void sendQueued();
+void processAcks();
+void handleDuckData(std::vector<byte> packetBuffer);
+void batchRecord(SensorData* record);
+void dropRoutine(SensorData* record);
+void dispatchAlerts();
+void dispatchRoutine(SensorData* record);
+void flushBatch();
 void IRAM_ATTR resetModule();
-bool getGPSData(char* buffer, size_t bufferSize);
-std::vector<byte> stringToByteVector(const String& str);
+bool getGPSData(SensorData& data);
+void sendLatencyReport();
+void sendRuntimeReport();
+void sendReportPolicyStats();
+void sendDeliveryStats();
+void logScheduleStats();
 
 // BME688 helper functions
 BME68X_INTF_RET_TYPE bme68x_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_t len, void *intf_ptr) {
@@ -233,11 +326,17 @@ void IRAM_ATTR resetModule() {
     esp_restart();
 }
 
-bool getGPSData(char* buffer, size_t bufferSize) {
+bool getGPSData(SensorData& data) {
     if (xSemaphoreTake(gpsMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
         return false;
     }
 
+    // Drop what queued up while the UART was not read: the time in it is
+    // seconds old and would misalign the TX slots
+    while (GPS.available()) {
+        GPS.read();
+    }
+
     unsigned long startTime = millis();
     bool gotFix = false;
 
@@ -245,11 +344,15 @@ bool getGPSData(char* buffer, size_t bufferSize) {
         while (GPS.available()) {
             if (tgps.encode(GPS.read())) {
                 if (tgps.location.isValid()) {
-                    snprintf(buffer, bufferSize,
-                            "Lat:%.5f Lng:%.4f Alt:%.2f",
-                            tgps.location.lat(),
-                            tgps.location.lng(),
-                            tgps.altitude.feet() / 3.2808);
+                    data.latitude = tgps.location.lat();
+                    data.longitude = tgps.location.lng();
+                    data.altitude = tgps.altitude.feet() / 3.2808;
+                    // A fix also disciplines the time the TX slots follow
+                    if (tgps.time.isValid()) {
+                        uint32_t utcMs = ((tgps.time.hour() * 60UL + tgps.time.minute()) * 60UL +
+                                          tgps.time.second()) * 1000UL + tgps.time.centisecond() * 10UL;
+                        txSchedule.sync(utcMs, millis() - tgps.time.age());
+                    }
                     gotFix = true;
                     break;
                 }
@@ -263,41 +366,309 @@ bool getGPSData(char* buffer, size_t bufferSize) {
 
     if (!gotFix) {
         DuckErrorHandler::setError(DuckStatus::WARNING_GPS_NO_FIX);
-        strncpy(buffer, "NO_FIX", bufferSize);
         return false;
     }
 
     return true;
 }
 
-std::vector<byte> stringToByteVector(const String& str) {
-    std::vector<byte> byteVec;
-    byteVec.reserve(str.length());
-    for (unsigned int i = 0; i < str.length(); ++i) {
-        byteVec.push_back(static_cast<byte>(str[i]));
+// Single transmission attempt; retries are scheduled by the caller
+bool sendPacket(const byte* data, size_t length, topics value) {
+    DuckPower::stayAwake();
+    uint32_t sendStart = DuckProbe::now();
+    int err = duck.sendData(value, data, length);
+    DuckProbe::record(ProbeStage::SEND, DuckProbe::now() - sendStart);
+    DuckPower::allowSleep();
+    return err == DUCK_ERR_NONE;
+}
+
+// Copy the fields carried over the air into a payload reading
+void toReading(const SensorData& data, DuckPayload::Reading& reading) {
+    reading.counter = counter;
+    reading.temp = data.temp;
+    reading.humidity = data.humidity;
+    reading.pressure = data.pressure;
+    reading.gas = data.gas;
+    reading.prediction = data.prediction;
+    reading.hasGPS = data.hasValidGPS;
+    reading.latitude = data.latitude;
+    reading.longitude = data.longitude;
+    reading.altitude = data.altitude;
+}
+
+// Encode a pool record and queue it in the send window
+bool queueRecord(const SensorData* record, topics value, bool urgent) {
+    DuckPayload::Reading reading;
+    toReading(*record, reading);
+    size_t length = DuckPayload::encode(reading, payloadBuffer, sizeof(payloadBuffer));
+    if (length == 0) {
+        return false;
+    }
+    return sendWindow.add(value, payloadBuffer, length, urgent) != nullptr;
+}
+
+// One transmission attempt of a window packet
+bool transmitPacket(void* context) {
+    const SendWindow::Slot* slot = static_cast<const SendWindow::Slot*>(context);
+    return sendPacket(slot->data, slot->length, static_cast<topics>(slot->topic));
+}
+
+// End of a transmission, after success or the last local retry; the packet
+// stays in the window until the PapaDuck acks it
+void onPacketTransmitted(void* context, bool success) {
+    sendWindow.sent(static_cast<SendWindow::Slot*>(context), millis());
+
+    if (success) {
+        DUCK_LOGI(LogId::TX_OK);
+        leds[0] = CRGB::Green; // Green indicates successful transmission
+    } else {
+        DUCK_LOGW(LogId::TX_FAILED);
+        leds[0] = CRGB::Red; // Red indicates failed transmission
+    }
+    FastLED.show();
+}
+
+// Start transmitting queued window packets, alerts first, while this duck's
+// TX slot is open. The retry slots only cover local send failures;
+// over-the-air loss is handled by acks.
+void sendQueued() {
+    SendWindow::Slot* slot;
+    while (txSchedule.inSlot(millis()) && (slot = sendWindow.due()) != nullptr) {
+        if (!slot->urgent && !DuckErrorHandler::routineSlotAvailable()) {
+            return;
+        }
+        sendWindow.sending(slot);
+        bool started = slot->urgent
+            ? DuckErrorHandler::retryAsync("Send Alert", transmitPacket, slot, onPacketTransmitted,
+                                           DuckConfig::SystemConfig::ALERT_MAX_RETRY_COUNT, RetryPriority::ALERT)
+            : DuckErrorHandler::retryAsync("Send Data", transmitPacket, slot, onPacketTransmitted);
+        if (!started) {
+            sendWindow.requeue(slot);
+            return;
+        }
+    }
+}
+
+// Apply the acks the radio task received, then resend what timed out.
+// Packets that keep going unacked may be colliding with a duck using the
+// same TX slot; the schedule moves to another one.
+void processAcks() {
+    DuckSequence::Ack ack;
+    uint32_t now = millis();
+    uint32_t acked = sendWindow.counters().acked;
+    uint32_t unacked = sendWindow.counters().unacked;
+    while (xQueueReceive(ackQueue, &ack, 0) == pdTRUE) {
+        sendWindow.onAck(ack, now);
+    }
+    sendWindow.poll(now);
+    if (sendWindow.counters().unacked != unacked) {
+        txSchedule.outcome(false, now);
+    } else if (sendWindow.counters().acked != acked) {
+        txSchedule.outcome(true, now);
+    }
+}
+
+// Move the open batch into the send window, if there is room for it.
+// Under backpressure the batch stays open and keeps coalescing readings.
+void flushBatch() {
+    if (!sendWindow.hasRoom() || !DuckBatcher::seal()) {
+        return;
+    }
+    if (sendWindow.add(location, DuckBatcher::data(), DuckBatcher::length(), false)) {
+        DUCK_LOGI(LogId::BATCH_QUEUED, DuckBatcher::count(), DuckBatcher::length());
+    } else {
+        DUCK_LOGW(LogId::BATCH_FAILED, DuckBatcher::count());
+    }
+    DuckBatcher::complete();
+    sendQueued();
+}
+
+// Add a routine reading to the open batch; it is dropped when the batch is
+// full and cannot be sent yet
+void batchRecord(SensorData* record) {
+    DuckPayload::Reading reading;
+    toReading(*record, reading);
+    uint32_t now = millis();
+    if (!DuckBatcher::add(reading, now)) {
+        flushBatch();
+        if (!DuckBatcher::add(reading, now)) {
+            dropRoutine(record);
+            return;
+        }
+    }
+    counter++;
+    recordPool.release(record);
+    if (DuckBatcher::flushDue(now)) {
+        flushBatch();
     }
-    return byteVec;
 }
 
-bool sendData(std::vector<byte> message, topics value) {
-    return DuckErrorHandler::retry("Send Data", [&]() {
-        int err = duck.sendData(value, message);
-        return err == DUCK_ERR_NONE;
-    });
+// Routine readings give way under backpressure instead of queueing. The
+// counter still advances, so the gap shows downstream.
+void dropRoutine(SensorData* record) {
+    recordPool.release(record);
+    counter++;
+    routineDropped++;
+    DUCK_LOGW(LogId::ROUTINE_DROPPED, routineDropped);
+}
+
+// Queue every published fire prediction ahead of routine traffic; an alert
+// displaces the oldest routine packet from a full window. The batch
+// collected so far follows right behind.
+void dispatchAlerts() {
+    SensorData* record;
+    bool dispatched = false;
+    while ((record = recordPool.receive(Lane::ALERT)) != nullptr) {
+        DuckProbe::record(ProbeStage::ALERT_QUEUE, DuckProbe::now() - record->queuedAt);
+        if (!queueRecord(record, alert, true)) {
+            // Every window slot already holds an alert
+            DuckErrorHandler::setError(DuckStatus::ERROR_QUEUE_FULL, "Send window full of alerts");
+        }
+        counter++;
+        recordPool.release(record);
+        dispatched = true;
+    }
+    if (dispatched && DuckConfig::BatchConfig::ENABLED) {
+        flushBatch();
+    }
+    sendQueued();
+}
+
+void dispatchRoutine(SensorData* record) {
+    DuckProbe::record(ProbeStage::QUEUE, DuckProbe::now() - record->queuedAt);
+    if (DuckConfig::BatchConfig::ENABLED) {
+        batchRecord(record);
+    } else if (!queueRecord(record, location, false)) {
+        dropRoutine(record);
+    } else {
+        counter++;
+        recordPool.release(record);
+        sendQueued();
+    }
+}
+
+// Print p50/p95/max per pipeline stage and send them on the health topic.
+// Each report covers one LATENCY_REPORT_INTERVAL: the histograms start
+// over once it is sent.
+void sendLatencyReport() {
+    DuckProbe::print();
+    size_t length = DuckProbe::encodeHealth(healthBuffer, sizeof(healthBuffer));
+    DuckProbe::reset();
+    if (length == 0) {
+        return;
+    }
+
+    // Health reports are best effort and not retried
+    if (!sendPacket(healthBuffer, length, health)) {
+        DUCK_LOGW(LogId::HEALTH_SEND_FAILED, healthBuffer[0]);
+    }
+}
+
+// Print task, heap and buffer usage and send them on the health topic
+void sendRuntimeReport() {
+    PipelineStats pipeline;
+    pipeline.poolOccupancy = recordPool.occupancy();
+    pipeline.poolHighWater = recordPool.getHighWater();
+    pipeline.poolCapacity = SensorRecordPool::POOL_SIZE;
+    pipeline.logDropped = min(DuckLog::getDropped(), (uint32_t)UINT16_MAX);
+
+    DuckProfiler::sample(profilerSample, pipeline);
+    DuckProfiler::print(profilerSample);
+    DuckMemory::printAllocations();
+    DuckErrorHandler::printRetryStats();
+    size_t length = DuckProfiler::encodeHealth(profilerSample, healthBuffer, sizeof(healthBuffer));
+    if (length == 0) {
+        return;
+    }
+
+    if (!sendPacket(healthBuffer, length, health)) {
+        DUCK_LOGW(LogId::HEALTH_SEND_FAILED, healthBuffer[0]);
+    }
+    sendReportPolicyStats();
+    sendDeliveryStats();
+    logScheduleStats();
+}
+
+// Log and send how many readings the report policy sent and suppressed
+void sendReportPolicyStats() {
+    if (!DuckConfig::ReportConfig::ENABLED) {
+        return;
+    }
+    DUCK_LOGI(LogId::REPORT_STATS, reportPolicy.suppressed(),
+              reportPolicy.count(DuckReport::Reason::FIRST),
+              reportPolicy.count(DuckReport::Reason::PREDICTION),
+              reportPolicy.count(DuckReport::Reason::DEADBAND),
+              reportPolicy.count(DuckReport::Reason::HEARTBEAT));
+    size_t length = reportPolicy.encodeHealth(healthBuffer, sizeof(healthBuffer));
+    if (length == 0) {
+        return;
+    }
+
+    if (!sendPacket(healthBuffer, length, health)) {
+        DUCK_LOGW(LogId::HEALTH_SEND_FAILED, healthBuffer[0]);
+    }
+}
+
+// Log and send the end-to-end delivery counters
+void sendDeliveryStats() {
+    const DuckSequence::SenderStats& stats = sendWindow.counters();
+    DUCK_LOGI(LogId::DELIVERY_STATS, stats.packets, stats.retransmissions, stats.acked, stats.expired,
+              sendWindow.inUse());
+    size_t length = sendWindow.encodeHealth(healthBuffer, sizeof(healthBuffer));
+    if (length == 0) {
+        return;
+    }
+
+    if (!sendPacket(healthBuffer, length, health)) {
+        DUCK_LOGW(LogId::HEALTH_SEND_FAILED, healthBuffer[0]);
+    }
+}
+
+void logScheduleStats() {
+    const DuckSchedule::Stats& stats = txSchedule.counters();
+    DUCK_LOGI(LogId::SCHEDULE_STATS, stats.syncedCycles, stats.cycles, stats.late, stats.reselections,
+              txSchedule.senseLead());
+}
+
+// Radio task: notes the slot other traffic uses and hands acks addressed
+// to this duck to the TX task
+void handleDuckData(std::vector<byte> packetBuffer) {
+    txSchedule.heard(millis());
+    CdpPacket packet(packetBuffer);
+    DuckSequence::Ack ack;
+    if (packet.dduid.size() != duckId.size() ||
+        !std::equal(duckId.begin(), duckId.end(), packet.dduid.begin()) ||
+        !DuckSequence::decodeAck(packet.data.data(), packet.data.size(), ack)) {
+        return;
+    }
+    if (xQueueSend(ackQueue, &ack, 0) == pdTRUE && packetTransmissionTask) {
+        xTaskNotifyGive(packetTransmissionTask);
+    }
 }
 
 // Task to handle ML processing
 void mlProcessingLoop(void* parameter) {
-    SensorData sensorData;
-    static char gpsBuffer[DuckConfig::SystemConfig::GPS_BUFFER_SIZE];
-    
     while (true) {
-        memset(&sensorData, 0, sizeof(SensorData));
+        DuckPower::countWake(WakeSource::ML_TASK);
+
+        // Produce the reading directly in a pool record
+        SensorData* record = recordPool.acquire();
+        if (!record) {
+            DuckErrorHandler::setError(DuckStatus::ERROR_QUEUE_FULL, "Record pool exhausted");
+            recordPool.printStats();
+            vTaskDelay(pdMS_TO_TICKS(DuckConfig::SystemConfig::BME_READ_INTERVAL));
+            continue;
+        }
+        SensorData& sensorData = *record;
         sensorData.timestamp = millis();
+        uint32_t cycleStart = DuckProbe::now();
         
         // Get BME688 data
         float temp, humidity, pressure, gas;
-        if (getBME688Data(temp, humidity, pressure, gas)) {
+        uint32_t stageStart = DuckProbe::now();
+        bool sensorOK = getBME688Data(temp, humidity, pressure, gas);
+        DuckProbe::record(ProbeStage::SENSOR_READ, DuckProbe::now() - stageStart);
+        if (sensorOK) {
             sensorData.temp = temp;
             sensorData.humidity = humidity;
             sensorData.pressure = pressure;
@@ -309,48 +680,48 @@ void mlProcessingLoop(void* parameter) {
         }
         
         // Print sensor data report
-        Serial.println("\n[MAMA] ======== SENSOR DATA REPORT ========");
-        Serial.println("[MAMA] ----- Environmental Readings -----");
-        Serial.printf("[MAMA] Temperature: %.2f°C\n", sensorData.temp);
-        Serial.printf("[MAMA] Humidity: %.3f%%\n", sensorData.humidity);
-        Serial.printf("[MAMA] Pressure: %.2f hPa\n", sensorData.pressure);
-        Serial.printf("[MAMA] Gas: %.2f\n", sensorData.gas);
+        DUCK_LOGD(LogId::REPORT_BEGIN);
+        DUCK_LOGD(LogId::REPORT_ENV);
+        DUCK_LOGD(LogId::TEMPERATURE, sensorData.temp);
+        DUCK_LOGD(LogId::HUMIDITY, sensorData.humidity);
+        DUCK_LOGD(LogId::PRESSURE, sensorData.pressure);
+        DUCK_LOGD(LogId::GAS, sensorData.gas);
         
         // Process sensor data
+        stageStart = DuckProbe::now();
         sensorManager.processSensorData(sensorData);
+        DuckProbe::record(ProbeStage::PROCESS, DuckProbe::now() - stageStart);
         
         // Print processed data
-        Serial.println("[MAMA] ----- ML Feature Processing -----");
-        Serial.printf("[MAMA] Scaled Temp: %.4f\n", sensorData.scaled_temp);
-        Serial.printf("[MAMA] Scaled Humidity: %.4f\n", sensorData.scaled_humidity);
-        Serial.printf("[MAMA] Scaled Pressure: %.4f\n", sensorData.scaled_pressure);
-        Serial.printf("[MAMA] Scaled Gas: %.4f\n", sensorData.scaled_gas);
-        Serial.printf("[MAMA] Temp Volatility: %.4f\n", sensorData.temp_volatility);
-        Serial.printf("[MAMA] Humidity Volatility: %.4f\n", sensorData.humidity_volatility);
-        Serial.printf("[MAMA] Pressure Volatility: %.4f\n", sensorData.pressure_volatility);
+        DUCK_LOGD(LogId::REPORT_FEATURES);
+        DUCK_LOGD(LogId::SCALED_TEMP, sensorData.scaled_temp);
+        DUCK_LOGD(LogId::SCALED_HUMIDITY, sensorData.scaled_humidity);
+        DUCK_LOGD(LogId::SCALED_PRESSURE, sensorData.scaled_pressure);
+        DUCK_LOGD(LogId::SCALED_GAS, sensorData.scaled_gas);
+        DUCK_LOGD(LogId::TEMP_VOLATILITY, sensorData.temp_volatility);
+        DUCK_LOGD(LogId::HUMIDITY_VOLATILITY, sensorData.humidity_volatility);
+        DUCK_LOGD(LogId::PRESSURE_VOLATILITY, sensorData.pressure_volatility);
         // add gas volatility
-        Serial.printf("[MAMA] Temp Velocity: %.4f\n", sensorData.temp_velocity);
-        Serial.printf("[MAMA] Humidity Velocity: %.4f\n", sensorData.humidity_velocity);
-        Serial.printf("[MAMA] Pressure Velocity: %.4f\n", sensorData.pressure_velocity);
-        Serial.printf("[MAMA] Gas Velocity: %.4f\n", sensorData.gas_velocity);
-        //Serial.println("[MAMA] ===================================\n");
+        DUCK_LOGD(LogId::TEMP_VELOCITY, sensorData.temp_velocity);
+        DUCK_LOGD(LogId::HUMIDITY_VELOCITY, sensorData.humidity_velocity);
+        DUCK_LOGD(LogId::PRESSURE_VELOCITY, sensorData.pressure_velocity);
+        DUCK_LOGD(LogId::GAS_VELOCITY, sensorData.gas_velocity);
         
         // Get GPS data and print debug info
-        Serial.println("[MAMA] --------- GPS ---------");
-        Serial.print("[MAMA] Latitude  : "); Serial.println(tgps.location.lat(), 5);
-        Serial.print("[MAMA] Longitude : "); Serial.println(tgps.location.lng(), 4);
-        Serial.print("[MAMA] Altitude  : "); Serial.print(tgps.altitude.feet() / 3.2808); Serial.println("M");
-        Serial.print("[MAMA] Satellites: "); Serial.println(tgps.satellites.value());
-        Serial.print("[MAMA] Time      : ");
-        Serial.print(tgps.time.hour()); Serial.print(":"); 
-        Serial.print(tgps.time.minute()); Serial.print(":"); 
-        Serial.println(tgps.time.second());
-        Serial.print("[MAMA] Speed     : "); Serial.println(tgps.speed.kmph());
-        //Serial.println("[MAMA] **********************");
+        DUCK_LOGD(LogId::REPORT_GPS);
+        DUCK_LOGD(LogId::GPS_LATITUDE, tgps.location.lat());
+        DUCK_LOGD(LogId::GPS_LONGITUDE, tgps.location.lng());
+        DUCK_LOGD(LogId::GPS_ALTITUDE, tgps.altitude.feet() / 3.2808);
+        DUCK_LOGD(LogId::GPS_SATELLITES, tgps.satellites.value());
+        DUCK_LOGD(LogId::GPS_TIME, tgps.time.hour(), tgps.time.minute(), tgps.time.second());
+        DUCK_LOGD(LogId::GPS_SPEED, tgps.speed.kmph());
         
-        // Get GPS data
-        sensorData.hasValidGPS = getGPSData(gpsBuffer, sizeof(gpsBuffer));
-        sensorData.setGPSData(gpsBuffer);
+        // Get GPS data (the GPS UART does not receive during light sleep)
+        DuckPower::stayAwake();
+        stageStart = DuckProbe::now();
+        sensorData.hasValidGPS = getGPSData(sensorData);
+        DuckProbe::record(ProbeStage::GPS, DuckProbe::now() - stageStart);
+        DuckPower::allowSleep();
         
         // Make ML prediction
         float features[] = {
@@ -369,15 +740,35 @@ void mlProcessingLoop(void* parameter) {
         };
         
         Eloquent::ML::Port::RandomForest forest;
+        stageStart = DuckProbe::now();
         sensorData.prediction = forest.predict(features);
-        Serial.println("[MAMA] ----- ML Prediction -----");
-        Serial.printf("[MAMA] Prediction: %d\n", sensorData.prediction);
-        Serial.println("[MAMA] ===================================\n");
+        DuckProbe::record(ProbeStage::PREDICT, DuckProbe::now() - stageStart);
+        DUCK_LOGD(LogId::REPORT_PREDICTION);
+        DUCK_LOGI(LogId::PREDICTION, sensorData.prediction);
+        DUCK_LOGD(LogId::REPORT_END);
         
-        // Send to transmission queue with timeout
-        if (xQueueSend(transmitQueue, &sensorData, pdMS_TO_TICKS(1000)) != pdTRUE) {
-            DuckErrorHandler::setError(DuckStatus::ERROR_QUEUE_FULL);
+        // Report by exception: readings that match the last one sent are
+        // only counted, and the transmission task is not woken for them
+        sensorData.queuedAt = DuckProbe::now();
+        DuckProbe::record(ProbeStage::CYCLE, sensorData.queuedAt - cycleStart);
+        DuckPayload::Reading reading;
+        toReading(sensorData, reading);
+        if (DuckConfig::ReportConfig::ENABLED &&
+            reportPolicy.evaluate(reading, millis()) == DuckReport::Reason::SUPPRESSED) {
+            recordPool.discard(record);
+            DUCK_LOGD(LogId::REPORT_SUPPRESSED, reportPolicy.suppressed());
+        } else {
+            // Hand the record over to the transmission task and wake it;
+            // fire predictions take the alert lane
+            recordPool.publish(record, sensorData.prediction == 1 ? Lane::ALERT : Lane::ROUTINE);
+            if (packetTransmissionTask) {
+                xTaskNotifyGive(packetTransmissionTask);
+            }
         }
+        DUCK_LOGD(LogId::POOL_STATS, recordPool.occupancy(), SensorRecordPool::POOL_SIZE,
+                  recordPool.pending(), recordPool.getHighWater(), recordPool.getAcquireFailures());
+        txSchedule.sensed(sensorData.timestamp, millis());
+        DuckLog::flush();
         
         // Check stack health
         DuckErrorHandler::checkStackHealth(
@@ -386,38 +777,69 @@ void mlProcessingLoop(void* parameter) {
             1024
         );
         
-        vTaskDelay(pdMS_TO_TICKS(DuckConfig::SystemConfig::BME_READ_INTERVAL));
+        // Sleep until the next cycle can finish just before this duck's slot
+        vTaskDelay(pdMS_TO_TICKS(txSchedule.senseDelay(millis())));
     }
 }
 
 // Task to handle packet transmission
 void packetTransmissionLoop(void* parameter) {
-    SensorData sensorData;
-    static char messageBuffer[DuckConfig::SystemConfig::MESSAGE_BUFFER_SIZE];
-    
     while (true) {
-        if (xQueueReceive(transmitQueue, &sensorData, pdMS_TO_TICKS(1000)) == pdTRUE) {
-            snprintf(messageBuffer, sizeof(messageBuffer),
-                     "Counter:%d Temp:%.2f Hum:%.3f Press:%.2f Gas:%.2f Pred:%d %s",
-                     counter,
-                     sensorData.temp,
-                     sensorData.humidity,
-                     sensorData.pressure,
-                     sensorData.gas,
-                     sensorData.prediction,
-                     sensorData.gpsData);
-            
-            bool result = sendData(stringToByteVector(String(messageBuffer)), location);
-            
-            if (result) {
-                Serial.println("[MAMA] Packet transmission successful");
-                counter++;
-                leds[0] = CRGB::Green; // Green indicates successful transmission
-            } else {
-                Serial.println("[MAMA] Packet transmission failed");
-                leds[0] = CRGB::Red; // Red indicates failed transmission
+        // Sleep until the ML task publishes a record, an ack arrives, a
+        // retry or ack timeout falls due, the open batch ages out or the TX
+        // slot opens for queued packets
+        uint32_t wakeDelay = DuckErrorHandler::nextRetryDelay();
+        if (wakeDelay != UINT32_MAX) {
+            // Retries wait for this duck's TX slot like first attempts
+            uint32_t slotDelay = txSchedule.timeUntilSlot(millis());
+            if (slotDelay > wakeDelay) {
+                wakeDelay = slotDelay;
+            }
+        }
+        uint32_t batchDelay = DuckBatcher::timeUntilDue(millis());
+        if (batchDelay < wakeDelay) {
+            wakeDelay = batchDelay;
+        }
+        uint32_t ackDelay = sendWindow.timeUntilDue(millis());
+        if (ackDelay < wakeDelay) {
+            wakeDelay = ackDelay;
+        }
+        // An open slot was already used as far as the retry slots allow
+        if (sendWindow.due() != nullptr) {
+            uint32_t slotDelay = txSchedule.timeUntilSlot(millis());
+            if (slotDelay > 0 && slotDelay < wakeDelay) {
+                wakeDelay = slotDelay;
             }
-            FastLED.show();
+        }
+        ulTaskNotifyTake(pdTRUE, wakeDelay == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(wakeDelay));
+        DuckPower::countWake(WakeSource::TX_TASK);
+
+        // Acks first so resends only go out for what is still missing, then
+        // new alerts, due retries (alert retries first, only inside the TX
+        // slot) and routine readings, checking for alerts again between them
+        processAcks();
+        dispatchAlerts();
+        if (txSchedule.inSlot(millis())) {
+            DuckErrorHandler::processRetries();
+        }
+
+        SensorData* record;
+        while ((record = recordPool.receive(Lane::ROUTINE)) != nullptr) {
+            dispatchRoutine(record);
+            dispatchAlerts();
+        }
+        if (DuckBatcher::flushDue(millis())) {
+            flushBatch();
+        }
+        sendQueued();
+        DuckLog::flush();
+
+        // Periodic per-stage latency report
+        if (DuckProbe::reportDue(millis(), DuckConfig::HealthConfig::LATENCY_REPORT_INTERVAL)) {
+            sendLatencyReport();
+        }
+        if (DuckProfiler::reportDue(millis())) {
+            sendRuntimeReport();
         }
         
         // Check stack health
@@ -426,8 +848,6 @@ void packetTransmissionLoop(void* parameter) {
             "Packet_Transmission", 
             1024
         );
-        
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
 
@@ -436,6 +856,9 @@ void setup() {
     Serial.begin(SERIAL_SPEED);
     delay(1000); // Wait for Serial to initialize
 
+    // Start the deferred logger's drain task
+    DuckLog::begin();
+
     // Initialize LED
     FastLED.addLeds<LED_TYPE, DuckConfig::SystemConfig::LED_PIN, COLOR_ORDER>(
         leds, 
@@ -447,15 +870,22 @@ void setup() {
 
     // Initialize Duck with error handling
     std::string deviceId("ASUMAMA2"); //CHANGE WHEN FLASHING TO MULTIPLE DUCKS
-    std::array<byte, 8> devId;
-    std::copy_n(deviceId.begin(), 8, devId.begin());
+    std::copy_n(deviceId.begin(), 8, duckId.begin());
     
     if (!DuckErrorHandler::retry("Duck Setup", [&]() {
-        return duck.setupWithDefaults(devId) == DUCK_ERR_NONE;
+        return duck.setupWithDefaults(duckId) == DUCK_ERR_NONE;
     })) {
         return;
     }
 
+    // Acks from the PapaDuck; sequence numbers start at a random value so
+    // the gateway tells a reboot from a resend
+    ackQueue = xQueueCreateStatic(DuckConfig::AckConfig::ACK_QUEUE, sizeof(DuckSequence::Ack),
+                                  ackQueueStorage, &ackQueueBuffer);
+    sendWindow.begin((uint16_t)esp_random());
+    txSchedule.begin(duckId.data(), duckId.size(), esp_random());
+    duck.onReceiveDuckData(handleDuckData);
+
     // Initialize GPS
     GPS.begin(9600, SERIAL_8N1, 34, 12);
 
@@ -467,50 +897,49 @@ void setup() {
     }
 
     // Create mutexes
-    bmeMutex = xSemaphoreCreateMutex();
-    gpsMutex = xSemaphoreCreateMutex();
+    bmeMutex = xSemaphoreCreateMutexStatic(&bmeMutexBuffer);
+    gpsMutex = xSemaphoreCreateMutexStatic(&gpsMutexBuffer);
     
     if (!bmeMutex || !gpsMutex) {
         DuckErrorHandler::setError(DuckStatus::ERROR_SENSOR_READ, "Failed to create mutexes");
         return;
     }
     
-    // Create queues
-    sensorQueue = xQueueCreate(5, sizeof(SensorData));
-    transmitQueue = xQueueCreate(5, sizeof(SensorData));
-    
-    if (!sensorQueue || !transmitQueue) {
-        DuckErrorHandler::setError(DuckStatus::ERROR_QUEUE_FULL, "Failed to create queues");
-        return;
-    }
+    // Fill the record pool's free list
+    recordPool.begin();
+
+    // Enable DFS and automatic light sleep between sensing cycles
+    DuckPower::begin();
     
     // Create tasks
-    BaseType_t mlTaskCreated = xTaskCreatePinnedToCore(
+    mlProcessingTask = xTaskCreateStaticPinnedToCore(
         mlProcessingLoop,
         "ML_Processing",
         DuckConfig::SystemConfig::ML_STACK_SIZE,
         NULL,
         2,
-        &mlProcessingTask,
+        mlTaskStack,
+        &mlTaskBuffer,
         0
     );
     
-    if (mlTaskCreated != pdPASS) {
+    if (!mlProcessingTask) {
         DuckErrorHandler::setError(DuckStatus::ERROR_SENSOR_READ, "Failed to create ML task");
         return;
     }
     
-    BaseType_t txTaskCreated = xTaskCreatePinnedToCore(
+    packetTransmissionTask = xTaskCreateStaticPinnedToCore(
         packetTransmissionLoop,
         "Packet_Transmission",
         DuckConfig::SystemConfig::TX_STACK_SIZE,
         NULL,
         1,
-        &packetTransmissionTask,
+        txTaskStack,
+        &txTaskBuffer,
         1
     );
     
-    if (txTaskCreated != pdPASS) {
+    if (!packetTransmissionTask) {
         DuckErrorHandler::setError(DuckStatus::ERROR_TRANSMISSION, "Failed to create TX task");
         return;
     }
@@ -523,6 +952,8 @@ void setup() {
     leds[0] = CRGB::Gold; // Gold indicates setup complete
     FastLED.show();
     setupOK = true;
+    DuckMemory::printBudget(STATIC_REGIONS);
+    DuckMemory::markSteadyState();
     Serial.println("[MAMA] Setup OK!");
 }
 
@@ -532,4 +963,10 @@ void loop() {
     }
     duck.run();
     esp_task_wdt_reset();
+
+    DuckPower::countWake(WakeSource::RADIO_POLL);
+    DuckPower::reportWakeStats();
+
+    // Yield between radio polls so the idle task can enter light sleep
+    vTaskDelay(pdMS_TO_TICKS(DuckConfig::PowerConfig::RADIO_POLL_INTERVAL));
 }
\ No newline at end of file
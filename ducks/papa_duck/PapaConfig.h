@@ -0,0 +1,144 @@
+#ifndef PAPA_CONFIG_H
+#define PAPA_CONFIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace PapaConfig {
+    // Board sizing. Classic ESP32 boards (Heltec V2, T-Beam, TTGO LoRa32)
+    // have about 160 KB of static DRAM and need the heap for WiFi and the
+    // TLS handshake; the ESP32-S3 envs build with -DPAPA_LARGE_TABLES and
+    // track 500 devices.
+    struct MemoryConfig {
+#ifdef PAPA_LARGE_TABLES
+        static const size_t DEVICES = 512;                    // per-device tables
+        static const size_t STATIC_RAM_BUDGET = 224 * 1024;   // checked at build time
+#else
+        static const size_t DEVICES = 128;
+        static const size_t STATIC_RAM_BUDGET = 128 * 1024;
+#endif
+    };
+
+    // Store-and-forward log for packets that could not be published
+    struct StoreConfig {
+        static const size_t RAM_QUEUE_MAX = 5;                // fallback queue without a store partition
+        static const uint16_t DRAIN_MESSAGES = 50;            // MQTT messages per drain slice
+        static const uint32_t DRAIN_INTERVAL = 1000;          // 1 second between drain slices
+        static const uint32_t STATS_INTERVAL = 300000;        // 5 minutes
+    };
+
+    // MQTT publisher: pipelined frames and optional per-topic JSON arrays
+    struct PublishConfig {
+        static const bool AGGREGATE = false;                  // the OWL DMS ingest expects one object per message
+        static const uint32_t AGGREGATE_WINDOW = 2000;        // 2 seconds
+        static const uint16_t MAX_AGGREGATE = 32;             // messages per array
+        static const size_t MAX_MESSAGE = 2048;               // bytes per array, below the broker limit
+        static const size_t SLOTS = 4;                        // topics aggregated at once
+        static const size_t TOPIC_SIZE = 96;
+        static const size_t PIPELINE_SIZE = 4096;             // frames written in one TLS record
+        static const uint32_t FLUSH_INTERVAL = 50;            // ms frames may wait before the write
+    };
+
+    // WiFi/MQTT connection manager
+    struct LinkConfig {
+        static const uint32_t WIFI_JOIN_TIMEOUT = 15000;      // 15 seconds per association attempt
+        static const uint32_t BACKOFF_BASE = 1000;            // 1 second after the first failure
+        static const uint32_t BACKOFF_MAX = 60000;            // 1 minute
+        static const uint32_t SOCKET_TIMEOUT = 10;            // seconds, bounds a connect attempt
+        static const uint32_t CONNECT_STACK_SIZE = 8 * 1024;  // TLS handshake runs on this stack
+    };
+
+    // Radio task (Arduino loop, core 1) to publish task (core 0) hand-off
+    struct TaskConfig {
+        static const size_t PACKET_SLOTS = 64;                // power of two, 2 s of back to back frames
+        static const size_t PACKET_SIZE = 256;                // largest LoRa frame
+        static const size_t COMMAND_SLOTS = 4;                // cloud commands waiting for the radio
+        static const size_t COMMAND_SIZE = 64;
+        static const uint32_t PUBLISH_STACK_SIZE = 16 * 1024; // JSON, store and TLS writes
+        static const uint8_t PUBLISH_CORE = 0;                // with the WiFi stack
+        static const uint32_t PUBLISH_IDLE = 10;              // ms between polls without packets
+    };
+
+    // Duplicate filter on (sduid, muid) for mesh floods. From about 7 msg/s
+    // (70 MamaDucks) some entries are evicted before WINDOW ends; copies
+    // arrive within seconds, so dedup_bench misses none up to 100 msg/s.
+    // Keeping every entry for the whole window at 128 devices takes 16384
+    // slots, more RAM than either board has to spare.
+    struct DedupConfig {
+        static const size_t CAPACITY = 4096;                  // power of two, 6 bytes each
+        static const size_t PROBE = 8;                        // slots searched per lookup
+        static const uint16_t WINDOW = 120;                   // 2 minutes of retention, in seconds
+    };
+
+    // Per-device rolling summaries on evt/summary
+    struct SummaryConfig {
+        static const size_t DEVICES = 64;                     // devices tracked at once
+        static const size_t ID_SIZE = 16;                     // sduid bytes kept
+        static const uint32_t INTERVAL = 300000;              // 5 minutes per summary
+    };
+
+    // End-to-end acks for sequenced MamaDuck telemetry
+    struct SequenceConfig {
+        static const size_t DEVICES = 64;                     // senders tracked at once
+        static const size_t ID_SIZE = 8;                      // CDP DUID
+        static const size_t ACK_SLOTS = 16;                   // power of two, acks waiting for the radio
+    };
+
+    // Gateway re-scoring of MamaDuck fire predictions
+    struct InferenceConfig {
+        static const bool ENABLED = true;
+        static const bool VETO = true;                        // false only annotates edge alerts
+        static const size_t DEVICES = MemoryConfig::DEVICES;  // feature windows kept at once, ~110 bytes each
+        static const size_t ID_SIZE = 8;                      // CDP DUID
+        static const size_t HISTORY = 5;                      // readings per window, as on the MamaDuck
+        static const size_t CONTEXT = 3;                      // recent scores a verdict averages
+        static const uint32_t SENSE_INTERVAL = 10000;         // MamaDuck sensing cycle
+        static const uint32_t STALE_AFTER = 600000;           // 10 minutes of silence restarts a window
+        static const uint32_t REORDER = 64;                   // readings a late one may trail; further back is a reboot
+        static const uint8_t CONFIRM_SCORE = 50;              // % of trees voting fire
+        static const uint8_t VETO_SCORE = 35;                 // below the NoFire exports' edge alerts
+    };
+
+    // Spatial confirmation of fire alerts across neighbouring MamaDucks
+    struct FusionConfig {
+        static const bool ENABLED = true;
+        static const size_t NODES = MemoryConfig::DEVICES;    // devices tracked at once, ~100 bytes each
+        static const size_t ID_SIZE = 8;                      // CDP DUID
+        static const size_t GRID_BUCKETS = 256;               // power of two, spatial hash of RADIUS cells
+        static const uint32_t RADIUS = 300;                   // m, neighbours that can corroborate an alert
+        static const uint32_t WINDOW = 660000;                // a node's last reading stands: MamaDuck heartbeat + 1 minute
+        static const uint32_t CLEAR_AFTER = 900000;           // 15 minutes without alerts ends an incident
+        static const uint8_t CONFIRM_SCORE = 70;              // points, see PapaFusion.h
+        static const uint8_t FIRE_POINTS = 40;
+        static const uint8_t TREND_POINTS = 20;
+        static const uint8_t STREAK_POINTS = 10;              // per STREAK_STEP of alerting
+        static const uint32_t STREAK_STEP = 10000;            // MamaDuck sensing cycle
+        static const uint8_t MAX_STREAK_POINTS = 40;          // an isolated node confirms after 30 s of alerts
+        static const uint8_t NEIGHBOUR_POINTS = 60;
+        static const uint8_t QUIET_POINTS = 10;               // per neighbour that sees nothing
+        static const uint8_t MAX_QUIET_POINTS = 30;
+        static constexpr float TEMP_RISE = 30.0f;             // degC per hour for full trend points
+        static constexpr float GAS_DROP = 2.0f;               // gas resistance lost per hour for full trend points
+        static constexpr float SMOOTHING = 0.25f;             // weight of the newest rate
+    };
+
+    // Prometheus page on the local network and MQTT health fallback
+    struct MetricsConfig {
+        static const bool HTTP = true;                        // serve GET /metrics
+        static const uint16_t PORT = 9100;
+        static const size_t PAGE_SIZE = 12 * 1024;            // rendered page, static
+        static const size_t REQUEST_LINE = 64;                // bytes of the request line kept
+        static const uint32_t REQUEST_TIMEOUT = 500;          // ms for a client to send its request
+        static const uint32_t HEALTH_INTERVAL = 60000;        // 1 minute, skipped while the page is scraped
+    };
+
+    // MQTT transport: TLS session resumption and a persistent MQTT session
+    struct TlsConfig {
+        static const size_t SESSION_SIZE = 2048;              // serialized session kept in RTC memory
+        static const size_t RX_BUFFER = 512;                  // decrypted bytes waiting for PubSubClient
+        static const bool CLEAN_SESSION = false;              // broker keeps subscriptions across reconnects
+        static const uint8_t COMMAND_QOS = 1;                 // commands queued while offline are delivered
+    };
+};
+
+#endif // PAPA_CONFIG_H
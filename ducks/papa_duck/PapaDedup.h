@@ -0,0 +1,119 @@
+#ifndef PAPA_DEDUP_H
+#define PAPA_DEDUP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "PapaConfig.h"
+
+// Fixed-memory duplicate filter keyed on (sduid, muid).
+//
+// CDP floods every packet through the mesh, so the gateway can hear the
+// same message once per relay. Each (sduid, muid) is hashed to 64 bits:
+// the low bits pick a home slot, the high 32 bits are kept as the
+// fingerprint with a 16-bit seconds timestamp. Lookups probe a short run
+// of slots; entries older than the retention window count as free. When
+// every slot in the run is live, the oldest is evicted, which can only
+// let a late duplicate through, never drop a new message. A new message
+// is wrongly called a duplicate only if its fingerprint matches a live
+// entry in its run, about PROBE * load / 2^32 per lookup.
+namespace PapaDedup {
+
+using PapaConfig::DedupConfig;
+
+struct Stats {
+    uint32_t lookups;
+    uint32_t duplicates;
+    uint32_t evictions;   // live entries displaced before their window ended
+};
+
+inline uint64_t hashKey(const uint8_t* sduid, size_t sduidLength, const uint8_t* muid, size_t muidLength) {
+    // FNV-1a 64 with a final avalanche so the index bits are well mixed
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < sduidLength; i++) {
+        h = (h ^ sduid[i]) * 0x100000001B3ULL;
+    }
+    h = (h ^ 0xFF) * 0x100000001B3ULL;  // separator, so "AB"+"C" != "A"+"BC"
+    for (size_t i = 0; i < muidLength; i++) {
+        h = (h ^ muid[i]) * 0x100000001B3ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h;
+}
+
+template <size_t N = DedupConfig::CAPACITY>
+class Filter {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "Filter capacity must be a power of two");
+    static_assert(DedupConfig::PROBE <= N, "Probe run longer than the table");
+
+private:
+    uint32_t fingerprints[N];  // 0 marks an empty slot
+    uint16_t stamps[N];        // seconds, wrapping
+    uint16_t window;
+    Stats stats;
+
+    bool live(size_t slot, uint16_t now) const {
+        return fingerprints[slot] && (uint16_t)(now - stamps[slot]) < window;
+    }
+
+public:
+    Filter() : window(DedupConfig::WINDOW), stats() {
+        clear();
+    }
+
+    // Retention in seconds, at most half the 16-bit stamp range
+    void begin(uint16_t windowSeconds = DedupConfig::WINDOW) {
+        window = windowSeconds > 0x7FFF ? 0x7FFF : windowSeconds;
+        clear();
+    }
+
+    void clear() {
+        for (size_t i = 0; i < N; i++) {
+            fingerprints[i] = 0;
+            stamps[i] = 0;
+        }
+    }
+
+    // True if the key was seen within the window; records it otherwise
+    bool seen(uint64_t key, uint32_t nowMs) {
+        stats.lookups++;
+        uint16_t now = (uint16_t)(nowMs / 1000);
+        uint32_t fingerprint = (uint32_t)(key >> 32);
+        if (fingerprint == 0) fingerprint = 1;
+        size_t home = (size_t)key & (N - 1);
+        size_t free = N, oldest = home;
+        for (size_t i = 0; i < DedupConfig::PROBE; i++) {
+            size_t slot = (home + i) & (N - 1);
+            if (!live(slot, now)) {
+                if (free == N) free = slot;
+                continue;
+            }
+            if (fingerprints[slot] == fingerprint) {
+                stats.duplicates++;
+                return true;
+            }
+            if ((uint16_t)(now - stamps[slot]) > (uint16_t)(now - stamps[oldest])) oldest = slot;
+        }
+        if (free == N) {
+            free = oldest;
+            stats.evictions++;
+        }
+        fingerprints[free] = fingerprint;
+        stamps[free] = now;
+        return false;
+    }
+
+    bool seen(const uint8_t* sduid, size_t sduidLength, const uint8_t* muid, size_t muidLength, uint32_t nowMs) {
+        return seen(hashKey(sduid, sduidLength, muid, muidLength), nowMs);
+    }
+
+    uint16_t retention() const { return window; }
+    static size_t capacity() { return N; }
+    static size_t memoryBytes() { return N * (sizeof(uint32_t) + sizeof(uint16_t)); }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaDedup
+
+#endif // PAPA_DEDUP_H
@@ -5,17 +5,20 @@
  *
  * This example will configure and run a Papa Duck that connects to the cloud
  * and forwards all messages (except  pings) to the cloud. When disconnected
- * it will add received packets to a queue. When it reconnects to MQTT it will
- * try to publish all messages in the queue. You can change the size of the queue
- * by changing `QUEUE_SIZE_MAX`.
+ * it appends received packets to a store-and-forward log in the `duckstore`
+ * flash partition, which survives reboots. Once MQTT is back the backlog is
+ * drained oldest first, rate limited by `PapaConfig::StoreConfig`. Without
+ * the partition it falls back to a small RAM queue. Gateway counters and
+ * latency histograms are served as a Prometheus page on the local network
+ * and published on evt/gateway while nobody scrapes it
+ * (`PapaConfig::MetricsConfig`).
  *
  * @date 2024-04-29
  *
  */
 
-#include <ArduinoJson.h>
 #include <PubSubClient.h>
-#include <WiFiClientSecure.h>
+#include <WiFi.h>
 #include <arduino-timer.h>
 #include <string>
 #include "FastLED.h"
@@ -26,6 +29,22 @@
 #include <queue>
 
 #include "secrets.h"
+#include "DuckPayload.h"
+#include "DuckBatch.h"
+#include "PapaConfig.h"
+#include "PapaStore.h"
+#include "PapaJson.h"
+#include "PapaPublish.h"
+#include "PapaLink.h"
+#include "PapaQueue.h"
+#include "PapaDedup.h"
+#include "PapaSummary.h"
+#include "PapaSequence.h"
+#include "PapaInference.h"
+#include "PapaFusion.h"
+#include "PapaMetrics.h"
+#include "PapaTls.h"
+#include <atomic>
 
 // Setup for W2812 (LED)
 #define LED_TYPE WS2812
@@ -53,6 +72,7 @@ char authMethod[] = "use-token-auth";
 const char commandTopic[] = "iot-2/cmd/+/fmt/+";
 
 void gotMsg(char* topic, byte* payload, unsigned int payloadLength);
+bool subscribeTo(const char* topic);
 
 // Use pre-built papa duck
 PapaDuck duck;
@@ -63,63 +83,231 @@ bool use_auth_method = true;
 
 auto timer = timer_create_default();
 
-int QUEUE_SIZE_MAX = 5;
+using PapaConfig::StoreConfig;
+
+const size_t QUEUE_SIZE_MAX = StoreConfig::RAM_QUEUE_MAX;
 std::queue<std::vector<byte>> packetQueue;
 
-WiFiClientSecure wifiClient;
+PapaStore::PartitionFlash storeFlash;
+PapaStore::RingLog store;
+uint32_t lastDrain = 0;
+uint32_t lastStoreStats = 0;
+
+// Radio task (loop) and publish task hand-off. handleDuckData only copies
+// the packet into rxRing, so a slow TLS write or store append never holds
+// up duck.run(). Cloud commands go the other way, since only the radio
+// task may transmit.
+using PapaConfig::TaskConfig;
+PapaQueue::PacketRing<TaskConfig::PACKET_SLOTS, TaskConfig::PACKET_SIZE> rxRing;
+PapaQueue::PacketRing<TaskConfig::COMMAND_SLOTS, TaskConfig::COMMAND_SIZE> commandRing;
+TaskHandle_t publishTask = NULL;
+StaticTask_t publishTaskBuffer;
+StackType_t publishTaskStack[TaskConfig::PUBLISH_STACK_SIZE];
+uint32_t lastQueueStats = 0;
+
+// Drops copies of a flooded message heard through several relays; only the
+// publish task uses it
+PapaDedup::Filter<> dedup;
+
+// Sequence tracking for MamaDuck telemetry (publish task) and the acks it
+// hands to the radio task: a slot holds the destination DUID and the ack
+using PapaConfig::SequenceConfig;
+PapaSequence::Table<> sequences;
+PapaQueue::PacketRing<SequenceConfig::ACK_SLOTS, SequenceConfig::ID_SIZE + DuckSequence::ACK_SIZE> ackRing;
+
+// Per-device rolling stats of the live readings, published on evt/summary
+// every SummaryConfig::INTERVAL; publish task only
+PapaSummary::Table<> summaries;
+
+// Per-device feature windows for re-scoring live readings with the gateway
+// ensemble; publish task only
+using PapaConfig::InferenceConfig;
+PapaInference::Table<> inference;
+
+// Node positions and recent alerts for confirming fire across neighbours;
+// publish task only
+using PapaConfig::FusionConfig;
+PapaFusion::Table<> fusion;
+
+// Counters and histograms from every task; the page and the health
+// message are rendered by the publish task
+using PapaConfig::MetricsConfig;
+PapaMetrics::Metrics metrics;
+WiFiServer metricsServer(MetricsConfig::PORT);
+WiFiClient metricsClient;
+char metricsRequest[MetricsConfig::REQUEST_LINE];
+size_t metricsRequestLength = 0;
+uint32_t metricsAcceptedAt = 0;
+uint32_t lastScrape = 0;
+uint32_t lastHealth = 0;
+static char metricsPage[MetricsConfig::PAGE_SIZE];
+
+// Forwarding path buffers, reused for every message
+static char jsonBuffer[PapaJson::BUFFER_SIZE];
+PapaJson::Topic evtTopic;
+
+// Gateway verdicts on one reading. A packet that could not be published is
+// stored with those of its readings, so the drained messages carry what the
+// live ones would have; publish task only
+struct Annotation {
+  uint8_t verdict;    // PapaInference::Verdict
+  uint8_t score;
+  int16_t fusion;
+  uint32_t incident;
+};
+static Annotation annotations[DuckBatch::MAX_READINGS];
+static const Annotation NO_VERDICT = {(uint8_t)PapaInference::Verdict::UNSCORED, 0, -1, 0};
+
+// How far quackJson got with a packet: readings before next are published,
+// readings before annotated have their verdicts in annotations
+struct Progress {
+  uint8_t next;
+  uint8_t annotated;
+};
+
+// TLS transport that resumes the last broker session instead of a full
+// handshake; the session survives resets and deep sleep in RTC memory
+RTC_NOINIT_ATTR PapaTls::SessionBlob tlsSession;
+PapaTls::TlsClient wifiClient;
 PubSubClient client(AWS_IOT_ENDPOINT, 8883, gotMsg, wifiClient);
 
-// / DMS locator URL requires a topicString, so we need to convert the topic
-// from the packet to a string based on the topics code
-std::string toTopicString(byte topic) {
+// Connection manager. The MQTT connect runs in connectTask so the publish
+// task keeps draining rxRing through the TLS handshake; connectTask only
+// touches the client while the manager is in MQTT_CONNECTING, the publish
+// task only while it is ONLINE.
+TaskHandle_t connectTask = NULL;
+std::atomic<int8_t> mqttConnectResult(-1);
+
+class LinkHooks : public PapaLink::Link {
+public:
+  bool wifiConnected() override { return WiFi.status() == WL_CONNECTED; }
+  void wifiBegin() override {
+    Serial.println((std::string("[PAPA] WiFi disconnected, reconnecting to local network: ") + duck.getSsid()).c_str());
+    WiFi.begin(duck.getSsid().c_str(), duck.getPassword().c_str());
+  }
+  void mqttStart() override {
+    Serial.print("[PAPA] Reconnecting MQTT client to "); Serial.println(AWS_IOT_ENDPOINT);
+    mqttConnectResult = -1;
+    xTaskNotifyGive(connectTask);
+  }
+  int8_t mqttResult() override { return mqttConnectResult; }
+  bool mqttConnected() override { return client.connected(); }
+  void mqttStop() override { client.disconnect(); }
+  bool subscribe() override { return subscribeTo(commandTopic); }
+};
+
+LinkHooks linkHooks;
+PapaLink::Manager uplink;
+
+void connectTaskMain(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    // A persistent session keeps the command subscription and its QoS1
+    // messages on the broker while the gateway is offline
+    uint32_t start = micros();
+    bool connected = client.connect(THINGNAME, NULL, NULL, NULL, 0, false, NULL,
+                                    PapaConfig::TlsConfig::CLEAN_SESSION);
+    metrics.connectTime.record(micros() - start);
+    (connected ? metrics.connects : metrics.connectFailures).add();
+    mqttConnectResult = connected ? 1 : 0;
+  }
+}
 
-  std::string topicString;
+// Publisher transport. Frames go straight to the TLS client next to
+// PubSubClient; a short write drops the session so the buffered frames
+// are written whole on the next one.
+class ClientSink : public PapaPublish::Sink {
+public:
+  size_t write(const uint8_t* data, size_t length) override {
+    if (!uplink.online()) {
+      return 0;
+    }
+    size_t written = wifiClient.write(data, length);
+    if (written != length) {
+      wifiClient.stop();
+    }
+    return written;
+  }
+};
+
+ClientSink publishSink;
+PapaPublish::Publisher publisher(&publishSink);
 
+// Every statically allocated gateway region, reported at boot. The TLS
+// session lives in RTC memory and is not counted.
+using PapaConfig::MemoryConfig;
+
+struct MemoryRegion {
+  const char* name;
+  size_t size;
+};
+
+template <size_t N>
+constexpr size_t totalRegionSize(const MemoryRegion (&regions)[N], size_t i = 0) {
+  return i < N ? regions[i].size + totalRegionSize(regions, i + 1) : 0;
+}
+
+constexpr MemoryRegion STATIC_REGIONS[] = {
+  {"Packet ring", sizeof(rxRing)},
+  {"Command ring", sizeof(commandRing)},
+  {"Publish task stack", sizeof(publishTaskStack) + sizeof(publishTaskBuffer)},
+  {"Dedup filter", sizeof(dedup)},
+  {"Sequence table", sizeof(sequences) + sizeof(ackRing)},
+  {"Summary table", sizeof(summaries)},
+  {"Inference table", sizeof(inference)},
+  {"Fusion table", sizeof(fusion)},
+  {"Metrics", sizeof(metrics) + sizeof(metricsPage) + sizeof(metricsRequest)},
+  {"JSON buffer", sizeof(jsonBuffer) + sizeof(evtTopic)},
+  {"Stored verdicts", sizeof(annotations)},
+  {"Publisher", sizeof(publisher)},
+};
+
+static_assert(totalRegionSize(STATIC_REGIONS) <= MemoryConfig::STATIC_RAM_BUDGET,
+              "Static allocations exceed STATIC_RAM_BUDGET");
+
+void printMemoryBudget() {
+  Serial.println("[PAPA] ----- Static memory budget -----");
+  for (size_t i = 0; i < sizeof(STATIC_REGIONS) / sizeof(STATIC_REGIONS[0]); i++) {
+    Serial.printf("[PAPA] %-24s %6u bytes\n", STATIC_REGIONS[i].name, (unsigned)STATIC_REGIONS[i].size);
+  }
+  Serial.printf("[PAPA] %-24s %6u / %u bytes\n", "total", (unsigned)totalRegionSize(STATIC_REGIONS),
+                (unsigned)MemoryConfig::STATIC_RAM_BUDGET);
+  Serial.printf("[PAPA] Heap free after setup: %u bytes\n", (unsigned)ESP.getFreeHeap());
+}
+
+// / DMS locator URL requires a topicString, so we need to convert the topic
+// from the packet to a string based on the topics code
+const char* toTopicString(byte topic) {
   switch (topic) {
     case topics::status:
-      topicString = "status";
-      break;
+      return "status";
     case topics::cpm:
-      topicString = "portal";
-      break;
+      return "portal";
     case topics::sensor:
-      topicString = "sensor";
-      break;
+      return "sensor";
     case topics::alert:
-      topicString = "alert";
-      break;
+      return "alert";
     case topics::location:
-      topicString = "gps";
-      break;
+      return "gps";
     case topics::health:
-      topicString = "health";
-      break;
+      return "health";
     case topics::bmp180:
-      topicString = "bmp180";
-      break;
+      return "bmp180";
     case topics::pir:
-      topicString = "pir";
-      break;
+      return "pir";
     case topics::dht11:
-      topicString = "dht";
-      break;
+      return "dht";
     case topics::bmp280:
-      topicString = "bmp280";
-      break;
+      return "bmp280";
     case topics::mq7:
-      topicString = "mq7";
-      break;
+      return "mq7";
     case topics::gp2y:
-      topicString = "gp2y";
-      break;
+      return "gp2y";
     case reservedTopic::ack:
-      topicString = "ack";
-      break;
+      return "ack";
     default:
-      topicString = "status";
+      return "status";
   }
-
-  return topicString;
 }
 
 std::string convertToHex(byte* data, int size) {
@@ -134,74 +322,559 @@ std::string convertToHex(byte* data, int size) {
   return buf;
 }
 
-// WiFi connection retry
-bool retry = true;
-int quackJson(CdpPacket packet) {
+// Hands the message serialized in jsonBuffer to the publisher; returns 0
+// once it is buffered, -1 on failure. Urgent messages are written at once.
+int publishJson(const char* topic, size_t length, bool urgent) {
+  if (length == 0) {
+    Serial.println("[PAPA] Message too large, dropped");
+    metrics.publishFailures.add();
+    return -1;
+  }
+  if (uplink.online() && publisher.publish(topic, jsonBuffer, length, millis(), urgent)) {
+    metrics.published.add();
+#ifdef PAPA_DEBUG
+    Serial.print("[PAPA] Packet forwarded: ");
+    Serial.println(jsonBuffer);
+#endif
+    return 0;
+  } else {
+    Serial.println("[PAPA] Publish failed");
+    metrics.publishFailures.add();
+    return -1;
+  }
+}
 
-  JsonDocument doc;
+#ifdef PAPA_DEBUG
+void printField(const char* label, const std::vector<byte>& field) {
+  Serial.print(label);
+  Serial.write(field.data(), field.size());
+  Serial.println();
+}
+#endif
+
+// Forwards a packet without heap allocations: the JSON is written from
+// the packet's byte spans into jsonBuffer and the topic reuses a prefix
+// built once in setup(). Live packets are re-scored and fused on the way,
+// with the verdicts kept in annotations; the stored backlog gets back the
+// ones stored with it. A batch is published from progress.next on and
+// stops at the first failure, leaving next at the first reading still to
+// publish; a live one is still scored to the end.
+int quackJson(const CdpPacket& packet, bool live, Progress& progress) {
+
+#ifdef PAPA_DEBUG
+  Serial.println("[PAPA] Packet Received:");
+  printField("[PAPA] sduid:   ", packet.sduid);
+  printField("[PAPA] dduid:   ", packet.dduid);
+  printField("[PAPA] muid:    ", packet.muid);
+  printField("[PAPA] path:    ", packet.path);
+  printField("[PAPA] data:    ", packet.data);
+  Serial.println("[PAPA] hops:    " + String(packet.hopCount));
+  Serial.println("[PAPA] duck:    " + String(packet.duckType));
+#endif
+
+  const uint8_t* data = packet.data.data();
+  size_t size = packet.data.size();
+  uint16_t sequence;
+  bool sequenced = DuckSequence::unwrap(data, size, sequence);
+
+  PapaJson::Message message = PapaJson::message();
+  message.deviceId = PapaJson::span(packet.sduid.data(), packet.sduid.size());
+  message.messageId = PapaJson::span(packet.muid.data(), packet.muid.size());
+  message.path = PapaJson::span(packet.path.data(), packet.path.size());
+  message.payload = PapaJson::span(data, size);
+  message.hops = packet.hopCount;
+  message.duckType = packet.duckType;
+  message.sequence = sequenced ? sequence : -1;
+
+  // The topic is built at each publish: paging an incident reuses evtTopic
+  const char* topicName = toTopicString(packet.topic);
+  bool urgent = packet.topic == topics::alert;
+
+  DuckPayload::Reading reading;
+  char text[DuckPayload::TEXT_SIZE];
+  if (packet.topic != topics::health && DuckBatch::isBatch(data, size)) {
+    // Unpack a time-series batch into one message per reading. MessageID
+    // gets the reading index so each stays unique; age is seconds before
+    // the newest reading in the batch.
+    DuckBatch::Decoder decoder(data, size);
+    DuckBatch::Entry entry;
+    uint8_t count = 0;
+    uint32_t newest = 0;
+    while (decoder.next(entry)) {
+      newest = entry.timestamp;
+      count++;
+    }
+    if (count != decoder.count()) {
+      Serial.println("[PAPA] Truncated batch, forwarding " + String(count) + " of " + String(decoder.count()));
+    }
+    int result = 0;
+    DuckBatch::Decoder readings(data, size);
+    for (uint8_t i = 0; i < count && readings.next(entry); i++) {
+      if (i < progress.next) {
+        continue;  // published before the packet was stored
+      }
+      DuckBatch::toReading(entry, reading);
+      message.readingIndex = i;
+      message.ageTenths = newest - entry.timestamp;
+      if (live) {
+        evaluate(packet, reading, message, annotations[i]);
+        progress.annotated = i + 1;
+      } else {
+        annotate(i < progress.annotated ? annotations[i] : NO_VERDICT, message);
+      }
+      if (result != 0) {
+        continue;
+      }
+      int length = DuckPayload::toText(reading, text, sizeof(text));
+      message.payload = PapaJson::span((const uint8_t*)text, length > 0 ? strnlen(text, sizeof(text)) : 0);
+      size_t json = PapaJson::serialize(message, jsonBuffer, sizeof(jsonBuffer));
+      if (publishJson(evtTopic.with(topicName), json, urgent) != 0) {
+        result = -1;
+        if (!live) {
+          break;
+        }
+        continue;
+      }
+      progress.next = i + 1;
+    }
+    return result;
+  }
 
-  std::string payload(packet.data.begin(), packet.data.end());
-  std::string sduid(packet.sduid.begin(), packet.sduid.end());
-  std::string dduid(packet.dduid.begin(), packet.dduid.end());
+  if (packet.topic == topics::health) {
+    // MamaDuck health reports are binary, forward them hex encoded
+    message.hexPayload = true;
+  } else if (DuckPayload::decode(data, size, reading)) {
+    // Expand binary telemetry back into the text form the dashboard parses
+    int length = DuckPayload::toText(reading, text, sizeof(text));
+    message.payload = PapaJson::span((const uint8_t*)text, length > 0 ? strnlen(text, sizeof(text)) : 0);
+    if (live) {
+      evaluate(packet, reading, message, annotations[0]);
+      progress.annotated = 1;
+    } else if (progress.annotated > 0) {
+      annotate(annotations[0], message);
+    }
+    if (progress.annotated > 0 && held(annotations[0])) {
+      // Vetoed alerts, and alerts no incident confirms yet, go out as
+      // ordinary telemetry
+      topicName = toTopicString(topics::location);
+      urgent = false;
+    }
+  }
 
-  std::string muid(packet.muid.begin(), packet.muid.end());
-  std::string path(packet.path.begin(), packet.path.end());
+  return publishJson(evtTopic.with(topicName), PapaJson::serialize(message, jsonBuffer, sizeof(jsonBuffer)), urgent);
+}
 
-  Serial.println("[PAPA] Packet Received:");
-  Serial.println("[PAPA] sduid:   " + String(sduid.c_str()));
-  Serial.println("[PAPA] dduid:   " + String(dduid.c_str()));
+// Radio task: hands the packet to the publish task
+void handleDuckData(std::vector<byte> packetBuffer) {
+#ifdef PAPA_DEBUG
+  Serial.println((std::string("[PAPA] got packet: ") + convertToHex(packetBuffer.data(), packetBuffer.size())).c_str());
+#endif
+
+  uint32_t start = micros();
+  metrics.received.add();
+  if (!rxRing.push(packetBuffer.data(), packetBuffer.size())) {
+    metrics.receiveDrops.add();
+    Serial.println("[PAPA] Receive queue full, packet dropped");
+    return;
+  }
+  xTaskNotifyGive(publishTask);
+  metrics.receiveTime.record(micros() - start);
+}
 
-  Serial.println("[PAPA] muid:    " + String(muid.c_str()));
-  Serial.println("[PAPA] path:    " + String(path.c_str()));
-  Serial.println("[PAPA] data:    " + String(payload.c_str()));
-  Serial.println("[PAPA] hops:    " + String(packet.hopCount));
-  Serial.println("[PAPA] duck:    " + String(packet.duckType));
+// Publish task: converts a received packet to JSON and sends it out over
+// WiFi, or stores it
+void forwardPacket(const uint8_t* data, size_t length) {
+  std::vector<byte> packetBuffer(data, data + length);
+  CdpPacket packet = CdpPacket(packetBuffer);
+  DuckSequence::Ack relayedAck;
+  if (DuckSequence::decodeAck(packet.data.data(), packet.data.size(), relayedAck)) {
+    // One of our own acks coming back through a relay
+    return;
+  }
+  if(packet.topic != reservedTopic::ack) {
+    if (dedup.seen(packet.sduid.data(), packet.sduid.size(), packet.muid.data(), packet.muid.size(), millis())) {
+#ifdef PAPA_DEBUG
+      Serial.println("[PAPA] Duplicate packet dropped");
+#endif
+      return;
+    }
+    // Sequenced MamaDuck telemetry is acked once it is published or in
+    // the flash store; a resend of a packet already forwarded is only
+    // acked again
+    uint16_t sequence;
+    bool sequenced = sequenceOf(packet, sequence);
+    DuckSequence::Ack ack;
+    if (sequenced && sequences.received(packet.sduid.data(), packet.sduid.size(), sequence, ack)) {
+#ifdef PAPA_DEBUG
+      Serial.println("[PAPA] Resent packet already forwarded, acked again");
+#endif
+      queueAck(packet, ack);
+      return;
+    }
+    summarize(packet);
+    uint32_t start = micros();
+    Progress progress = {0, 0};
+    int result = quackJson(packet, true, progress);
+    metrics.forwardTime.record(micros() - start);
+    bool kept = result == 0;
+    if(result == 0) {
+      metrics.forwarded.add();
+    } else if(result == -1) {
+      metrics.stored.add();
+      kept = storePacket(packetBuffer.data(), packetBuffer.size(), progress);
+    }
+    if (sequenced && kept) {
+      sequences.receive(packet.sduid.data(), packet.sduid.size(), sequence, millis(), ack);
+      queueAck(packet, ack);
+    }
+  }
+}
+
+// Sequence number of MamaDuck telemetry; false for packets without one,
+// which are not acked
+bool sequenceOf(const CdpPacket& packet, uint16_t& sequence) {
+  const uint8_t* data = packet.data.data();
+  size_t size = packet.data.size();
+  return DuckSequence::unwrap(data, size, sequence) && packet.sduid.size() == SequenceConfig::ID_SIZE;
+}
 
-  doc["DeviceID"] = sduid;
-  doc["MessageID"] = muid;
-  doc["Payload"].set(payload);
-  doc["path"].set(path);
-  doc["hops"].set(packet.hopCount);
-  doc["duckType"].set(packet.duckType);
+// Hands an ack for the packet's sender to the radio task
+void queueAck(const CdpPacket& packet, const DuckSequence::Ack& ack) {
+  uint8_t slot[SequenceConfig::ID_SIZE + DuckSequence::ACK_SIZE];
+  memcpy(slot, packet.sduid.data(), SequenceConfig::ID_SIZE);
+  DuckSequence::encodeAck(ack, slot + SequenceConfig::ID_SIZE, DuckSequence::ACK_SIZE);
+  if (!ackRing.push(slot, sizeof(slot))) {
+    Serial.println("[PAPA] Ack queue full, ack dropped");
+  }
+}
 
-  std::string cdpTopic = toTopicString(packet.topic);
+// Adds the readings a live packet carries to its device's summary. The
+// stored backlog is not summarized again when it drains.
+void summarize(const CdpPacket& packet) {
+  if (packet.topic == topics::health || packet.data.empty()) {
+    return;
+  }
+  const uint8_t* data = packet.data.data();
+  size_t size = packet.data.size();
+  uint16_t sequence;
+  DuckSequence::unwrap(data, size, sequence);
+  uint32_t now = millis();
+  DuckPayload::Reading reading;
+  if (DuckBatch::isBatch(data, size)) {
+    DuckBatch::Decoder decoder(data, size);
+    DuckBatch::Entry entry;
+    while (decoder.next(entry)) {
+      DuckBatch::toReading(entry, reading);
+      summaries.add(packet.sduid.data(), packet.sduid.size(), reading, now);
+    }
+    return;
+  }
+  if (!DuckPayload::decode(data, size, reading)) {
+    char text[DuckPayload::TEXT_SIZE];
+    size_t length = size < sizeof(text) ? size : sizeof(text) - 1;
+    memcpy(text, data, length);
+    text[length] = '\0';
+    if (!DuckPayload::fromText(text, reading)) {
+      return;
+    }
+  }
+  summaries.add(packet.sduid.data(), packet.sduid.size(), reading, now);
+}
 
-  std::string topic = "owl/device/" + std::string(THINGNAME) + "/evt/" + cdpTopic;
+// Gateway time a live reading was sensed: its arrival, less its age in a batch
+uint32_t sensedAt(const PapaJson::Message& message, uint32_t now) {
+  return message.ageTenths > 0 ? now - (uint32_t)message.ageTenths * 100 : now;
+}
 
-  String jsonstat;
-  serializeJson(doc, jsonstat);
+// Re-scores and fuses a live reading, noting the results on its message
+// and in note
+void evaluate(const CdpPacket& packet, const DuckPayload::Reading& reading, PapaJson::Message& message,
+              Annotation& note) {
+  PapaInference::Verdict verdict = rescore(packet, reading, message);
+  bool kept = verdict != PapaInference::Verdict::VETOED || !InferenceConfig::VETO;
+  fuse(packet, reading, reading.prediction == 1 && kept, message);
+  note.verdict = (uint8_t)verdict;
+  note.score = message.score;
+  note.fusion = message.fusion;
+  note.incident = message.incident;
+}
 
-  if (client.publish(topic.c_str(), jsonstat.c_str())) {
-    Serial.println("[PAPA] Packet forwarded:");
-    serializeJsonPretty(doc, Serial);
-    Serial.println("");
-    Serial.println("[PAPA] Publish ok");
-    return 0;
+// Puts the verdicts stored with a reading back on its message
+void annotate(const Annotation& note, PapaJson::Message& message) {
+  PapaInference::Verdict verdict = (PapaInference::Verdict)note.verdict;
+  message.verdict = verdict == PapaInference::Verdict::UNSCORED ? NULL : PapaInference::verdictName(verdict);
+  message.score = note.score;
+  message.fusion = note.fusion;
+  message.incident = note.incident;
+}
+
+// An edge alert the gateway vetoed, or a fire alert no incident confirms yet
+bool held(const Annotation& note) {
+  bool vetoed = InferenceConfig::VETO && note.verdict == (uint8_t)PapaInference::Verdict::VETOED;
+  return vetoed || (note.fusion >= 0 && note.incident == 0);
+}
+
+// Scores a live reading with the gateway ensemble and notes the verdict on
+// its message; UNSCORED while its device's window fills or when disabled
+PapaInference::Verdict rescore(const CdpPacket& packet, const DuckPayload::Reading& reading,
+                               PapaJson::Message& message) {
+  message.verdict = NULL;
+  if (!InferenceConfig::ENABLED) {
+    return PapaInference::Verdict::UNSCORED;
+  }
+  uint8_t score = 0;
+  uint32_t now = millis();
+  PapaInference::Verdict verdict = inference.score(packet.sduid.data(), packet.sduid.size(), reading,
+                                                   sensedAt(message, now), now, score);
+  if (verdict == PapaInference::Verdict::UNSCORED) {
+    return verdict;
+  }
+  message.verdict = PapaInference::verdictName(verdict);
+  message.score = score;
+#ifdef PAPA_DEBUG
+  if (verdict == PapaInference::Verdict::VETOED || verdict == PapaInference::Verdict::RAISED) {
+    Serial.printf("[PAPA] Gateway model %s reading %u, score %u%%\n", message.verdict, (unsigned)reading.counter,
+                  (unsigned)score);
+  }
+#endif
+  return verdict;
+}
+
+// Adds a live reading to the spatial fusion table and notes its points on
+// the message; false for a fire alert no incident confirms yet. A new
+// incident is paged on evt/incident before the alert itself goes out; if
+// the page cannot be published the incident is withdrawn and the alert
+// held, so the node's next confirmed alert pages it again.
+bool fuse(const CdpPacket& packet, const DuckPayload::Reading& reading, bool fire, PapaJson::Message& message) {
+  if (!FusionConfig::ENABLED) {
+    return true;
+  }
+  uint32_t now = millis();
+  PapaFusion::Assessment assessment = fusion.add(packet.sduid.data(), packet.sduid.size(), reading, fire,
+                                                 sensedAt(message, now), now);
+  message.fusion = assessment.score;
+  message.incident = assessment.incident;
+  if (assessment.paged) {
+    Serial.printf("[PAPA] Incident %u confirmed, %d points, %u alerting neighbours\n", (unsigned)assessment.incident,
+                  assessment.score, (unsigned)assessment.nodes);
+    const PapaFusion::Node* node = fusion.node(packet.sduid.data(), packet.sduid.size());
+    size_t length = node ? PapaFusion::serialize(*node, assessment, jsonBuffer, sizeof(jsonBuffer)) : 0;
+    if (length && publishJson(evtTopic.with("incident"), length, true) != 0) {
+      Serial.printf("[PAPA] Incident %u page failed, held until the next confirmation\n",
+                    (unsigned)assessment.incident);
+      fusion.unpage(packet.sduid.data(), packet.sduid.size());
+      message.incident = 0;
+      return false;
+    }
+  }
+  return assessment.score < 0 || assessment.confirmed;
+}
+
+void publishSummaries(uint32_t now) {
+  const char* topic = evtTopic.with("summary");
+  summaries.flush(now, jsonBuffer, sizeof(jsonBuffer), [topic](const char*, size_t length) {
+    return publishJson(topic, length, false) == 0;
+  });
+}
+
+void printQueueStats() {
+  const PapaQueue::Stats& rx = rxRing.counters();
+  Serial.printf("[PAPA] Receive queue: %u/%u waiting, high water %u, received %u, forwarded %u, overflows %u, oversize %u\n",
+                (unsigned)rxRing.size(), (unsigned)rxRing.capacity(), (unsigned)rx.highWater,
+                (unsigned)rx.pushed, (unsigned)rx.popped, (unsigned)rx.overflows, (unsigned)rx.oversize);
+  const PapaDedup::Stats& dup = dedup.counters();
+  Serial.printf("[PAPA] Dedup: %u lookups, %u duplicates dropped, %u early evictions, %u s window\n",
+                (unsigned)dup.lookups, (unsigned)dup.duplicates, (unsigned)dup.evictions, (unsigned)dedup.retention());
+  const PapaSummary::Stats& sum = summaries.counters();
+  Serial.printf("[PAPA] Summaries: %u/%u devices, %u readings, %u published, %u evictions, %u readings lost\n",
+                (unsigned)summaries.tracked(), (unsigned)summaries.capacity(), (unsigned)sum.readings,
+                (unsigned)sum.summaries, (unsigned)sum.evictions, (unsigned)sum.lostReadings);
+  const PapaSequence::Stats& seq = sequences.counters();
+  Serial.printf("[PAPA] Delivery: %u received, %u resends dropped, %u lost, %u restarts, %u evictions, %u acks dropped\n",
+                (unsigned)seq.packets.received, (unsigned)seq.packets.duplicates, (unsigned)seq.packets.lost,
+                (unsigned)seq.packets.resyncs, (unsigned)seq.evictions, (unsigned)ackRing.counters().overflows);
+  const PapaInference::Stats& inf = inference.counters();
+  Serial.printf("[PAPA] Inference: %u/%u devices, %u scored, %u confirmed, %u uncertain, %u vetoed, %u raised, %u late, %u evictions\n",
+                (unsigned)inference.tracked(), (unsigned)inference.capacity(), (unsigned)inf.scored,
+                (unsigned)inf.confirmed, (unsigned)inf.uncertain, (unsigned)inf.vetoed, (unsigned)inf.raised,
+                (unsigned)inf.late, (unsigned)inf.evictions);
+  const PapaFusion::Stats& fus = fusion.counters();
+  Serial.printf("[PAPA] Fusion: %u/%u nodes, %u alerts, %u confirmed, %u held, %u incidents, %u joined, %u evictions\n",
+                (unsigned)fusion.tracked(), (unsigned)fusion.capacity(), (unsigned)fus.alerts, (unsigned)fus.confirmed,
+                (unsigned)fus.held, (unsigned)fus.incidents, (unsigned)fus.joined, (unsigned)fus.evictions);
+  const PapaTls::Stats& tls = wifiClient.counters();
+  Serial.printf("[PAPA] TLS: %u handshakes, %u resumed, %u sessions saved, %u invalid\n",
+                (unsigned)tls.handshakes, (unsigned)tls.resumed, (unsigned)tls.saved, (unsigned)tls.invalid);
+}
+
+// Values for the page and the health message, sampled on the publish task
+PapaMetrics::Gauges sampleGauges(uint32_t now) {
+  PapaMetrics::Gauges g;
+  g.uptime = now / 1000;
+  g.online = uplink.online();
+  g.sessions = uplink.counters().sessions;
+  g.waiting = rxRing.size();
+  g.queued = packetQueue.size();
+  g.backlog = store.ready() ? store.pending() : 0;
+  g.heap = ESP.getFreeHeap();
+  g.rssi = WiFi.status() == WL_CONNECTED ? WiFi.RSSI() : 0;
+  return g;
+}
+
+// The Prometheus page: the gateway's own metrics, then the counters each
+// component keeps
+size_t renderMetrics(uint32_t now) {
+  PapaMetrics::Page page(metricsPage, sizeof(metricsPage));
+  PapaMetrics::write(page, metrics, sampleGauges(now));
+  const PapaPublish::Stats& pub = publisher.counters();
+  page.counter("papa_publisher_frames_total", "MQTT PUBLISH frames encoded", pub.frames);
+  page.counter("papa_publisher_writes_total", "TLS writes", pub.writes);
+  page.counter("papa_publisher_bytes_total", "Bytes written to the TLS client", pub.bytes);
+  page.counter("papa_publisher_short_writes_total", "Writes that dropped the session", pub.failures);
+  const PapaLink::Stats& link = uplink.counters();
+  page.counter("papa_link_failures_total", "Failed WiFi or MQTT attempts", link.failures);
+  const PapaDedup::Stats& dup = dedup.counters();
+  page.counter("papa_duplicates_total", "Mesh duplicates dropped", dup.duplicates);
+  const PapaSequence::Stats& seq = sequences.counters();
+  page.counter("papa_sequence_resends_total", "Resends of packets already forwarded", seq.packets.duplicates);
+  page.counter("papa_sequence_lost_total", "Sequenced packets never received", seq.packets.lost);
+  page.counter("papa_acks_dropped_total", "Acks refused by a full ack queue", ackRing.counters().overflows);
+  if (store.ready()) {
+    const PapaStore::Stats& st = store.counters();
+    page.gauge("papa_store_fill_ratio", "Share of the store in use", store.fillPercent() / 100.0);
+    page.counter("papa_store_dropped_total", "Unsent records lost to ring overwrite", st.dropped);
+    page.counter("papa_store_corrupt_total", "Records skipped on a CRC mismatch", st.corrupt);
+  }
+  const PapaInference::Stats& inf = inference.counters();
+  page.family("papa_inference_verdicts_total", "counter", "Gateway re-scoring verdicts on edge predictions");
+  page.sample("papa_inference_verdicts_total", "verdict=\"confirmed\"", inf.confirmed);
+  page.sample("papa_inference_verdicts_total", "verdict=\"uncertain\"", inf.uncertain);
+  page.sample("papa_inference_verdicts_total", "verdict=\"vetoed\"", inf.vetoed);
+  page.sample("papa_inference_verdicts_total", "verdict=\"raised\"", inf.raised);
+  const PapaFusion::Stats& fus = fusion.counters();
+  page.counter("papa_fusion_alerts_held_total", "Fire alerts no incident confirmed", fus.held);
+  page.counter("papa_fusion_incidents_total", "Incidents paged", fus.incidents);
+  const PapaTls::Stats& tls = wifiClient.counters();
+  page.family("papa_tls_handshakes_total", "counter", "TLS handshakes");
+  page.sample("papa_tls_handshakes_total", "resumed=\"false\"", tls.handshakes - tls.resumed);
+  page.sample("papa_tls_handshakes_total", "resumed=\"true\"", tls.resumed);
+  return page.finish();
+}
+
+// Local metrics server, polled from the publish task. One client at a
+// time; the request line is collected across polls so a slow client
+// never holds up forwarding.
+void serveMetrics(uint32_t now) {
+  if (!MetricsConfig::HTTP || WiFi.status() != WL_CONNECTED) {
+    return;
+  }
+  if (!metricsClient) {
+    metricsClient = metricsServer.available();
+    if (!metricsClient) {
+      return;
+    }
+    metricsRequestLength = 0;
+    metricsAcceptedAt = now;
+  }
+  bool complete = false;
+  while (metricsClient.available() && !complete) {
+    char c = metricsClient.read();
+    if (c == '\n') {
+      complete = true;
+    } else if (metricsRequestLength + 1 < sizeof(metricsRequest)) {
+      metricsRequest[metricsRequestLength++] = c;
+    }
+  }
+  if (!complete) {
+    if (now - metricsAcceptedAt >= MetricsConfig::REQUEST_TIMEOUT || !metricsClient.connected()) {
+      metricsClient.stop();
+    }
+    return;
+  }
+  metricsRequest[metricsRequestLength] = '\0';
+  size_t length = 0;
+  if (strncmp(metricsRequest, "GET /metrics ", 13) == 0 || strncmp(metricsRequest, "GET / ", 6) == 0) {
+    length = renderMetrics(now);
+  }
+  if (length) {
+    metricsClient.printf("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                         "Content-Length: %u\r\nConnection: close\r\n\r\n", (unsigned)length);
+    metricsClient.write((const uint8_t*)metricsPage, length);
+    lastScrape = now;
   } else {
-    Serial.println("[PAPA] Publish failed");
-    return -1;
+    metricsClient.print(strncmp(metricsRequest, "GET /metrics ", 13) == 0
+                          ? "HTTP/1.1 500 Internal Server Error\r\nConnection: close\r\n\r\n"
+                          : "HTTP/1.1 404 Not Found\r\nConnection: close\r\n\r\n");
   }
+  metricsClient.stop();
 }
 
-// Converts incoming packet to a JSON string, before sending it out over WiFi
-void handleDuckData(std::vector<byte> packetBuffer) {
-  Serial.println((std::string("[PAPA] got packet: ") + convertToHex(packetBuffer.data(), packetBuffer.size())).c_str());
+// Compact health message on evt/gateway for gateways nobody scrapes
+void publishHealth(uint32_t now) {
+  if (!uplink.online() || (MetricsConfig::HTTP && lastScrape && now - lastScrape < MetricsConfig::HEALTH_INTERVAL)) {
+    return;
+  }
+  size_t length = PapaMetrics::serializeHealth(metrics, sampleGauges(now), jsonBuffer, sizeof(jsonBuffer));
+  publishJson(evtTopic.with("gateway"), length, false);
+}
 
-  CdpPacket packet = CdpPacket(packetBuffer);
-  if(packet.topic != reservedTopic::ack) {
-    if(quackJson(packet) == -1) {
-      if(packetQueue.size() > QUEUE_SIZE_MAX) {
-        packetQueue.pop();
-        packetQueue.push(packetBuffer);
-      } else {
-        packetQueue.push(packetBuffer);
+void onLinkState(PapaLink::State state, PapaLink::State previous) {
+  const PapaLink::Stats& stats = uplink.counters();
+  Serial.printf("[PAPA] Link %s -> %s, sessions %u, attempts wifi %u mqtt %u, failures %u\n",
+                PapaLink::stateName(previous), PapaLink::stateName(state), (unsigned)stats.sessions,
+                (unsigned)stats.wifiAttempts, (unsigned)stats.mqttAttempts, (unsigned)stats.failures);
+  if (state == PapaLink::State::ONLINE) {
+    // Turn LED green when connected
+    leds[0] = CRGB::Green;
+    FastLED.show();
+  } else if (previous == PapaLink::State::ONLINE || state == PapaLink::State::WIFI_DOWN) {
+    // Turn LED red when disconnected
+    leds[0] = CRGB::Red;
+    FastLED.show();
+  }
+}
+
+// Owns the MQTT client, the publisher and the store; loop() never touches them
+void publishTaskMain(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TaskConfig::PUBLISH_IDLE));
+
+    PapaLink::State previous = uplink.state();
+    PapaLink::State state = uplink.poll(millis());
+    if (state != previous) {
+      onLinkState(state, previous);
+    }
+
+    const auto* slot = rxRing.front();
+    while (slot) {
+      forwardPacket(slot->data, slot->length);
+      rxRing.pop();
+      slot = rxRing.front();
+    }
+
+    if (state == PapaLink::State::ONLINE) {
+      client.loop();
+      publisher.poll(millis());
+      if (!packetQueue.empty()) {
+        publishQueue();
       }
-      Serial.print("New size of queue: ");
-      Serial.println(packetQueue.size());
+      drainStore();
     }
-  }
 
-  subscribeTo(commandTopic);
+    uint32_t now = millis();
+    if (summaries.due(now)) {
+      publishSummaries(now);
+    }
+    serveMetrics(now);
+    if (now - lastHealth >= MetricsConfig::HEALTH_INTERVAL) {
+      lastHealth = now;
+      publishHealth(now);
+    }
+    if (now - lastQueueStats >= StoreConfig::STATS_INTERVAL) {
+      lastQueueStats = now;
+      printQueueStats();
+    }
+  }
 }
 
 void setup() {
@@ -230,45 +903,99 @@ void setup() {
   FastLED.addLeds<LED_TYPE, DATA_PIN, COLOR_ORDER>(leds, NUM_LEDS).setCorrection( TypicalSMD5050 );
   FastLED.setBrightness(  BRIGHTNESS );
 
+  evtTopic.begin(THINGNAME);
+  summaries.begin(millis());
+  if (MetricsConfig::HTTP) {
+    metricsServer.begin();
+  }
+
+  if (storeFlash.begin("duckstore") && store.begin(storeFlash)) {
+    Serial.println("[PAPA] Store ready, " + String(store.capacity() / 1024) + " KB, backlog: " + String(store.pending()));
+  } else {
+    Serial.println("[PAPA] No duckstore partition, queueing " + String(QUEUE_SIZE_MAX) + " packets in RAM");
+  }
+
+  // Bound a connect attempt to an unreachable broker
+  wifiClient.setHandshakeTimeout(PapaConfig::LinkConfig::SOCKET_TIMEOUT);
+  wifiClient.setSessionStore(tlsSession);
+  client.setSocketTimeout(PapaConfig::LinkConfig::SOCKET_TIMEOUT);
+  xTaskCreatePinnedToCore(connectTaskMain, "mqttConnect", PapaConfig::LinkConfig::CONNECT_STACK_SIZE,
+                          NULL, 1, &connectTask, 0);
+  uplink.begin(linkHooks, esp_random(), millis());
+
+  publishTask = xTaskCreateStaticPinnedToCore(
+    publishTaskMain,
+    "Publish",
+    TaskConfig::PUBLISH_STACK_SIZE,
+    NULL,
+    1,
+    publishTaskStack,
+    &publishTaskBuffer,
+    TaskConfig::PUBLISH_CORE
+  );
+
+  printMemoryBudget();
   Serial.println("[PAPA] Setup OK! ");
 
   duck.enableAcks(true);
 }
 
+// Radio task: receives, relays and sends queued cloud commands
 void loop() {
+   duck.run();
+   sendAcks();
+   sendCommands();
+   timer.tick();
 
-   if (!duck.isWifiConnected() && retry) {
-      std::string ssid = duck.getSsid();
-      std::string password = duck.getPassword();
-
-      Serial.println((std::string("[PAPA] WiFi disconnected, reconnecting to local network: ") + ssid).c_str());
-
-      // Turn LED red when disconnected
-      leds[0] = CRGB::Red;
-      FastLED.show();
-
-      int err = duck.reconnectWifi(ssid, password);
+}
 
-      if (err != DUCK_ERR_NONE) {
-         retry = false;
-      }
-      timer.in(5000, enableRetry);
-   }
-
-   if (!client.loop()) {
-     if(duck.isWifiConnected()) {
-        
-        // Turn LED green when connected
-        leds[0] = CRGB::Green;
-        FastLED.show();
-        
-        mqttConnect();
-     }
-   }
+// Radio task: transmits the acks forwardPacket queued, each addressed to
+// the MamaDuck that sent the packet
+void sendAcks() {
+  const auto* slot = ackRing.front();
+  while (slot) {
+    std::array<byte, SequenceConfig::ID_SIZE> destination;
+    std::copy_n(slot->data, SequenceConfig::ID_SIZE, destination.begin());
+    // The ack magic byte, not the topic, marks the payload for the MamaDuck
+    duck.sendData(topics::status, slot->data + SequenceConfig::ID_SIZE, DuckSequence::ACK_SIZE, destination);
+    ackRing.pop();
+    slot = ackRing.front();
+  }
+}
 
-   duck.run();
-   timer.tick();
+// Radio task: transmits the commands gotMsg queued. A slot holds the
+// command, its value byte and the optional destination DUID.
+void sendCommands() {
+  const auto* slot = commandRing.front();
+  while (slot) {
+    byte sCmd = slot->data[0];
+    std::vector<byte> sValue = {slot->data[1]};
+    if (slot->length > 2) {
+      std::vector<byte> dDevId(slot->data + 2, slot->data + slot->length);
+      duck.sendCommand(sCmd, sValue, dDevId);
+    } else {
+      duck.sendCommand(sCmd, sValue);
+    }
+    commandRing.pop();
+    slot = commandRing.front();
+  }
+}
 
+// Publish task: hands a command to the radio task
+void queueCommand(byte sCmd, byte sValue, const byte* destination, size_t destinationLength) {
+  byte command[TaskConfig::COMMAND_SIZE];
+  if (destinationLength > sizeof(command) - 2) {
+    Serial.println("[PAPA] Command destination too long");
+    return;
+  }
+  command[0] = sCmd;
+  command[1] = sValue;
+  if (destinationLength) {
+    memcpy(command + 2, destination, destinationLength);
+  }
+  if (!commandRing.push(command, destinationLength + 2)) {
+    Serial.println("[PAPA] Command queue full, command dropped");
+  }
 }
 
 void gotMsg(char* topic, byte* payload, unsigned int payloadLength) {
@@ -277,35 +1004,16 @@ void gotMsg(char* topic, byte* payload, unsigned int payloadLength) {
   if (String(topic).indexOf(CMD_STATE_WIFI) > 0) {
     Serial.println("Start WiFi Command");
     byte sCmd = 1;
-    std::vector<byte> sValue = {payload[0]};
 
     if(payloadLength > 3) {
-      std::string destination = "";
-      for (int i=1; i<payloadLength; i++) {
-        destination += (char)payload[i];
-      }
-
-      std::vector<byte> dDevId;
-      dDevId.insert(dDevId.end(),destination.begin(),destination.end());
-
-      duck.sendCommand(sCmd, sValue, dDevId);
+      queueCommand(sCmd, payload[0], payload + 1, payloadLength - 1);
     } else {
-      duck.sendCommand(sCmd, sValue);
+      queueCommand(sCmd, payload[0], NULL, 0);
     }
   } else if (String(topic).indexOf(CMD_STATE_HEALTH) > 0) {
     byte sCmd = 0;
-    std::vector<byte> sValue = {payload[0]};
     if(payloadLength >= 8) {
-      std::string destination = "";
-      for (int i=1; i<payloadLength; i++) {
-        destination += (char)payload[i];
-      }
-
-      std::vector<byte> dDevId;
-      dDevId.insert(dDevId.end(),destination.begin(),destination.end());
-
-      duck.sendCommand(sCmd, sValue, dDevId);
-
+      queueCommand(sCmd, payload[0], payload + 1, payloadLength - 1);
     } else {
       Serial.println("Payload size too small");
     }
@@ -325,57 +1033,149 @@ void gotMsg(char* topic, byte* payload, unsigned int payloadLength) {
   }
 }
 
-void wifiConnect() {
- Serial.print("Connecting to "); Serial.print(SSID);
- WiFi.begin(SSID, PASSWORD);
- while (WiFi.status() != WL_CONNECTED) {
-   delay(500);
-   Serial.print(".");
- }
- Serial.print("\nWiFi connected, IP address: "); Serial.println(WiFi.localIP());
-}
-
-void mqttConnect() {
-   if (!!!client.connected()) {
-      Serial.print("Reconnecting MQTT client to "); Serial.println(AWS_IOT_ENDPOINT);
-      if(!!!client.connect(THINGNAME) && retry) {
-         Serial.print("Connection failed, retry in 5 seconds");
-         retry = false;
-         timer.in(5000, enableRetry);
-      }
-      Serial.println();
-   } else {
-      if(packetQueue.size() > 0) {
-         publishQueue();
-      }
-      //Subscribe to command topic to receive commands from cloud
-      subscribeTo(commandTopic);
-   }
-
-}
-
-void subscribeTo(const char* topic) {
+bool subscribeTo(const char* topic) {
  Serial.print("subscribe to "); Serial.print(topic);
- if (client.subscribe(topic)) {
+ if (client.subscribe(topic, PapaConfig::TlsConfig::COMMAND_QOS)) {
    Serial.println(" OK");
+   return true;
  } else {
    Serial.println(" FAILED");
+   return false;
  }
 }
 
-bool enableRetry(void*) {
-  retry = true;
-  return retry;
+// A packet stored after quackJson started on it keeps its progress: a
+// record of RECORD_MARK, the first reading still to publish, the readings
+// annotated, the annotations from the first one still to publish, then the
+// packet. So draining it neither publishes a reading twice nor loses the
+// verdicts. A CDP packet starts with its sender's DUID, which is printable;
+// a record without the mark is a bare packet.
+static const uint8_t RECORD_MARK = 0xFE;
+static const size_t RECORD_HEADER = 3;
+
+std::vector<byte> packRecord(const uint8_t* packet, size_t length, Progress progress) {
+  std::vector<byte> record;
+  size_t notes = progress.annotated > progress.next ? progress.annotated - progress.next : 0;
+  if (RECORD_HEADER + notes * sizeof(Annotation) + length > PapaStore::MAX_RECORD) {
+    // Readings past what fits are drained without their verdicts
+    size_t room = PapaStore::MAX_RECORD - RECORD_HEADER - length;
+    notes = room / sizeof(Annotation);
+    progress.annotated = (uint8_t)(progress.next + notes);
+  }
+  if (progress.next > 0 || notes > 0) {
+    record.push_back(RECORD_MARK);
+    record.push_back(progress.next);
+    record.push_back(progress.annotated);
+    const uint8_t* first = (const uint8_t*)&annotations[progress.next];
+    record.insert(record.end(), first, first + notes * sizeof(Annotation));
+  }
+  record.insert(record.end(), packet, packet + length);
+  return record;
+}
+
+// Strips the progress off a stored record, copying its annotations back
+// into annotations; {0, 0} for a bare packet
+Progress unpackRecord(const uint8_t*& record, size_t& length) {
+  Progress progress = {0, 0};
+  if (length < RECORD_HEADER || record[0] != RECORD_MARK) {
+    return progress;
+  }
+  progress.next = record[1];
+  progress.annotated = record[2];
+  size_t notes = progress.annotated > progress.next ? progress.annotated - progress.next : 0;
+  if (RECORD_HEADER + notes * sizeof(Annotation) > length) {
+    progress.annotated = progress.next;
+    notes = 0;
+  }
+  memcpy(&annotations[progress.next], record + RECORD_HEADER, notes * sizeof(Annotation));
+  record += RECORD_HEADER + notes * sizeof(Annotation);
+  length -= RECORD_HEADER + notes * sizeof(Annotation);
+  return progress;
 }
 
 void publishQueue() {
+  uint32_t start = micros();
   while(!packetQueue.empty()) {
-    if(quackJson(packetQueue.front()) == 0) {
+    std::vector<byte>& record = packetQueue.front();
+    const uint8_t* packet = record.data();
+    size_t length = record.size();
+    Progress progress = unpackRecord(packet, length);
+    uint8_t first = progress.next;
+    if(quackJson(CdpPacket(std::vector<byte>(packet, packet + length)), false, progress) == 0) {
       packetQueue.pop();
+      metrics.replayed.add();
       Serial.print("Queue size: ");
       Serial.println(packetQueue.size());
     } else {
-      return;
+      if (progress.next != first) {
+        record = packRecord(packet, length, progress);
+      }
+      break;
+    }
+  }
+  metrics.backlogTime.record(micros() - start);
+}
+
+// Keeps a packet that could not be published, in flash when available,
+// with the progress quackJson made on it. False unless it went to flash:
+// the RAM queue is lost on reset and drops its oldest packet when full, so
+// a sequenced sender is not acked and resends instead.
+bool storePacket(const uint8_t* packet, size_t length, const Progress& progress) {
+  std::vector<byte> record = packRecord(packet, length, progress);
+  if (store.ready() && store.append(record.data(), record.size())) {
+    Serial.println("[PAPA] Stored packet, backlog: " + String(store.pending()));
+    return true;
+  }
+  if(packetQueue.size() >= QUEUE_SIZE_MAX) {
+    packetQueue.pop();
+    metrics.queueDrops.add();
+  }
+  packetQueue.push(record);
+  Serial.print("New size of queue: ");
+  Serial.println(packetQueue.size());
+  return false;
+}
+
+// Publishes part of the stored backlog. Each slice is capped in MQTT
+// messages, since one stored batch expands into one message per reading,
+// so live traffic keeps flowing while days of backlog go out.
+void drainStore() {
+  uint32_t now = millis();
+  if (store.ready() && now - lastStoreStats >= StoreConfig::STATS_INTERVAL) {
+    lastStoreStats = now;
+    const PapaStore::Stats& stats = store.counters();
+    Serial.printf("[PAPA] Store: backlog %u, %u%% full, appended %u, forwarded %u, dropped %u, corrupt %u\n",
+                  (unsigned)store.pending(), (unsigned)store.fillPercent(), (unsigned)stats.appended,
+                  (unsigned)stats.forwarded, (unsigned)stats.dropped, (unsigned)stats.corrupt);
+  }
+  if (!store.ready() || store.pending() == 0 || now - lastDrain < StoreConfig::DRAIN_INTERVAL) {
+    return;
+  }
+  lastDrain = now;
+
+  uint32_t start = micros();
+  uint32_t budgetStart = metrics.published.get();
+  uint8_t buffer[PapaStore::MAX_RECORD];
+  size_t length;
+  while (metrics.published.get() - budgetStart < StoreConfig::DRAIN_MESSAGES &&
+         store.peek(buffer, sizeof(buffer), length)) {
+    const uint8_t* packet = buffer;
+    Progress progress = unpackRecord(packet, length);
+    uint8_t first = progress.next;
+    if (quackJson(CdpPacket(std::vector<byte>(packet, packet + length)), false, progress) != 0) {
+      // Flash records are not rewritten: the unsent tail goes in as a new
+      // record and the partly published one is retired
+      if (progress.next != first) {
+        std::vector<byte> record = packRecord(packet, length, progress);
+        if (store.append(record.data(), record.size())) {
+          store.consume();
+        }
+      }
+      break;
     }
+    store.consume();
+    metrics.replayed.add();
   }
+  metrics.backlogTime.record(micros() - start);
+  Serial.println("[PAPA] Store backlog: " + String(store.pending()));
 }
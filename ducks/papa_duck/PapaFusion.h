@@ -0,0 +1,394 @@
+#ifndef PAPA_FUSION_H
+#define PAPA_FUSION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "PapaConfig.h"
+#include "PapaJson.h"
+#include "DuckPayload.h"
+
+// Spatial confirmation of fire alerts across neighbouring MamaDucks.
+//
+// Every live reading updates its device's node: the last GPS fix, placed
+// on a flat grid of RADIUS cells around the first fix the gateway heard,
+// the smoothed temperature rise and gas resistance drop, and its run of
+// fire alerts. An alert is scored in points:
+//
+//   FIRE_POINTS             the alert itself
+//   up to TREND_POINTS      own temperature rise or gas drop
+//   STREAK_POINTS each      STREAK_STEP the node has been alerting, up to
+//                           MAX_STREAK_POINTS
+//   up to NEIGHBOUR_POINTS  each node within RADIUS heard in the last WINDOW:
+//                           FIRE_POINTS if its last reading was an alert,
+//                           plus its trend points, weighted 1 at the same
+//                           spot down to 0 at RADIUS
+//   less QUIET_POINTS       each such node with neither, weighted the same,
+//                           up to MAX_QUIET_POINTS
+//
+// At CONFIRM_SCORE the alert confirms an incident. A node next to one
+// already burning joins that incident, otherwise a new one is paged.
+// Further alerts from an incident's nodes stay confirmed until they fall
+// silent for CLEAR_AFTER. Two nodes alerting together confirm on their
+// first readings; a lone node, or one without a fix, confirms on its
+// streak, and one whose close neighbours see nothing needs a trend as
+// well.
+//
+// MamaDucks report by exception: a steady reading, alerts included, is
+// suppressed until a value leaves its deadband or the heartbeat is due,
+// while a change of prediction is always sent. A node's last reading
+// therefore stands until WINDOW, just over the heartbeat, and a run of
+// alerts lasts until a reading without fire, counted in sensing time
+// rather than in alerts heard. A reading without fire sensed inside a
+// run, from a batch the alerts overtook, restarts the run at the newest
+// alert. The table is fixed size: a new device takes a free slot, or the
+// one idle the longest.
+namespace PapaFusion {
+
+using PapaConfig::FusionConfig;
+
+struct Stats {
+    uint32_t readings;
+    uint32_t alerts;          // fire readings fed in
+    uint32_t confirmed;       // of which confirmed by an incident
+    uint32_t held;            // of which not confirmed yet
+    uint32_t incidents;       // new incidents paged
+    uint32_t joined;          // nodes that joined a neighbour's incident
+    uint32_t evictions;       // devices displaced from a full table
+};
+
+// What fusion made of one reading. score is -1 for readings without fire.
+struct Assessment {
+    int16_t score;
+    bool confirmed;
+    bool paged;               // this alert opened a new incident
+    uint32_t incident;        // 0 for none
+    uint8_t nodes;            // alerting neighbours that contributed
+};
+
+struct Node {
+    uint8_t id[FusionConfig::ID_SIZE];
+    uint8_t idLength;         // 0 marks a free slot
+    bool positioned;
+    bool fired;               // the newest reading was an alert
+    int32_t cellX;
+    int32_t cellY;
+    float x;                  // m east of the origin
+    float y;                  // m north of the origin
+    double latitude;
+    double longitude;
+    uint16_t bucket;          // grid bucket while positioned
+    uint16_t next;            // next node in the bucket, slot + 1
+    uint32_t lastSeen;
+    uint32_t runStart;        // sensing time of the first alert of the run
+    uint32_t fireAt;          // sensing time of the newest alert
+    uint32_t takenAt;         // sensing time of the newest reading, 0 until the first
+    float previousTemp;
+    float previousGas;
+    float tempRate;           // degC per hour, smoothed
+    float gasRate;            // fraction of gas resistance lost per hour, smoothed
+    uint32_t incident;
+    uint32_t incidentSeen;    // last alert within the incident
+};
+
+// {"Incident","DeviceID","Score","Nodes"[,"Lat","Lng"]}
+inline size_t serialize(const Node& n, const Assessment& a, char* out, size_t capacity) {
+    PapaJson::Writer w(out, capacity);
+    w.key("Incident");
+    w.number(a.incident);
+    w.key("DeviceID");
+    w.string(PapaJson::span(n.id, n.idLength));
+    w.key("Score");
+    w.number((unsigned long)a.score);
+    w.key("Nodes");
+    w.number(a.nodes + 1u);
+    if (n.positioned) {
+        w.key("Lat");
+        w.decimal(n.latitude, 5);
+        w.key("Lng");
+        w.decimal(n.longitude, 4);
+    }
+    return w.finish();
+}
+
+template <size_t N = FusionConfig::NODES>
+class Table {
+    static_assert(N < 0xFFFF, "Grid links are 16 bit");
+    static_assert((FusionConfig::GRID_BUCKETS & (FusionConfig::GRID_BUCKETS - 1)) == 0,
+                  "GRID_BUCKETS must be a power of two");
+
+private:
+    static const uint16_t NO_BUCKET = 0xFFFF;
+
+    Node nodes[N];
+    uint16_t grid[FusionConfig::GRID_BUCKETS];  // first node per bucket, slot + 1
+    bool hasOrigin;
+    double originLatitude;
+    double originLongitude;
+    double metersPerDegree;   // of longitude at the origin
+    uint32_t lastIncident;
+    Stats stats;
+
+    static uint16_t bucketOf(int32_t cellX, int32_t cellY) {
+        uint32_t h = (uint32_t)cellX * 73856093u ^ (uint32_t)cellY * 19349663u;
+        return (uint16_t)(h & (FusionConfig::GRID_BUCKETS - 1));
+    }
+
+    void link(size_t slot) {
+        Node& n = nodes[slot];
+        n.bucket = bucketOf(n.cellX, n.cellY);
+        n.next = grid[n.bucket];
+        grid[n.bucket] = (uint16_t)(slot + 1);
+    }
+
+    void unlink(size_t slot) {
+        Node& n = nodes[slot];
+        if (n.bucket == NO_BUCKET) return;
+        uint16_t* e = &grid[n.bucket];
+        while (*e && *e != slot + 1) e = &nodes[*e - 1].next;
+        if (*e) *e = n.next;
+        n.bucket = NO_BUCKET;
+    }
+
+    size_t find(const uint8_t* id, size_t length, uint32_t now) {
+        if (length > FusionConfig::ID_SIZE) length = FusionConfig::ID_SIZE;
+        size_t victim = N;
+        for (size_t i = 0; i < N; i++) {
+            const Node& n = nodes[i];
+            if (n.idLength == length && memcmp(n.id, id, length) == 0) return i;
+            if (victim == N || better(n, nodes[victim])) victim = i;
+        }
+        Node& n = nodes[victim];
+        if (n.idLength) {
+            unlink(victim);
+            stats.evictions++;
+        }
+        memcpy(n.id, id, length);
+        n.idLength = (uint8_t)length;
+        n.positioned = false;
+        n.fired = false;
+        n.bucket = NO_BUCKET;
+        n.takenAt = 0;
+        n.tempRate = 0.0f;
+        n.gasRate = 0.0f;
+        n.incident = 0;
+        n.lastSeen = now;
+        return victim;
+    }
+
+    // Slot preference for a new device: free, then idle the longest
+    static bool better(const Node& a, const Node& b) {
+        if (!a.idLength || !b.idLength) return !a.idLength && b.idLength;
+        return (int32_t)(a.lastSeen - b.lastSeen) < 0;
+    }
+
+    void place(size_t slot, double latitude, double longitude) {
+        if (!hasOrigin) {
+            hasOrigin = true;
+            originLatitude = latitude;
+            originLongitude = longitude;
+            metersPerDegree = 111320.0 * cos(latitude * M_PI / 180.0);
+        }
+        Node& n = nodes[slot];
+        n.latitude = latitude;
+        n.longitude = longitude;
+        n.x = (float)((longitude - originLongitude) * metersPerDegree);
+        n.y = (float)((latitude - originLatitude) * 110540.0);
+        int32_t cellX = (int32_t)floorf(n.x / FusionConfig::RADIUS);
+        int32_t cellY = (int32_t)floorf(n.y / FusionConfig::RADIUS);
+        if (n.positioned && cellX == n.cellX && cellY == n.cellY) return;
+        unlink(slot);
+        n.positioned = true;
+        n.cellX = cellX;
+        n.cellY = cellY;
+        link(slot);
+    }
+
+    // Rates between readings by sensing time: a batch arrives all at once,
+    // and an alert sent ahead of its batch leaves the batch late
+    void trend(Node& n, const DuckPayload::Reading& r, uint32_t takenAt) {
+        uint32_t elapsed = takenAt - n.takenAt;
+        if (n.takenAt && (int32_t)elapsed <= 0) return;
+        if (n.takenAt && elapsed < FusionConfig::WINDOW) {
+            float hours = elapsed / 3600000.0f;
+            float temp = (r.temp - n.previousTemp) / hours;
+            float gas = n.previousGas > 0.0f ? (n.previousGas - r.gas) / n.previousGas / hours : 0.0f;
+            n.tempRate += FusionConfig::SMOOTHING * (temp - n.tempRate);
+            n.gasRate += FusionConfig::SMOOTHING * (gas - n.gasRate);
+        } else {
+            n.tempRate = 0.0f;
+            n.gasRate = 0.0f;
+        }
+        n.takenAt = takenAt ? takenAt : 1;
+        n.previousTemp = r.temp;
+        n.previousGas = r.gas;
+    }
+
+    static float trendPoints(const Node& n) {
+        float rise = n.tempRate / FusionConfig::TEMP_RISE;
+        float drop = n.gasRate / FusionConfig::GAS_DROP;
+        float t = rise > drop ? rise : drop;
+        if (t <= 0.0f) return 0.0f;
+        return (t < 1.0f ? t : 1.0f) * FusionConfig::TREND_POINTS;
+    }
+
+    bool active(const Node& n, uint32_t now) const {
+        return n.incident && now - n.incidentSeen < FusionConfig::CLEAR_AFTER;
+    }
+
+    // Neighbour points around slot, less the quiet ones; the nearest neighbour in an incident
+    // is left in joinable
+    float neighbours(size_t slot, uint32_t now, uint8_t& alerting, uint32_t& joinable) const {
+        const Node& self = nodes[slot];
+        float points = 0.0f;
+        float quiet = 0.0f;
+        float nearest = 0.0f;
+        alerting = 0;
+        joinable = 0;
+        for (int32_t dy = -1; dy <= 1; dy++) {
+            for (int32_t dx = -1; dx <= 1; dx++) {
+                int32_t cellX = self.cellX + dx;
+                int32_t cellY = self.cellY + dy;
+                for (uint16_t e = grid[bucketOf(cellX, cellY)]; e; e = nodes[e - 1].next) {
+                    const Node& n = nodes[e - 1];
+                    // Buckets are shared by distant cells
+                    if (e - 1u == slot || n.cellX != cellX || n.cellY != cellY) continue;
+                    if (now - n.lastSeen >= FusionConfig::WINDOW) continue;
+                    float distance = sqrtf((n.x - self.x) * (n.x - self.x) + (n.y - self.y) * (n.y - self.y));
+                    if (distance >= FusionConfig::RADIUS) continue;
+                    float weight = 1.0f - distance / FusionConfig::RADIUS;
+                    bool fire = n.fired;
+                    float support = (fire ? FusionConfig::FIRE_POINTS : 0) + trendPoints(n);
+                    if (support > 0.0f) {
+                        points += weight * support;
+                    } else {
+                        quiet += weight * FusionConfig::QUIET_POINTS;
+                    }
+                    if (fire && alerting < 0xFF) alerting++;
+                    if (active(n, now) && (!joinable || weight > nearest)) {
+                        joinable = n.incident;
+                        nearest = weight;
+                    }
+                }
+            }
+        }
+        if (points > FusionConfig::NEIGHBOUR_POINTS) points = FusionConfig::NEIGHBOUR_POINTS;
+        if (quiet > FusionConfig::MAX_QUIET_POINTS) quiet = FusionConfig::MAX_QUIET_POINTS;
+        return points - quiet;
+    }
+
+public:
+    Table()
+        : hasOrigin(false), originLatitude(0), originLongitude(0), metersPerDegree(0), lastIncident(0), stats() {
+        for (size_t i = 0; i < N; i++) {
+            nodes[i].idLength = 0;
+            nodes[i].bucket = NO_BUCKET;
+        }
+        memset(grid, 0, sizeof(grid));
+    }
+
+    // Adds a live reading. fire is the alert as it stands after gateway
+    // re-scoring; a reading without fire only updates its node. takenAt is
+    // when the reading was sensed and now when it arrived, both on the
+    // gateway clock. A reading sensed before the node's newest changes
+    // neither its trend nor its streak.
+    Assessment add(const uint8_t* id, size_t length, const DuckPayload::Reading& r, bool fire, uint32_t takenAt,
+                   uint32_t now) {
+        Assessment a = {-1, false, false, 0, 0};
+        stats.readings++;
+        if (length == 0) return a;
+        size_t slot = find(id, length, now);
+        Node& n = nodes[slot];
+        bool late = n.takenAt && (int32_t)(takenAt - n.takenAt) < 0;
+        if (r.hasGPS && !late) place(slot, r.latitude, r.longitude);
+        trend(n, r, takenAt);
+        n.lastSeen = now;
+        if (!fire) {
+            if (!late) {
+                n.fired = false;
+            } else if (n.fired && (int32_t)(takenAt - n.runStart) > 0) {
+                n.runStart = n.fireAt;
+            }
+            return a;
+        }
+        stats.alerts++;
+        if (!late) {
+            if (!n.fired || takenAt - n.fireAt >= FusionConfig::WINDOW) n.runStart = takenAt;
+            n.fired = true;
+            n.fireAt = takenAt;
+        }
+
+        uint32_t joinable = 0;
+        float points = FusionConfig::FIRE_POINTS + trendPoints(n);
+        unsigned streak = (n.fireAt - n.runStart) / FusionConfig::STREAK_STEP * FusionConfig::STREAK_POINTS;
+        points += streak < FusionConfig::MAX_STREAK_POINTS ? streak : FusionConfig::MAX_STREAK_POINTS;
+        if (n.positioned) points += neighbours(slot, now, a.nodes, joinable);
+        a.score = points > 0.0f ? (int16_t)(points + 0.5f) : 0;
+
+        if (active(n, now)) {
+            a.confirmed = true;
+        } else if (a.score >= FusionConfig::CONFIRM_SCORE) {
+            a.confirmed = true;
+            if (joinable) {
+                n.incident = joinable;
+                stats.joined++;
+            } else {
+                n.incident = ++lastIncident;
+                a.paged = true;
+                stats.incidents++;
+            }
+        }
+        if (a.confirmed) {
+            n.incidentSeen = now;
+            a.incident = n.incident;
+            stats.confirmed++;
+        } else {
+            stats.held++;
+        }
+        return a;
+    }
+
+    // Withdraws the incident the device's last alert paged, when the page
+    // could not be published; the alert counts as held and the node's next
+    // confirmed alert pages the incident again. Only valid straight after
+    // the add() that returned paged.
+    void unpage(const uint8_t* id, size_t length) {
+        if (length > FusionConfig::ID_SIZE) length = FusionConfig::ID_SIZE;
+        for (size_t i = 0; i < N; i++) {
+            Node& n = nodes[i];
+            if (n.idLength != length || memcmp(n.id, id, length) != 0) continue;
+            if (n.incident && n.incident == lastIncident) {
+                n.incident = 0;
+                lastIncident--;
+                stats.incidents--;
+                stats.confirmed--;
+                stats.held++;
+            }
+            return;
+        }
+    }
+
+    // The node of the device's last reading, for serialize()
+    const Node* node(const uint8_t* id, size_t length) const {
+        if (length > FusionConfig::ID_SIZE) length = FusionConfig::ID_SIZE;
+        for (size_t i = 0; i < N; i++) {
+            if (nodes[i].idLength == length && memcmp(nodes[i].id, id, length) == 0) return &nodes[i];
+        }
+        return NULL;
+    }
+
+    size_t tracked() const {
+        size_t n = 0;
+        for (size_t i = 0; i < N; i++) n += nodes[i].idLength != 0;
+        return n;
+    }
+
+    static size_t capacity() { return N; }
+    static size_t memoryBytes() { return sizeof(Table); }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaFusion
+
+#endif // PAPA_FUSION_H
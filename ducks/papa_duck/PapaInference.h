@@ -0,0 +1,299 @@
+#ifndef PAPA_INFERENCE_H
+#define PAPA_INFERENCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "PapaConfig.h"
+#include "DuckPayload.h"
+#include "random_forest_10_v2.h"
+#include "random_forest_10_v3.h"
+
+// Gateway re-scoring of MamaDuck fire predictions.
+//
+// A MamaDuck decides alone with one 10-tree forest. The gateway rebuilds
+// each device's five-reading feature window from the readings it hears
+// and scores every one with both forests trained on that feature set:
+// v3, which the MamaDucks run, and v2, trained on other data and scaling,
+// 20 trees in all, each fed the features it was trained on. A MamaDuck's
+// counter only advances on readings it sends, so the window is spaced by
+// sensing time instead (batch timestamps, arrival for single packets):
+// every SENSE_INTERVAL without a reading, one suppressed inside the
+// report deadbands or lost, is filled in with the last value, which is
+// what a suppressed reading was to within the deadband. This keeps the
+// velocity features at the MamaDuck's 10 s spacing. A verdict averages
+// the share of trees voting fire over the device's last CONTEXT readings,
+// so one odd reading neither confirms nor clears an alert:
+//
+//   confirmed   edge fire, score at least CONFIRM_SCORE
+//   uncertain   edge fire, score in between; still an alert
+//   vetoed      edge fire, score below VETO_SCORE
+//   raised      no edge fire, score at least CONFIRM_SCORE
+//   clear       neither
+//
+// Readings arrive out of order: a MamaDuck sends an alert ahead of its
+// open batch, and resends follow newer packets. A reading older than its
+// device's newest is left out rather than restarting the window; a counter
+// more than REORDER behind is a rebooted MamaDuck and starts a new one.
+//
+// Readings are not scored until their device's window is full. The table
+// is fixed size: a new device takes a free slot, or the one idle the
+// longest, and an index over the IDs keeps lookups flat at hundreds of
+// devices.
+namespace PapaInference {
+
+using PapaConfig::InferenceConfig;
+
+enum class Verdict : uint8_t { UNSCORED, CLEAR, CONFIRMED, UNCERTAIN, VETOED, RAISED };
+
+inline const char* verdictName(Verdict v) {
+    switch (v) {
+        case Verdict::CLEAR: return "clear";
+        case Verdict::CONFIRMED: return "confirmed";
+        case Verdict::UNCERTAIN: return "uncertain";
+        case Verdict::VETOED: return "vetoed";
+        case Verdict::RAISED: return "raised";
+        default: return "unscored";
+    }
+}
+
+// Feature scaling each forest was trained with (DuckConfig::MLConfig of
+// mama_duck_v6 and mama_duck_v5): temp, humidity, pressure, gas
+struct Scaling {
+    float mean[4];
+    float std[4];
+};
+
+static const Scaling V3_SCALING = {
+    {22.587185507246378f, 20.21838724637681f, 93276.0823942029f, 91521.6266057971f},
+    {9.11950266841401f, 15.375679674842786f, 18385.14259777322f, 31677.995590809332f},
+};
+static const Scaling V2_SCALING = {
+    {29.43918594687232f, 8.12150471293916f, 97206.94431876607f, 68812.22262210795f},
+    {2.474995698480596f, 0.7883001364721569f, 92.58890775783398f, 15230.956590523883f},
+};
+
+static const size_t FEATURES = 12;
+static const uint8_t TREES = 20;
+
+struct Stats {
+    uint32_t readings;
+    uint32_t scored;
+    uint32_t confirmed;
+    uint32_t uncertain;
+    uint32_t vetoed;
+    uint32_t raised;
+    uint32_t restarts;        // windows restarted after a reboot or silence
+    uint32_t late;            // readings older than their device's window, not scored
+    uint32_t evictions;       // devices displaced from a full table
+};
+
+// The 12 features of both forests from a full window, oldest reading at
+// head. v3 (SensorManager in mama_duck_v6) takes volatility and velocity
+// of the raw values; v2 (mama_duck_v5) of the scaled ones.
+inline void features(const float window[][4], size_t head, float v3[FEATURES], float v2[FEATURES]) {
+    const size_t n = InferenceConfig::HISTORY;
+    const float hours = InferenceConfig::SENSE_INTERVAL / 3600000.0f;
+    const float* last = window[(head + n - 1) % n];
+    const float* previous = window[(head + n - 2) % n];
+    for (size_t f = 0; f < 4; f++) {
+        float mean = 0.0f, variance = 0.0f;
+        for (size_t i = 0; i < n; i++) mean += window[i][f];
+        mean /= n;
+        for (size_t i = 0; i < n; i++) variance += (window[i][f] - mean) * (window[i][f] - mean);
+        float volatility = sqrtf(variance / n);
+        float velocity = (last[f] - previous[f]) / hours;
+
+        v3[f] = (last[f] - V3_SCALING.mean[f]) / V3_SCALING.std[f];
+        v3[4 + f] = volatility;
+        v3[8 + f] = velocity;
+        v2[f] = (last[f] - V2_SCALING.mean[f]) / V2_SCALING.std[f];
+        v2[4 + f] = volatility / V2_SCALING.std[f];
+        v2[8 + f] = velocity / V2_SCALING.std[f];
+    }
+}
+
+// Share of the ensemble's trees voting fire, in %
+inline uint8_t ensembleScore(float v3[FEATURES], float v2[FEATURES]) {
+    uint8_t votesV3[2] = {0, 0};
+    uint8_t votesV2[2] = {0, 0};
+    Eloquent::ML::Port::RandomForestV3().predict(v3, votesV3);
+    Eloquent::ML::Port::RandomForestV2().predict(v2, votesV2);
+    return (uint8_t)((votesV3[1] + votesV2[1]) * 100 / TREES);
+}
+
+inline Verdict decide(bool edgeFire, uint8_t score) {
+    if (edgeFire) {
+        if (score >= InferenceConfig::CONFIRM_SCORE) return Verdict::CONFIRMED;
+        return score < InferenceConfig::VETO_SCORE ? Verdict::VETOED : Verdict::UNCERTAIN;
+    }
+    return score >= InferenceConfig::CONFIRM_SCORE ? Verdict::RAISED : Verdict::CLEAR;
+}
+
+// Smallest power of two at least twice n, for the ID index
+constexpr size_t indexSize(size_t n, size_t size = 1) {
+    return size >= 2 * n ? size : indexSize(n, size * 2);
+}
+
+template <size_t N = InferenceConfig::DEVICES>
+class Table {
+    static_assert(N < 0xFFFF, "Index entries are 16 bit");
+
+private:
+    struct Device {
+        uint8_t id[InferenceConfig::ID_SIZE];
+        uint8_t idLength;
+        uint8_t filled;             // readings in the window, up to HISTORY
+        uint8_t head;               // oldest reading, overwritten next
+        uint8_t scoreCount;
+        uint8_t scoreHead;
+        uint8_t scores[InferenceConfig::CONTEXT];
+        uint32_t counter;
+        uint32_t lastSeen;
+        uint32_t takenAt;           // sensing time of the newest reading
+        float window[InferenceConfig::HISTORY][4];  // raw temp, humidity, pressure, gas
+    };
+
+    static const size_t INDEX = indexSize(N);
+
+    Device devices[N];
+    uint16_t index[INDEX];          // slot + 1, 0 for empty
+    size_t used;
+    Stats stats;
+
+    static uint32_t hashId(const uint8_t* id, size_t length) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < length; i++) h = (h ^ id[i]) * 16777619u;
+        return h ^ (h >> 15);
+    }
+
+    void indexInsert(size_t slot) {
+        const Device& d = devices[slot];
+        for (size_t i = hashId(d.id, d.idLength);; i++) {
+            uint16_t& e = index[i & (INDEX - 1)];
+            if (!e) {
+                e = (uint16_t)(slot + 1);
+                return;
+            }
+        }
+    }
+
+    void rebuildIndex() {
+        memset(index, 0, sizeof(index));
+        for (size_t i = 0; i < used; i++) indexInsert(i);
+    }
+
+    Device* find(const uint8_t* id, size_t length, uint32_t now) {
+        if (length > InferenceConfig::ID_SIZE) length = InferenceConfig::ID_SIZE;
+        for (size_t i = hashId(id, length);; i++) {
+            uint16_t e = index[i & (INDEX - 1)];
+            if (!e) break;
+            Device& d = devices[e - 1];
+            if (d.idLength == length && memcmp(d.id, id, length) == 0) return &d;
+        }
+        size_t slot = used;
+        bool evicted = used == N;
+        if (evicted) {
+            slot = 0;
+            for (size_t i = 1; i < N; i++) {
+                if ((int32_t)(devices[i].lastSeen - devices[slot].lastSeen) < 0) slot = i;
+            }
+            stats.evictions++;
+        } else {
+            used++;
+        }
+        Device& d = devices[slot];
+        memcpy(d.id, id, length);
+        d.idLength = (uint8_t)length;
+        restart(d);
+        d.lastSeen = now;
+        // The evicted ID's entry would otherwise stay in the probe chains
+        if (evicted) {
+            rebuildIndex();
+        } else {
+            indexInsert(slot);
+        }
+        return &d;
+    }
+
+    static void restart(Device& d) {
+        d.filled = 0;
+        d.head = 0;
+        d.scoreCount = 0;
+        d.scoreHead = 0;
+    }
+
+    static void push(Device& d, const float values[4]) {
+        memcpy(d.window[d.head], values, sizeof(d.window[0]));
+        d.head = (uint8_t)((d.head + 1) % InferenceConfig::HISTORY);
+        if (d.filled < InferenceConfig::HISTORY) d.filled++;
+    }
+
+public:
+    Table() : used(0), stats() { memset(index, 0, sizeof(index)); }
+
+    // Adds a live reading to its device's window and scores it. takenAt is
+    // when it was sensed and now when it arrived, both on the gateway
+    // clock. score is the share of trees voting fire averaged over the
+    // last CONTEXT readings, valid unless the verdict is UNSCORED.
+    Verdict score(const uint8_t* id, size_t length, const DuckPayload::Reading& r, uint32_t takenAt, uint32_t now,
+                  uint8_t& score) {
+        stats.readings++;
+        if (length == 0) return Verdict::UNSCORED;
+        Device* d = find(id, length, now);
+        bool known = d->filled > 0;
+        bool behind = known && r.counter <= d->counter;
+        if (known && ((behind && d->counter - r.counter > InferenceConfig::REORDER) ||
+                      now - d->lastSeen >= InferenceConfig::STALE_AFTER)) {
+            restart(*d);
+            stats.restarts++;
+        } else if (behind) {
+            // An alert overtaking the open batch, or a resend: the window
+            // has moved past it
+            stats.late++;
+            return Verdict::UNSCORED;
+        } else if (known && (int32_t)(takenAt - d->takenAt) > 0) {
+            // Sensing cycles without a reading: hold the last value
+            uint32_t cycles = (takenAt - d->takenAt + InferenceConfig::SENSE_INTERVAL / 2) / InferenceConfig::SENSE_INTERVAL;
+            float held[4];
+            memcpy(held, d->window[(d->head + InferenceConfig::HISTORY - 1) % InferenceConfig::HISTORY], sizeof(held));
+            for (uint32_t i = 1; i < cycles && i <= InferenceConfig::HISTORY; i++) push(*d, held);
+        }
+        float values[4] = {r.temp, r.humidity, r.pressure, r.gas};
+        push(*d, values);
+        d->counter = r.counter;
+        d->lastSeen = now;
+        d->takenAt = takenAt;
+        if (d->filled < InferenceConfig::HISTORY) return Verdict::UNSCORED;
+
+        float v3[FEATURES], v2[FEATURES];
+        features(d->window, d->head, v3, v2);
+        d->scores[d->scoreHead] = ensembleScore(v3, v2);
+        d->scoreHead = (uint8_t)((d->scoreHead + 1) % InferenceConfig::CONTEXT);
+        if (d->scoreCount < InferenceConfig::CONTEXT) d->scoreCount++;
+        unsigned sum = 0;
+        for (uint8_t i = 0; i < d->scoreCount; i++) sum += d->scores[i];
+        score = (uint8_t)(sum / d->scoreCount);
+
+        Verdict v = decide(r.prediction == 1, score);
+        stats.scored++;
+        switch (v) {
+            case Verdict::CONFIRMED: stats.confirmed++; break;
+            case Verdict::UNCERTAIN: stats.uncertain++; break;
+            case Verdict::VETOED: stats.vetoed++; break;
+            case Verdict::RAISED: stats.raised++; break;
+            default: break;
+        }
+        return v;
+    }
+
+    size_t tracked() const { return used; }
+    static size_t capacity() { return N; }
+    static size_t memoryBytes() { return sizeof(Table); }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaInference
+
+#endif // PAPA_INFERENCE_H
@@ -0,0 +1,267 @@
+#ifndef PAPA_JSON_H
+#define PAPA_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// Allocation-free JSON for the messages the PapaDuck forwards to MQTT.
+// Fields are written straight from the CDP packet's byte spans into a
+// caller-owned buffer, in the same key order and number formatting the
+// ArduinoJson document used, so the cloud side sees identical messages.
+namespace PapaJson {
+
+// A 229 byte CDP payload hex encoded, or escaped with every byte a
+// control character, plus the envelope
+static const size_t BUFFER_SIZE = 1536;
+static const size_t TOPIC_SIZE = 96;
+
+struct Span {
+    const uint8_t* data;
+    size_t length;
+};
+
+inline Span span(const uint8_t* data, size_t length) {
+    Span s = {data, length};
+    return s;
+}
+
+class Writer {
+private:
+    char* out;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+    bool first;
+
+    void put(char c) {
+        if (length + 1 < capacity) {
+            out[length++] = c;
+        } else {
+            overflow = true;
+        }
+    }
+
+    void put(const char* s, size_t n) {
+        if (length + n < capacity) {
+            memcpy(out + length, s, n);
+            length += n;
+        } else {
+            overflow = true;
+        }
+    }
+
+public:
+    Writer(char* out, size_t capacity)
+        : out(out), capacity(capacity), length(0), overflow(capacity == 0), first(true) {
+        put('{');
+    }
+
+    void key(const char* name) {
+        if (!first) put(',');
+        first = false;
+        put('"');
+        put(name, strlen(name));
+        put("\":", 2);
+    }
+
+    // Quoted string with JSON escapes. ArduinoJson wrote the remaining
+    // control characters raw; they become \u00XX here so the output stays
+    // valid JSON. Other bytes pass through unchanged.
+    void string(Span s, const char* suffix = NULL) {
+        static const char* DIGITS = "0123456789abcdef";
+        put('"');
+        for (size_t i = 0; i < s.length; i++) {
+            uint8_t c = s.data[i];
+            switch (c) {
+                case '"':  put("\\\"", 2); break;
+                case '\\': put("\\\\", 2); break;
+                case '\b': put("\\b", 2); break;
+                case '\f': put("\\f", 2); break;
+                case '\n': put("\\n", 2); break;
+                case '\r': put("\\r", 2); break;
+                case '\t': put("\\t", 2); break;
+                default:
+                    if (c < 0x20) {
+                        char escape[6] = {'\\', 'u', '0', '0', DIGITS[c >> 4], DIGITS[c & 0x0F]};
+                        put(escape, sizeof(escape));
+                    } else {
+                        put((char)c);
+                    }
+            }
+        }
+        if (suffix) put(suffix, strlen(suffix));
+        put('"');
+    }
+
+    // Quoted upper case hex, as convertToHex produced
+    void hex(Span s) {
+        static const char* DIGITS = "0123456789ABCDEF";
+        put('"');
+        for (size_t i = 0; i < s.length; i++) {
+            put(DIGITS[s.data[i] >> 4]);
+            put(DIGITS[s.data[i] & 0x0F]);
+        }
+        put('"');
+    }
+
+    void number(unsigned long value) {
+        char digits[12];
+        int n = snprintf(digits, sizeof(digits), "%lu", value);
+        put(digits, (size_t)n);
+    }
+
+    // value / 10 the way ArduinoJson prints a double: no ".0" for integers
+    void tenths(uint32_t value) {
+        number(value / 10);
+        if (value % 10) {
+            put('.');
+            put((char)('0' + value % 10));
+        }
+    }
+
+    // Fixed-point number, trailing zeros kept
+    void decimal(double value, uint8_t places) {
+        char digits[24];
+        int n = snprintf(digits, sizeof(digits), "%.*f", (int)places, value);
+        if (n < 0 || (size_t)n >= sizeof(digits)) {
+            put('0');
+            return;
+        }
+        put(digits, (size_t)n);
+    }
+
+    // [v0,v1,...] of fixed-point numbers
+    void decimals(const double* values, size_t count, uint8_t places) {
+        put('[');
+        for (size_t i = 0; i < count; i++) {
+            if (i) put(',');
+            decimal(values[i], places);
+        }
+        put(']');
+    }
+
+    // Closes the object; returns the length, or 0 if the buffer was too small
+    size_t finish() {
+        put('}');
+        if (overflow) {
+            if (capacity) out[0] = '\0';
+            return 0;
+        }
+        out[length] = '\0';
+        return length;
+    }
+};
+
+// One forwarded message
+struct Message {
+    Span deviceId;
+    Span messageId;
+    Span path;
+    Span payload;
+    uint8_t hops;
+    uint8_t duckType;
+    bool hexPayload;    // binary payloads such as health reports
+    int readingIndex;   // batch reading, appended to MessageID; -1 for none
+    int32_t ageTenths;  // batch reading age in 0.1 s; -1 for none
+    int32_t sequence;   // MamaDuck packet sequence number; -1 for none
+    const char* verdict; // gateway re-scoring verdict; NULL for none
+    uint8_t score;      // gateway fire score in %, with a verdict
+    int16_t fusion;     // spatial fusion points of a fire alert; -1 for none
+    uint32_t incident;  // incident confirming the alert; 0 for none
+};
+
+inline Message message() {
+    Message m;
+    m.deviceId = m.messageId = m.path = m.payload = span(NULL, 0);
+    m.hops = m.duckType = 0;
+    m.hexPayload = false;
+    m.readingIndex = -1;
+    m.ageTenths = -1;
+    m.sequence = -1;
+    m.verdict = NULL;
+    m.score = 0;
+    m.fusion = -1;
+    m.incident = 0;
+    return m;
+}
+
+// {"DeviceID","MessageID","path","hops","duckType","Payload"[,"age"][,"seq"][,"verdict","score"][,"fusion"[,"incident"]]}
+inline size_t serialize(const Message& m, char* out, size_t capacity) {
+    Writer w(out, capacity);
+    w.key("DeviceID");
+    w.string(m.deviceId);
+    w.key("MessageID");
+    if (m.readingIndex >= 0) {
+        char suffix[12];
+        snprintf(suffix, sizeof(suffix), "-%d", m.readingIndex);
+        w.string(m.messageId, suffix);
+    } else {
+        w.string(m.messageId);
+    }
+    w.key("path");
+    w.string(m.path);
+    w.key("hops");
+    w.number(m.hops);
+    w.key("duckType");
+    w.number(m.duckType);
+    w.key("Payload");
+    if (m.hexPayload) {
+        w.hex(m.payload);
+    } else {
+        w.string(m.payload);
+    }
+    if (m.ageTenths >= 0) {
+        w.key("age");
+        w.tenths((uint32_t)m.ageTenths);
+    }
+    if (m.sequence >= 0) {
+        w.key("seq");
+        w.number((unsigned long)m.sequence);
+    }
+    if (m.verdict) {
+        w.key("verdict");
+        w.string(span((const uint8_t*)m.verdict, strlen(m.verdict)));
+        w.key("score");
+        w.number(m.score);
+    }
+    if (m.fusion >= 0) {
+        w.key("fusion");
+        w.number((unsigned long)m.fusion);
+        if (m.incident) {
+            w.key("incident");
+            w.number(m.incident);
+        }
+    }
+    return w.finish();
+}
+
+// "owl/device/<thing>/evt/" built once; per message only the CDP topic
+// name is copied in behind it
+class Topic {
+private:
+    char buffer[TOPIC_SIZE];
+    size_t prefix;
+
+public:
+    Topic() : prefix(0) { buffer[0] = '\0'; }
+
+    void begin(const char* thingName) {
+        int n = snprintf(buffer, sizeof(buffer), "owl/device/%s/evt/", thingName);
+        prefix = n < 0 ? 0 : ((size_t)n < sizeof(buffer) ? (size_t)n : sizeof(buffer) - 1);
+    }
+
+    const char* with(const char* name) {
+        size_t room = sizeof(buffer) - prefix - 1;
+        size_t n = strlen(name);
+        if (n > room) n = room;
+        memcpy(buffer + prefix, name, n);
+        buffer[prefix + n] = '\0';
+        return buffer;
+    }
+};
+
+} // namespace PapaJson
+
+#endif // PAPA_JSON_H
@@ -0,0 +1,172 @@
+#ifndef PAPA_LINK_H
+#define PAPA_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "PapaConfig.h"
+
+// Event-driven WiFi/MQTT connection manager. poll() runs from the publish
+// task (publishTaskMain) and never blocks: WiFi association is started and then
+// watched, and the MQTT connect (TCP + TLS handshake) runs in a separate
+// task behind Link::mqttStart()/mqttResult(). Failed attempts back off
+// exponentially with jitter. The command topic is subscribed once per
+// MQTT session, on entering ONLINE.
+namespace PapaLink {
+
+using PapaConfig::LinkConfig;
+
+enum class State : uint8_t {
+    WIFI_DOWN,        // waiting for the next association attempt
+    WIFI_JOINING,     // WiFi.begin() issued
+    WIFI_UP,          // waiting for the next MQTT attempt
+    MQTT_CONNECTING,  // connect running in the background
+    ONLINE
+};
+
+inline const char* stateName(State s) {
+    switch (s) {
+        case State::WIFI_DOWN: return "wifi down";
+        case State::WIFI_JOINING: return "wifi joining";
+        case State::WIFI_UP: return "wifi up";
+        case State::MQTT_CONNECTING: return "mqtt connecting";
+        case State::ONLINE: return "online";
+    }
+    return "?";
+}
+
+// Platform hooks; none of them may block
+class Link {
+public:
+    virtual ~Link() {}
+    virtual bool wifiConnected() = 0;
+    virtual void wifiBegin() = 0;
+    virtual void mqttStart() = 0;      // start an asynchronous connect
+    virtual int8_t mqttResult() = 0;   // -1 while pending, 0 failed, 1 connected
+    virtual bool mqttConnected() = 0;
+    virtual void mqttStop() = 0;
+    virtual bool subscribe() = 0;
+};
+
+struct Stats {
+    uint32_t sessions;      // MQTT sessions established
+    uint32_t wifiAttempts;
+    uint32_t mqttAttempts;
+    uint32_t failures;      // failed WiFi or MQTT attempts
+    uint32_t subscribes;
+};
+
+class Manager {
+private:
+    Link* link;
+    State current;
+    uint32_t since;
+    uint32_t nextAttempt;
+    uint8_t failures;       // consecutive, drives the backoff
+    uint32_t seed;
+    Stats stats;
+
+    static bool reached(uint32_t now, uint32_t deadline) {
+        return (int32_t)(now - deadline) >= 0;
+    }
+
+    uint32_t nextRandom() {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
+    }
+
+    // base * 2^failures up to the cap, minus up to a quarter of jitter
+    uint32_t backoff() {
+        uint32_t delay = LinkConfig::BACKOFF_BASE;
+        for (uint8_t i = 0; i < failures && delay < LinkConfig::BACKOFF_MAX; i++) delay *= 2;
+        if (delay > LinkConfig::BACKOFF_MAX) delay = LinkConfig::BACKOFF_MAX;
+        return delay - nextRandom() % (delay / 4 + 1);
+    }
+
+    void enter(State next, uint32_t now) {
+        current = next;
+        since = now;
+    }
+
+    void fail(State next, uint32_t now) {
+        stats.failures++;
+        if (failures < 16) failures++;
+        nextAttempt = now + backoff();
+        enter(next, now);
+    }
+
+public:
+    Manager()
+        : link(NULL), current(State::WIFI_DOWN), since(0), nextAttempt(0), failures(0),
+          seed(1), stats() {}
+
+    void begin(Link& hooks, uint32_t randomSeed, uint32_t now) {
+        link = &hooks;
+        seed = randomSeed ? randomSeed : 1;
+        nextAttempt = now;
+        enter(hooks.wifiConnected() ? State::WIFI_UP : State::WIFI_DOWN, now);
+    }
+
+    State poll(uint32_t now) {
+        if (!link) return current;
+        bool wifi = link->wifiConnected();
+        switch (current) {
+            case State::WIFI_DOWN:
+                if (wifi) {
+                    enter(State::WIFI_UP, now);
+                } else if (reached(now, nextAttempt)) {
+                    link->wifiBegin();
+                    stats.wifiAttempts++;
+                    enter(State::WIFI_JOINING, now);
+                }
+                break;
+            case State::WIFI_JOINING:
+                if (wifi) {
+                    enter(State::WIFI_UP, now);
+                } else if (now - since >= LinkConfig::WIFI_JOIN_TIMEOUT) {
+                    fail(State::WIFI_DOWN, now);
+                }
+                break;
+            case State::WIFI_UP:
+                if (!wifi) {
+                    enter(State::WIFI_DOWN, now);
+                } else if (reached(now, nextAttempt)) {
+                    link->mqttStart();
+                    stats.mqttAttempts++;
+                    enter(State::MQTT_CONNECTING, now);
+                }
+                break;
+            case State::MQTT_CONNECTING: {
+                // The connect task owns the client until it reports back
+                int8_t result = link->mqttResult();
+                if (result == 1) {
+                    failures = 0;
+                    stats.sessions++;
+                    if (link->subscribe()) stats.subscribes++;
+                    enter(State::ONLINE, now);
+                } else if (result == 0) {
+                    fail(wifi ? State::WIFI_UP : State::WIFI_DOWN, now);
+                }
+                break;
+            }
+            case State::ONLINE:
+                if (!wifi || !link->mqttConnected()) {
+                    link->mqttStop();
+                    nextAttempt = now + backoff();
+                    enter(wifi ? State::WIFI_UP : State::WIFI_DOWN, now);
+                }
+                break;
+        }
+        return current;
+    }
+
+    State state() const { return current; }
+    bool online() const { return current == State::ONLINE; }
+    uint32_t stateSince() const { return since; }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaLink
+
+#endif // PAPA_LINK_H
@@ -0,0 +1,244 @@
+#ifndef PAPA_METRICS_H
+#define PAPA_METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <atomic>
+#include "PapaConfig.h"
+#include "PapaJson.h"
+
+// Gateway instrumentation: counters and latency histograms updated from
+// the radio, publish and MQTT connect tasks without locks, rendered on
+// request as a Prometheus text page and periodically as a compact JSON
+// health message for gateways nobody scrapes:
+//
+//   {"Uptime":3600,"Online":1,"Rx":1234,"RxDrops":0,"Published":1301,"Failed":2,
+//    "Stored":2,"Backlog":0,"Waiting":0,"Connects":1,"ConnectFails":0,
+//    "ForwardP50":1000,"ForwardP99":5000,"Heap":123456,"RSSI":-61}
+//
+// Percentiles are the upper bound of their histogram bucket, in us.
+// Counters are 32 bit and wrap; Prometheus takes a wrap for a reset.
+namespace PapaMetrics {
+
+// Histogram upper bounds in us, 100 us to 10 s
+static const size_t BOUNDS = 14;
+static const uint32_t BOUNDS_US[BOUNDS] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000, 2500000, 10000000,
+};
+
+class Counter {
+private:
+    std::atomic<uint32_t> value{0};
+
+public:
+    void add(uint32_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Durations in fixed buckets; the last bucket is +Inf. Buckets, count and
+// sum are updated separately, so a page rendered mid-update may be one
+// observation apart between them.
+class Histogram {
+private:
+    std::atomic<uint32_t> buckets[BOUNDS + 1];
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> sum;      // us
+
+public:
+    Histogram() : count(0), sum(0) {
+        for (size_t i = 0; i <= BOUNDS; i++) buckets[i].store(0);
+    }
+
+    void record(uint32_t us) {
+        size_t i = 0;
+        while (i < BOUNDS && us > BOUNDS_US[i]) i++;
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(us, std::memory_order_relaxed);
+    }
+
+    uint32_t bucket(size_t i) const { return buckets[i].load(std::memory_order_relaxed); }
+    uint32_t observations() const { return count.load(std::memory_order_relaxed); }
+    uint32_t total() const { return sum.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding quantile q, 0 without observations;
+    // the last bound for the +Inf bucket
+    uint32_t quantile(float q) const {
+        uint32_t n = observations();
+        if (n == 0) return 0;
+        uint32_t rank = (uint32_t)(q * n + 0.5f);
+        if (rank == 0) rank = 1;
+        uint32_t seen = 0;
+        for (size_t i = 0; i < BOUNDS; i++) {
+            seen += bucket(i);
+            if (seen >= rank) return BOUNDS_US[i];
+        }
+        return BOUNDS_US[BOUNDS - 1];
+    }
+};
+
+struct Metrics {
+    // handleDuckData, radio task
+    Counter received;         // packets handed to the publish task
+    Counter receiveDrops;     // refused by a full receive queue
+    Histogram receiveTime;
+    // quackJson on live packets, publish task
+    Counter forwarded;        // live packets published in full
+    Counter published;        // MQTT messages taken by the publisher
+    Counter publishFailures;  // offline, publisher full or message too large
+    Counter stored;           // live packets kept for later
+    Counter queueDrops;       // oldest packets pushed out of the RAM queue
+    Histogram forwardTime;
+    // publishQueue and drainStore, publish task
+    Counter replayed;         // stored packets published
+    Histogram backlogTime;    // per RAM queue pass or store slice
+    // MQTT connect, connect task
+    Counter connects;
+    Counter connectFailures;
+    Histogram connectTime;
+};
+
+// Values sampled when a page or health message is rendered
+struct Gauges {
+    uint32_t uptime;          // s
+    bool online;
+    uint32_t sessions;        // MQTT sessions established
+    uint32_t waiting;         // packets in the receive queue
+    uint32_t queued;          // packets in the RAM queue
+    uint32_t backlog;         // packets in the store
+    uint32_t heap;            // free bytes
+    int32_t rssi;             // dBm, 0 offline
+};
+
+// Prometheus text exposition format 0.0.4 into a caller-owned buffer
+class Page {
+private:
+    char* out;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+
+    void print(const char* format, ...) {
+        if (overflow) return;
+        va_list args;
+        va_start(args, format);
+        int n = vsnprintf(out + length, capacity - length, format, args);
+        va_end(args);
+        if (n < 0 || (size_t)n >= capacity - length) {
+            overflow = true;
+        } else {
+            length += (size_t)n;
+        }
+    }
+
+public:
+    Page(char* out, size_t capacity) : out(out), capacity(capacity), length(0), overflow(capacity == 0) {
+        if (capacity) out[0] = '\0';
+    }
+
+    // # HELP and # TYPE lines heading the samples of one metric
+    void family(const char* name, const char* type, const char* help) {
+        print("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+    }
+
+    // One sample; labels without braces, e.g. "reason=\"full\""
+    void sample(const char* name, const char* labels, double value) {
+        if (labels) {
+            print("%s{%s} %.10g\n", name, labels, value);
+        } else {
+            print("%s %.10g\n", name, value);
+        }
+    }
+
+    void counter(const char* name, const char* help, uint32_t value) {
+        family(name, "counter", help);
+        sample(name, NULL, value);
+    }
+
+    void gauge(const char* name, const char* help, double value) {
+        family(name, "gauge", help);
+        sample(name, NULL, value);
+    }
+
+    // Cumulative buckets in seconds, then _sum and _count
+    void histogram(const char* name, const char* help, const Histogram& h) {
+        family(name, "histogram", help);
+        uint32_t cumulative = 0;
+        for (size_t i = 0; i < BOUNDS; i++) {
+            cumulative += h.bucket(i);
+            print("%s_bucket{le=\"%g\"} %u\n", name, BOUNDS_US[i] / 1e6, (unsigned)cumulative);
+        }
+        cumulative += h.bucket(BOUNDS);
+        print("%s_bucket{le=\"+Inf\"} %u\n", name, (unsigned)cumulative);
+        print("%s_sum %.6f\n%s_count %u\n", name, h.total() / 1e6, name, (unsigned)h.observations());
+    }
+
+    // Length of the page, or 0 if the buffer was too small
+    size_t finish() const { return overflow ? 0 : length; }
+};
+
+// The gateway's own metrics; the sketch appends the component counters
+inline void write(Page& page, const Metrics& m, const Gauges& g) {
+    page.gauge("papa_uptime_seconds", "Seconds since boot", g.uptime);
+    page.gauge("papa_online", "1 while the MQTT session is up", g.online ? 1 : 0);
+    page.counter("papa_mqtt_sessions_total", "MQTT sessions established", g.sessions);
+    page.gauge("papa_receive_queue_packets", "Packets waiting for the publish task", g.waiting);
+    page.gauge("papa_ram_queue_packets", "Packets queued in RAM without a store", g.queued);
+    page.gauge("papa_store_backlog_packets", "Packets waiting in the flash store", g.backlog);
+    page.gauge("papa_free_heap_bytes", "Free heap", g.heap);
+    page.gauge("papa_wifi_rssi_dbm", "WiFi signal, 0 when disconnected", g.rssi);
+
+    page.counter("papa_packets_received_total", "Packets received from the mesh", m.received.get());
+    page.family("papa_packets_dropped_total", "counter", "Packets lost at the gateway");
+    page.sample("papa_packets_dropped_total", "reason=\"receive_queue_full\"", m.receiveDrops.get());
+    page.sample("papa_packets_dropped_total", "reason=\"ram_queue_full\"", m.queueDrops.get());
+    page.counter("papa_packets_forwarded_total", "Live packets converted and published", m.forwarded.get());
+    page.counter("papa_packets_stored_total", "Live packets kept for later", m.stored.get());
+    page.counter("papa_packets_replayed_total", "Stored packets published", m.replayed.get());
+    page.counter("papa_mqtt_messages_total", "MQTT messages taken by the publisher", m.published.get());
+    page.counter("papa_mqtt_publish_failures_total", "MQTT messages that could not be published",
+                 m.publishFailures.get());
+    page.family("papa_mqtt_connects_total", "counter", "MQTT connect attempts");
+    page.sample("papa_mqtt_connects_total", "result=\"ok\"", m.connects.get());
+    page.sample("papa_mqtt_connects_total", "result=\"failed\"", m.connectFailures.get());
+
+    page.histogram("papa_receive_seconds", "Radio task time per received packet", m.receiveTime);
+    page.histogram("papa_forward_seconds", "Time to convert and publish a live packet", m.forwardTime);
+    page.histogram("papa_backlog_seconds", "Time per RAM queue pass or store slice", m.backlogTime);
+    page.histogram("papa_mqtt_connect_seconds", "Time per MQTT connect attempt", m.connectTime);
+}
+
+// {"Uptime","Online","Rx","RxDrops","Published","Failed","Stored","Backlog","Waiting",
+//  "Connects","ConnectFails","ForwardP50","ForwardP99","Heap","RSSI"}
+inline size_t serializeHealth(const Metrics& m, const Gauges& g, char* out, size_t capacity) {
+    PapaJson::Writer w(out, capacity);
+    const struct { const char* name; unsigned long value; } FIELDS[] = {
+        {"Uptime", g.uptime},
+        {"Online", g.online ? 1ul : 0ul},
+        {"Rx", m.received.get()},
+        {"RxDrops", m.receiveDrops.get() + (unsigned long)m.queueDrops.get()},
+        {"Published", m.published.get()},
+        {"Failed", m.publishFailures.get()},
+        {"Stored", m.stored.get()},
+        {"Backlog", g.backlog + (unsigned long)g.queued},
+        {"Waiting", g.waiting},
+        {"Connects", m.connects.get()},
+        {"ConnectFails", m.connectFailures.get()},
+        {"ForwardP50", m.forwardTime.quantile(0.5f)},
+        {"ForwardP99", m.forwardTime.quantile(0.99f)},
+        {"Heap", g.heap},
+    };
+    for (const auto& f : FIELDS) {
+        w.key(f.name);
+        w.number(f.value);
+    }
+    w.key("RSSI");
+    w.decimal(g.rssi, 0);
+    return w.finish();
+}
+
+} // namespace PapaMetrics
+
+#endif // PAPA_METRICS_H
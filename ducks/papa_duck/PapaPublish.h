@@ -0,0 +1,245 @@
+#ifndef PAPA_PUBLISH_H
+#define PAPA_PUBLISH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PapaConfig.h"
+
+// Batching, pipelining MQTT publisher for the PapaDuck.
+//
+// Pipelining: QoS 0 PUBLISH frames are encoded into one buffer and handed
+// to the transport in a single write, so a burst costs one TLS record
+// instead of one per message and nothing waits on an individual publish.
+//
+// Aggregation (optional): JSON objects for the same topic that arrive
+// within a window are joined into one JSON array message, up to the
+// broker's message size. A slot that holds a single object at flush time
+// is sent as that bare object, so quiet traffic keeps the per-packet
+// format.
+//
+// Urgent messages (fire alerts) flush their slot and the pipeline at once.
+namespace PapaPublish {
+
+using PapaConfig::PublishConfig;
+
+// Byte sink for encoded frames, the TLS client on the device. A short
+// write means the connection is unusable.
+class Sink {
+public:
+    virtual ~Sink() {}
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+};
+
+// MQTT 3.1.1 QoS 0 PUBLISH; returns the frame size, or 0 if it does not fit
+inline size_t encodeFrame(uint8_t* out, size_t capacity, const char* topic,
+                          const uint8_t* payload, size_t length) {
+    size_t topicLength = strlen(topic);
+    size_t remaining = 2 + topicLength + length;
+    uint8_t header[5];
+    size_t headerLength = 0;
+    header[headerLength++] = 0x30;
+    size_t value = remaining;
+    do {
+        uint8_t digit = value % 128;
+        value /= 128;
+        header[headerLength++] = digit | (value ? 0x80 : 0);
+    } while (value && headerLength < sizeof(header));
+    size_t total = headerLength + remaining;
+    if (value || topicLength > 0xFFFF || total > capacity) {
+        return 0;
+    }
+    memcpy(out, header, headerLength);
+    uint8_t* p = out + headerLength;
+    *p++ = (uint8_t)(topicLength >> 8);
+    *p++ = (uint8_t)(topicLength & 0xFF);
+    memcpy(p, topic, topicLength);
+    memcpy(p + topicLength, payload, length);
+    return total;
+}
+
+struct Policy {
+    bool aggregate;            // join messages per topic into JSON arrays
+    uint32_t aggregateWindow;  // ms an open array may wait
+    uint16_t maxAggregate;     // messages per array
+    uint32_t flushInterval;    // ms encoded frames may wait, 0 writes each at once
+};
+
+inline Policy defaultPolicy() {
+    Policy p = {PublishConfig::AGGREGATE, PublishConfig::AGGREGATE_WINDOW,
+                PublishConfig::MAX_AGGREGATE, PublishConfig::FLUSH_INTERVAL};
+    return p;
+}
+
+struct Stats {
+    uint32_t messages;   // JSON objects accepted
+    uint32_t frames;     // MQTT PUBLISH frames encoded
+    uint32_t writes;     // transport writes
+    uint32_t bytes;      // bytes written
+    uint32_t failures;   // short writes
+    uint32_t rejected;   // messages refused for lack of buffer
+};
+
+class Publisher {
+private:
+    struct Slot {
+        char topic[PublishConfig::TOPIC_SIZE];
+        char body[PublishConfig::MAX_MESSAGE];
+        size_t length;
+        uint16_t count;
+        uint32_t openedAt;
+    };
+
+    Sink* sink;
+    Policy policy;
+    Slot slots[PublishConfig::SLOTS];
+    uint8_t pipeline[PublishConfig::PIPELINE_SIZE];
+    size_t pipelined;
+    uint32_t pipelineSince;
+    Stats stats;
+
+    bool writePipeline() {
+        if (pipelined == 0) return true;
+        if (!sink) return false;
+        size_t written = sink->write(pipeline, pipelined);
+        if (written != pipelined) {
+            // Keep the frames; they go out again whole on the next session
+            stats.failures++;
+            return false;
+        }
+        stats.writes++;
+        stats.bytes += written;
+        pipelined = 0;
+        return true;
+    }
+
+    bool frame(const char* topic, const uint8_t* payload, size_t length, uint32_t now) {
+        size_t need = length + strlen(topic) + 7;
+        if (pipelined + need > sizeof(pipeline) && !writePipeline()) return false;
+        size_t size = encodeFrame(pipeline + pipelined, sizeof(pipeline) - pipelined, topic, payload, length);
+        if (size == 0) return false;
+        if (pipelined == 0) pipelineSince = now;
+        pipelined += size;
+        stats.frames++;
+        if (policy.flushInterval == 0) writePipeline();
+        return true;
+    }
+
+    // Frames an open slot: an array, or the bare object if it holds one
+    bool emit(Slot& slot, uint32_t now) {
+        if (slot.count == 0) return true;
+        bool sent;
+        if (slot.count == 1) {
+            sent = frame(slot.topic, (const uint8_t*)slot.body + 1, slot.length - 1, now);
+        } else {
+            slot.body[slot.length] = ']';
+            sent = frame(slot.topic, (const uint8_t*)slot.body, slot.length + 1, now);
+        }
+        if (sent) {
+            slot.count = 0;
+            slot.length = 0;
+        }
+        return sent;
+    }
+
+    Slot* slotFor(const char* topic, uint32_t now) {
+        Slot* oldest = NULL;
+        for (size_t i = 0; i < PublishConfig::SLOTS; i++) {
+            Slot& s = slots[i];
+            if (s.count && strcmp(s.topic, topic) == 0) return &s;
+        }
+        for (size_t i = 0; i < PublishConfig::SLOTS; i++) {
+            Slot& s = slots[i];
+            if (s.count == 0) return &s;
+            if (!oldest || (int32_t)(s.openedAt - oldest->openedAt) < 0) oldest = &s;
+        }
+        return emit(*oldest, now) ? oldest : NULL;
+    }
+
+    bool aggregate(const char* topic, const char* json, size_t length, uint32_t now, bool urgent) {
+        // '[' + objects joined by ',' + ']'
+        if (length + 2 > PublishConfig::MAX_MESSAGE || strlen(topic) >= PublishConfig::TOPIC_SIZE) {
+            return frame(topic, (const uint8_t*)json, length, now);
+        }
+        Slot* slot = slotFor(topic, now);
+        if (!slot) return false;
+        if (slot->count && slot->length + 1 + length + 1 > PublishConfig::MAX_MESSAGE &&
+            !emit(*slot, now)) {
+            return false;
+        }
+        if (slot->count == 0) {
+            strcpy(slot->topic, topic);
+            slot->body[0] = '[';
+            slot->length = 1;
+            slot->openedAt = now;
+        } else {
+            slot->body[slot->length++] = ',';
+        }
+        memcpy(slot->body + slot->length, json, length);
+        slot->length += length;
+        slot->count++;
+        if (urgent || slot->count >= policy.maxAggregate) {
+            emit(*slot, now);  // accepted either way, a failed emit is retried on poll
+        }
+        return true;
+    }
+
+public:
+    explicit Publisher(Sink* sink = NULL, const Policy& policy = defaultPolicy())
+        : sink(sink), policy(policy), pipelined(0), pipelineSince(0), stats() {
+        for (size_t i = 0; i < PublishConfig::SLOTS; i++) {
+            slots[i].length = 0;
+            slots[i].count = 0;
+        }
+    }
+
+    void begin(Sink* transport, const Policy& p = defaultPolicy()) {
+        sink = transport;
+        policy = p;
+    }
+
+    // Queues one JSON object; false if it could not be buffered
+    bool publish(const char* topic, const char* json, size_t length, uint32_t now, bool urgent = false) {
+        bool accepted = policy.aggregate
+            ? aggregate(topic, json, length, now, urgent)
+            : frame(topic, (const uint8_t*)json, length, now);
+        if (!accepted) {
+            stats.rejected++;
+            return false;
+        }
+        stats.messages++;
+        if (urgent) writePipeline();
+        return true;
+    }
+
+    // Applies the flush policy; call from loop()
+    void poll(uint32_t now) {
+        for (size_t i = 0; i < PublishConfig::SLOTS; i++) {
+            Slot& s = slots[i];
+            if (s.count && now - s.openedAt >= policy.aggregateWindow) emit(s, now);
+        }
+        if (pipelined && now - pipelineSince >= policy.flushInterval) writePipeline();
+    }
+
+    // Sends everything buffered; false if frames are still waiting
+    bool flush(uint32_t now) {
+        for (size_t i = 0; i < PublishConfig::SLOTS; i++) {
+            emit(slots[i], now);
+        }
+        return writePipeline();
+    }
+
+    // True while messages wait in a slot or in the pipeline
+    bool pending() const {
+        for (size_t i = 0; i < PublishConfig::SLOTS; i++) {
+            if (slots[i].count) return true;
+        }
+        return pipelined != 0;
+    }
+
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaPublish
+
+#endif // PAPA_PUBLISH_H
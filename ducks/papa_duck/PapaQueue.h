@@ -0,0 +1,94 @@
+#ifndef PAPA_QUEUE_H
+#define PAPA_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+// Hand-off between the PapaDuck radio and publish tasks.
+namespace PapaQueue {
+
+struct Stats {
+    uint32_t pushed;
+    uint32_t popped;
+    uint32_t overflows;   // refused, every slot was waiting
+    uint32_t oversize;    // refused, larger than a slot
+    uint32_t highWater;   // most slots waiting at once
+};
+
+// Lock-free single-producer/single-consumer ring of preallocated packet
+// slots. push() copies into the next free slot; the consumer reads the
+// front slot in place and releases it with pop(). Only one task may push
+// and only one task may call front()/pop(). Producer counters are written
+// by the producer only, popped by the consumer only.
+template <size_t N, size_t SLOT_SIZE>
+class PacketRing {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "PacketRing size must be a power of two");
+
+public:
+    struct Slot {
+        uint16_t length;
+        uint8_t data[SLOT_SIZE];
+    };
+
+private:
+    Slot slots[N];
+    std::atomic<uint32_t> head{0};  // advanced by the producer
+    std::atomic<uint32_t> tail{0};  // advanced by the consumer
+    Stats stats = {};
+
+public:
+    bool push(const uint8_t* data, size_t length) {
+        if (length > SLOT_SIZE) {
+            stats.oversize++;
+            return false;
+        }
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t used = h - tail.load(std::memory_order_acquire);
+        if (used >= N) {
+            stats.overflows++;
+            return false;
+        }
+        Slot& slot = slots[h & (N - 1)];
+        memcpy(slot.data, data, length);
+        slot.length = (uint16_t)length;
+        head.store(h + 1, std::memory_order_release);
+        stats.pushed++;
+        if (used + 1 > stats.highWater) {
+            stats.highWater = used + 1;
+        }
+        return true;
+    }
+
+    // Oldest waiting slot, or nullptr if the ring is empty
+    const Slot* front() const {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &slots[t & (N - 1)];
+    }
+
+    void pop() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) {
+            return;
+        }
+        tail.store(t + 1, std::memory_order_release);
+        stats.popped++;
+    }
+
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static size_t capacity() { return N; }
+
+    // A snapshot for logging; fields may be one update apart
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaQueue
+
+#endif // PAPA_QUEUE_H
@@ -0,0 +1,91 @@
+#ifndef PAPA_SEQUENCE_H
+#define PAPA_SEQUENCE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PapaConfig.h"
+#include "DuckSequence.h"
+
+// Per-device DuckSequence receivers for the acks the gateway sends back.
+//
+// Each sequenced packet the gateway has published or stored updates its
+// device's receiver, which yields the ack to send; a resend of something
+// already forwarded is only acked again. The table is fixed size: a new device takes the
+// slot idle the longest, and the evicted device resyncs on its next packet.
+namespace PapaSequence {
+
+using PapaConfig::SequenceConfig;
+
+struct Stats {
+    DuckSequence::ReceiverStats packets;
+    uint32_t evictions;
+};
+
+template <size_t N = SequenceConfig::DEVICES>
+class Table {
+private:
+    struct Device {
+        uint8_t id[SequenceConfig::ID_SIZE];
+        uint8_t idLength;   // 0 marks a free slot
+        uint32_t lastSeen;
+        DuckSequence::Receiver receiver;
+    };
+
+    Device devices[N];
+    Stats stats;
+
+    Device* find(const uint8_t* id, size_t length) {
+        if (length > SequenceConfig::ID_SIZE) length = SequenceConfig::ID_SIZE;
+        Device* victim = NULL;
+        for (size_t i = 0; i < N; i++) {
+            Device& d = devices[i];
+            if (d.idLength == length && memcmp(d.id, id, length) == 0) return &d;
+            if (!victim || !d.idLength || (victim->idLength && (int32_t)(d.lastSeen - victim->lastSeen) < 0)) {
+                victim = &d;
+            }
+        }
+        if (victim->idLength) stats.evictions++;
+        memcpy(victim->id, id, length);
+        victim->idLength = (uint8_t)length;
+        victim->receiver.reset();
+        return victim;
+    }
+
+public:
+    Table() : stats() {
+        for (size_t i = 0; i < N; i++) devices[i].idLength = 0;
+    }
+
+    // Whether the packet is a resend of one already received, without
+    // recording it; if so the ack to repeat is filled in
+    bool received(const uint8_t* id, size_t length, uint16_t sequence, DuckSequence::Ack& ack) {
+        if (length > SequenceConfig::ID_SIZE) length = SequenceConfig::ID_SIZE;
+        for (size_t i = 0; i < N; i++) {
+            Device& d = devices[i];
+            if (d.idLength != length || memcmp(d.id, id, length) != 0) continue;
+            if (!d.receiver.received(sequence)) return false;
+            stats.packets.duplicates++;
+            ack = d.receiver.ack();
+            return true;
+        }
+        return false;
+    }
+
+    // Records the packet and fills in the ack for its sender; false if the
+    // packet was already received
+    bool receive(const uint8_t* id, size_t length, uint16_t sequence, uint32_t now, DuckSequence::Ack& ack) {
+        Device* d = find(id, length);
+        d->lastSeen = now;
+        bool fresh = d->receiver.receive(sequence, stats.packets);
+        ack = d->receiver.ack();
+        return fresh;
+    }
+
+    static size_t capacity() { return N; }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaSequence
+
+#endif // PAPA_SEQUENCE_H
@@ -0,0 +1,365 @@
+#ifndef PAPA_STORE_H
+#define PAPA_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Persistent store-and-forward log for packets the PapaDuck could not
+// publish. Packets are appended to a ring of flash sectors and survive a
+// reboot; the drain side reads them back oldest first.
+//
+// Each sector starts with {u32 sequence, u32 MAGIC}; the sector with the
+// highest sequence is the head being written, the lowest is the oldest
+// data. Records are 4-byte aligned:
+//   u16 length, u8 check, u8 state, u32 CRC-32 of the data, data
+// state is 0xFF while the record waits and is cleared to 0x00 in place
+// once it has been published, so the read cursor is persisted without a
+// separate cursor sector. A torn append fails its check or CRC and is
+// skipped. When the ring is full the oldest sector is erased and its
+// unsent records are counted as dropped.
+namespace PapaStore {
+
+static const uint32_t MAGIC = 0x4B435544;  // "DUCK"
+static const size_t SECTOR_HEADER_SIZE = 8;
+static const size_t RECORD_HEADER_SIZE = 8;
+static const size_t MAX_RECORD = 512;      // largest CDP packet and the gateway's progress on it
+static const uint8_t STATE_PENDING = 0xFF;
+static const uint8_t STATE_SENT = 0x00;
+
+// Raw access to an erasable flash region. Like NOR flash, a write can
+// only clear bits and erase sets a whole sector back to 0xFF.
+class Flash {
+public:
+    virtual ~Flash() {}
+    virtual size_t size() const = 0;
+    virtual size_t sectorSize() const = 0;
+    virtual bool read(size_t address, void* buffer, size_t length) = 0;
+    virtual bool write(size_t address, const void* data, size_t length) = 0;
+    virtual bool erase(size_t address) = 0;  // sector containing address
+};
+
+// CRC-32 (IEEE 802.3), nibble table
+inline uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static const uint32_t TABLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc = TABLE[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = TABLE[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+inline size_t recordSize(size_t length) {
+    return (RECORD_HEADER_SIZE + length + 3) & ~(size_t)3;
+}
+
+struct Stats {
+    uint32_t appended;   // records written
+    uint32_t forwarded;  // records published and marked sent
+    uint32_t dropped;    // unsent records lost to ring overwrite
+    uint32_t corrupt;    // records skipped on a CRC mismatch
+    uint32_t erases;     // sector erases
+};
+
+class RingLog {
+private:
+    struct RecordHeader {
+        uint16_t length;
+        uint8_t check;
+        uint8_t state;
+        uint32_t crc;
+    };
+
+    enum class Slot { END, RECORD, BROKEN };
+
+    Flash* flash;
+    size_t sectorBytes;
+    size_t sectors;
+    size_t headSector;
+    uint32_t headSequence;
+    size_t writeOffset;
+    size_t readSector;   // also the oldest sector still holding data
+    size_t readOffset;
+    uint32_t pendingCount;
+    Stats stats;
+
+    static uint8_t checkByte(uint16_t length) {
+        return (uint8_t)((length ^ (length >> 8)) ^ 0xA5);
+    }
+
+    size_t address(size_t sector, size_t offset) const {
+        return sector * sectorBytes + offset;
+    }
+
+    size_t next(size_t sector) const {
+        return (sector + 1) % sectors;
+    }
+
+    // Classifies the slot at offset; next is the offset after a record
+    Slot slotAt(size_t sector, size_t offset, RecordHeader& h, size_t& nextOffset) {
+        if (offset + RECORD_HEADER_SIZE > sectorBytes ||
+            !flash->read(address(sector, offset), &h, sizeof(h))) {
+            return Slot::END;
+        }
+        if (h.length == 0xFFFF && h.check == 0xFF && h.state == 0xFF && h.crc == 0xFFFFFFFF) {
+            return Slot::END;
+        }
+        nextOffset = offset + recordSize(h.length);
+        if (h.length == 0 || h.length > MAX_RECORD || h.check != checkByte(h.length) ||
+            nextOffset > sectorBytes) {
+            return Slot::BROKEN;
+        }
+        return Slot::RECORD;
+    }
+
+    // Offset where the next record in a sector goes; a broken header makes
+    // the rest of the sector unusable
+    size_t endOf(size_t sector) {
+        size_t offset = SECTOR_HEADER_SIZE;
+        RecordHeader h;
+        size_t nextOffset;
+        for (;;) {
+            Slot slot = slotAt(sector, offset, h, nextOffset);
+            if (slot == Slot::END) return offset;
+            if (slot == Slot::BROKEN) return sectorBytes;
+            offset = nextOffset;
+        }
+    }
+
+    uint32_t countPending(size_t sector) {
+        uint32_t count = 0;
+        size_t offset = SECTOR_HEADER_SIZE;
+        RecordHeader h;
+        size_t nextOffset;
+        while (slotAt(sector, offset, h, nextOffset) == Slot::RECORD) {
+            if (h.state == STATE_PENDING) count++;
+            offset = nextOffset;
+        }
+        return count;
+    }
+
+    enum class SectorState { FREE, USED, TORN };
+
+    SectorState readSectorHeader(size_t sector, uint32_t& sequence) {
+        uint32_t header[2];
+        if (!flash->read(address(sector, 0), header, sizeof(header))) return SectorState::TORN;
+        sequence = header[0];
+        if (header[1] == MAGIC) return SectorState::USED;
+        return header[0] == 0xFFFFFFFF && header[1] == 0xFFFFFFFF ? SectorState::FREE : SectorState::TORN;
+    }
+
+    bool format(size_t sector, uint32_t sequence) {
+        stats.erases++;
+        if (!flash->erase(address(sector, 0))) return false;
+        // Sequence first, magic last: a sector with a magic has a whole header
+        uint32_t magic = MAGIC;
+        return flash->write(address(sector, 0), &sequence, sizeof(sequence)) &&
+               flash->write(address(sector, 4), &magic, sizeof(magic));
+    }
+
+    bool openNextSector() {
+        size_t target = next(headSector);
+        if (target == readSector) {
+            // Ring full, give up the oldest sector
+            uint32_t lost = countPending(readSector);
+            stats.dropped += lost;
+            pendingCount -= lost < pendingCount ? lost : pendingCount;
+            readSector = next(readSector);
+            readOffset = SECTOR_HEADER_SIZE;
+        }
+        if (!format(target, headSequence + 1)) return false;
+        headSector = target;
+        headSequence++;
+        writeOffset = SECTOR_HEADER_SIZE;
+        return true;
+    }
+
+    // Moves the read cursor past a finished sector and erases it
+    void releaseReadSector() {
+        size_t done = readSector;
+        readSector = next(readSector);
+        readOffset = SECTOR_HEADER_SIZE;
+        stats.erases++;
+        flash->erase(address(done, 0));
+    }
+
+public:
+    RingLog()
+        : flash(NULL), sectorBytes(0), sectors(0), headSector(0), headSequence(0),
+          writeOffset(0), readSector(0), readOffset(0), pendingCount(0), stats() {}
+
+    // Recovers head, read cursor and backlog from flash; formats a blank region
+    bool begin(Flash& region) {
+        flash = &region;
+        sectorBytes = region.sectorSize();
+        sectors = sectorBytes ? region.size() / sectorBytes : 0;
+        if (sectors < 2 || sectorBytes < SECTOR_HEADER_SIZE + recordSize(MAX_RECORD)) {
+            flash = NULL;
+            return false;
+        }
+
+        bool found = false;
+        uint32_t oldest = 0;
+        for (size_t s = 0; s < sectors; s++) {
+            uint32_t sequence;
+            SectorState state = readSectorHeader(s, sequence);
+            if (state == SectorState::TORN) {
+                // Header write was interrupted, the sector never held records
+                stats.erases++;
+                flash->erase(address(s, 0));
+            }
+            if (state != SectorState::USED) continue;
+            if (!found || sequence > headSequence) {
+                headSector = s;
+                headSequence = sequence;
+            }
+            if (!found || sequence < oldest) {
+                readSector = s;
+                oldest = sequence;
+            }
+            found = true;
+        }
+
+        if (!found) {
+            headSector = readSector = 0;
+            headSequence = 1;
+            if (!format(0, headSequence)) {
+                flash = NULL;
+                return false;
+            }
+        }
+
+        writeOffset = endOf(headSector);
+        readOffset = SECTOR_HEADER_SIZE;
+        pendingCount = 0;
+        for (size_t s = readSector;; s = next(s)) {
+            pendingCount += countPending(s);
+            if (s == headSector) break;
+        }
+        return true;
+    }
+
+    bool ready() const { return flash != NULL; }
+
+    bool append(const uint8_t* data, size_t length) {
+        if (!flash || length == 0 || length > MAX_RECORD) return false;
+        size_t size = recordSize(length);
+        if (writeOffset + size > sectorBytes && !openNextSector()) return false;
+
+        uint8_t record[RECORD_HEADER_SIZE + MAX_RECORD + 3];
+        RecordHeader h;
+        h.length = (uint16_t)length;
+        h.check = checkByte(h.length);
+        h.state = STATE_PENDING;
+        h.crc = crc32(data, length);
+        memcpy(record, &h, sizeof(h));
+        memcpy(record + RECORD_HEADER_SIZE, data, length);
+        memset(record + RECORD_HEADER_SIZE + length, 0xFF, size - RECORD_HEADER_SIZE - length);
+
+        if (!flash->write(address(headSector, writeOffset), record, size)) {
+            // Whatever made it to flash fails its check; start a new sector
+            writeOffset = sectorBytes;
+            return false;
+        }
+        writeOffset += size;
+        pendingCount++;
+        stats.appended++;
+        return true;
+    }
+
+    // Copies the oldest unsent record without consuming it
+    bool peek(uint8_t* buffer, size_t capacity, size_t& length) {
+        if (!flash) return false;
+        RecordHeader h;
+        size_t nextOffset;
+        for (;;) {
+            if (readSector == headSector && readOffset >= writeOffset) return false;
+            Slot slot = slotAt(readSector, readOffset, h, nextOffset);
+            if (slot != Slot::RECORD) {
+                if (readSector == headSector) return false;
+                releaseReadSector();
+                continue;
+            }
+            if (h.state == STATE_PENDING) {
+                if (h.length <= capacity &&
+                    flash->read(address(readSector, readOffset + RECORD_HEADER_SIZE), buffer, h.length) &&
+                    crc32(buffer, h.length) == h.crc) {
+                    length = h.length;
+                    return true;
+                }
+                // Mark it so it is not counted again after a reboot
+                stats.corrupt++;
+                if (pendingCount) pendingCount--;
+                uint8_t sent = STATE_SENT;
+                flash->write(address(readSector, readOffset + 3), &sent, 1);
+            }
+            readOffset = nextOffset;
+        }
+    }
+
+    // Marks the record returned by the last peek as published
+    void consume() {
+        if (!flash) return;
+        RecordHeader h;
+        size_t nextOffset;
+        if (slotAt(readSector, readOffset, h, nextOffset) != Slot::RECORD) return;
+        uint8_t sent = STATE_SENT;
+        flash->write(address(readSector, readOffset + 3), &sent, 1);
+        readOffset = nextOffset;
+        if (pendingCount) pendingCount--;
+        stats.forwarded++;
+    }
+
+    uint32_t pending() const { return pendingCount; }
+    const Stats& counters() const { return stats; }
+    size_t capacity() const { return sectors * sectorBytes; }
+
+    // Sectors holding data, as a percentage of the ring
+    uint8_t fillPercent() const {
+        if (!sectors) return 0;
+        size_t used = (headSector + sectors - readSector) % sectors + 1;
+        return (uint8_t)(used * 100 / sectors);
+    }
+};
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <esp_partition.h>
+
+// Flash backend on a raw data partition, see partitions_duckstore_*.csv
+class PartitionFlash : public Flash {
+private:
+    const esp_partition_t* partition;
+
+public:
+    PartitionFlash() : partition(NULL) {}
+
+    bool begin(const char* label) {
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+        return partition != NULL;
+    }
+
+    size_t size() const override { return partition ? partition->size : 0; }
+    size_t sectorSize() const override { return SPI_FLASH_SEC_SIZE; }
+
+    bool read(size_t address, void* buffer, size_t length) override {
+        return esp_partition_read(partition, address, buffer, length) == ESP_OK;
+    }
+
+    bool write(size_t address, const void* data, size_t length) override {
+        return esp_partition_write(partition, address, data, length) == ESP_OK;
+    }
+
+    bool erase(size_t address) override {
+        size_t start = address - address % SPI_FLASH_SEC_SIZE;
+        return esp_partition_erase_range(partition, start, SPI_FLASH_SEC_SIZE) == ESP_OK;
+    }
+};
+#endif
+
+} // namespace PapaStore
+
+#endif // PAPA_STORE_H
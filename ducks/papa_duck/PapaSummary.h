@@ -0,0 +1,202 @@
+#ifndef PAPA_SUMMARY_H
+#define PAPA_SUMMARY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PapaConfig.h"
+#include "PapaJson.h"
+#include "DuckPayload.h"
+
+// Per-device rolling summaries of the live telemetry the gateway hears.
+//
+// Every reading updates its device's running min/max/sum/last of each
+// sensor field and the prediction counts. Once per interval each device
+// with readings becomes one compact JSON message on its own topic, so the
+// cloud can serve long ranges without the raw rows:
+//
+//   {"DeviceID":"DUCK0001","Window":300,"Readings":30,"Fire":2,"Counter":1234,
+//    "Temp":[min,max,mean,last],"Hum":[...],"Press":[...],"Gas":[...],
+//    "Lat":33.42123,"Lng":-111.9281}
+//
+// Window is the seconds the summary covers; a summary that could not be
+// published keeps accumulating into the next one. Lat/Lng are the last
+// known fix and only present once the device has had one. The table is
+// fixed size: a new device takes the slot idle the longest, preferring
+// slots with nothing pending.
+namespace PapaSummary {
+
+using PapaConfig::SummaryConfig;
+
+struct Field {
+    float min;
+    float max;
+    float last;
+    double sum;
+
+    void add(float value, bool first) {
+        if (first) sum = 0;
+        if (first || value < min) min = value;
+        if (first || value > max) max = value;
+        last = value;
+        sum += value;
+    }
+};
+
+struct Device {
+    uint8_t id[SummaryConfig::ID_SIZE];
+    uint8_t idLength;   // 0 marks a free slot
+    uint32_t windowStart;
+    uint32_t lastSeen;
+    uint16_t readings;
+    uint16_t fire;
+    uint32_t counter;
+    bool hasGPS;
+    double latitude;
+    double longitude;
+    Field temp;
+    Field humidity;
+    Field pressure;
+    Field gas;
+};
+
+struct Stats {
+    uint32_t readings;
+    uint32_t summaries;
+    uint32_t evictions;       // devices displaced from a full table
+    uint32_t lostReadings;    // pending readings of evicted devices
+};
+
+// {"DeviceID","Window","Readings","Fire","Counter","Temp","Hum","Press","Gas"[,"Lat","Lng"]}
+inline size_t serialize(const Device& d, uint32_t now, char* out, size_t capacity) {
+    PapaJson::Writer w(out, capacity);
+    w.key("DeviceID");
+    w.string(PapaJson::span(d.id, d.idLength));
+    w.key("Window");
+    w.number((now - d.windowStart + 500) / 1000);
+    w.key("Readings");
+    w.number(d.readings);
+    w.key("Fire");
+    w.number(d.fire);
+    w.key("Counter");
+    w.number(d.counter);
+    const struct { const char* name; const Field& field; uint8_t places; } FIELDS[] = {
+        {"Temp", d.temp, 2},
+        {"Hum", d.humidity, 3},
+        {"Press", d.pressure, 2},
+        {"Gas", d.gas, 2},
+    };
+    for (const auto& f : FIELDS) {
+        double values[4] = {f.field.min, f.field.max, f.field.sum / d.readings, f.field.last};
+        w.key(f.name);
+        w.decimals(values, 4, f.places);
+    }
+    if (d.hasGPS) {
+        w.key("Lat");
+        w.decimal(d.latitude, 5);
+        w.key("Lng");
+        w.decimal(d.longitude, 4);
+    }
+    return w.finish();
+}
+
+template <size_t N = SummaryConfig::DEVICES>
+class Table {
+private:
+    Device devices[N];
+    uint32_t lastFlush;
+    Stats stats;
+
+    Device* find(const uint8_t* id, size_t length, uint32_t now) {
+        if (length > SummaryConfig::ID_SIZE) length = SummaryConfig::ID_SIZE;
+        Device* victim = NULL;
+        for (size_t i = 0; i < N; i++) {
+            Device& d = devices[i];
+            if (d.idLength == length && memcmp(d.id, id, length) == 0) return &d;
+            if (!victim || better(d, *victim)) victim = &d;
+        }
+        if (victim->idLength) {
+            stats.evictions++;
+            stats.lostReadings += victim->readings;
+        }
+        memcpy(victim->id, id, length);
+        victim->idLength = (uint8_t)length;
+        victim->readings = 0;
+        victim->windowStart = now;
+        victim->hasGPS = false;
+        return victim;
+    }
+
+    // Slot preference for a new device: free, then idle with nothing
+    // pending, then idle the longest
+    static bool better(const Device& a, const Device& b) {
+        if (!a.idLength || !b.idLength) return !a.idLength && b.idLength;
+        if ((a.readings == 0) != (b.readings == 0)) return a.readings == 0;
+        return (int32_t)(a.lastSeen - b.lastSeen) < 0;
+    }
+
+public:
+    Table() : lastFlush(0), stats() {
+        for (size_t i = 0; i < N; i++) {
+            devices[i].idLength = 0;
+            devices[i].readings = 0;
+        }
+    }
+
+    void begin(uint32_t now) { lastFlush = now; }
+
+    void add(const uint8_t* id, size_t length, const DuckPayload::Reading& r, uint32_t now) {
+        if (length == 0) return;
+        Device* d = find(id, length, now);
+        bool first = d->readings == 0;
+        if (first) {
+            d->windowStart = now;
+            d->fire = 0;
+        }
+        d->temp.add(r.temp, first);
+        d->humidity.add(r.humidity, first);
+        d->pressure.add(r.pressure, first);
+        d->gas.add(r.gas, first);
+        if (r.prediction == 1) d->fire++;
+        if (r.hasGPS) {
+            d->hasGPS = true;
+            d->latitude = r.latitude;
+            d->longitude = r.longitude;
+        }
+        d->counter = r.counter;
+        d->lastSeen = now;
+        if (d->readings < 0xFFFF) d->readings++;
+        stats.readings++;
+    }
+
+    bool due(uint32_t now) const { return now - lastFlush >= SummaryConfig::INTERVAL; }
+
+    // Serializes each pending summary into buffer and hands it to
+    // emit(json, length); a device is reset only once emit returns true
+    template <typename Emit>
+    void flush(uint32_t now, char* buffer, size_t capacity, Emit emit) {
+        lastFlush = now;
+        for (size_t i = 0; i < N; i++) {
+            Device& d = devices[i];
+            if (!d.idLength || d.readings == 0) continue;
+            size_t length = serialize(d, now, buffer, capacity);
+            if (length && emit(buffer, length)) {
+                d.readings = 0;
+                stats.summaries++;
+            }
+        }
+    }
+
+    size_t tracked() const {
+        size_t n = 0;
+        for (size_t i = 0; i < N; i++) n += devices[i].idLength != 0;
+        return n;
+    }
+
+    static size_t capacity() { return N; }
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaSummary
+
+#endif // PAPA_SUMMARY_H
@@ -0,0 +1,416 @@
+#ifndef PAPA_TLS_H
+#define PAPA_TLS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "PapaConfig.h"
+#include "PapaStore.h"
+
+// TLS session resumption for the MQTT uplink.
+//
+// After a full handshake the negotiated session (session ID or ticket and
+// master secret) is serialized into a SessionBlob. The blob lives in RTC
+// memory, so it survives reconnects, software resets and deep sleep; on
+// the next connect it is offered to the broker and, if accepted, the
+// handshake skips the certificate exchange, both signatures and the key
+// agreement. A rejected or stale session costs nothing extra: the broker
+// falls back to a full handshake and the new session replaces the old.
+namespace PapaTls {
+
+using PapaConfig::TlsConfig;
+
+static const uint32_t SESSION_MAGIC = 0x53534C54;  // "TLSS"
+
+// Plain struct so it can sit in RTC_NOINIT memory; contents are garbage
+// after a power-on, which the magic and CRC catch
+struct SessionBlob {
+    uint32_t magic;
+    uint32_t crc;
+    uint16_t length;
+    uint8_t data[TlsConfig::SESSION_SIZE];
+};
+
+struct Stats {
+    uint32_t handshakes;
+    uint32_t resumed;      // handshakes that reused the cached session
+    uint32_t saved;
+    uint32_t invalid;      // blobs rejected on load
+};
+
+class SessionCache {
+private:
+    SessionBlob* blob;
+
+    uint32_t checksum() const {
+        uint32_t crc = PapaStore::crc32((const uint8_t*)&blob->length, sizeof(blob->length));
+        return PapaStore::crc32(blob->data, blob->length, crc);
+    }
+
+public:
+    SessionCache() : blob(NULL) {}
+
+    void begin(SessionBlob& storage) { blob = &storage; }
+
+    bool valid() const {
+        return blob && blob->magic == SESSION_MAGIC && blob->length > 0 &&
+               blob->length <= sizeof(blob->data) && blob->crc == checksum();
+    }
+
+    // Invalidates the cached session and hands out its buffer, so a new
+    // one can be serialized in place and sealed with commit()
+    uint8_t* prepare(size_t& capacity) {
+        if (!blob) return NULL;
+        blob->magic = 0;
+        capacity = sizeof(blob->data);
+        return blob->data;
+    }
+
+    bool commit(size_t length) {
+        if (!blob || length == 0 || length > sizeof(blob->data)) return false;
+        blob->length = (uint16_t)length;
+        blob->crc = checksum();
+        blob->magic = SESSION_MAGIC;
+        return true;
+    }
+
+    bool store(const uint8_t* data, size_t length) {
+        size_t capacity = 0;
+        uint8_t* buffer = prepare(capacity);
+        if (!buffer || length > capacity) return false;
+        memcpy(buffer, data, length);
+        return commit(length);
+    }
+
+    // The cached session, or NULL
+    const uint8_t* load(size_t& length) const {
+        if (!valid()) return NULL;
+        length = blob->length;
+        return blob->data;
+    }
+
+    void clear() {
+        if (blob) blob->magic = 0;
+    }
+};
+
+} // namespace PapaTls
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include <Arduino.h>
+#include <errno.h>
+#include <Client.h>
+#include <IPAddress.h>
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include <mbedtls/version.h>
+#include <mbedtls/ssl.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/x509_crt.h>
+#include <mbedtls/pk.h>
+
+namespace PapaTls {
+
+// Drop-in for WiFiClientSecure as PubSubClient's transport, with the
+// mbedTLS handshake driven here so a cached session can be set between
+// ssl_setup and the handshake, which WiFiClientSecure does not allow.
+// connect() runs in the connect task, everything else in the publish task.
+class TlsClient : public Client {
+private:
+    mbedtls_ssl_context ssl;
+    mbedtls_ssl_config conf;
+    mbedtls_net_context net;
+    mbedtls_ctr_drbg_context drbg;
+    mbedtls_entropy_context entropy;
+    mbedtls_x509_crt ca;
+    mbedtls_x509_crt cert;
+    mbedtls_pk_context key;
+
+    const char* caPem;
+    const char* certPem;
+    const char* keyPem;
+    bool insecure;
+    bool configured;
+    bool open;
+    uint32_t handshakeTimeout;  // ms
+    SessionCache cache;
+    Stats stats;
+
+    uint8_t rx[TlsConfig::RX_BUFFER];
+    size_t rxStart;
+    size_t rxEnd;
+
+    // A resumed handshake keeps the master secret of the offered session
+    unsigned char offeredMaster[48];
+    bool offered;
+
+    bool configure() {
+        if (configured) return true;
+        mbedtls_ssl_config_init(&conf);
+        mbedtls_ctr_drbg_init(&drbg);
+        mbedtls_entropy_init(&entropy);
+        mbedtls_x509_crt_init(&ca);
+        mbedtls_x509_crt_init(&cert);
+        mbedtls_pk_init(&key);
+        if (mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, NULL, 0) != 0) return false;
+        if (mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                        MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+            return false;
+        }
+        mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &drbg);
+        if (insecure || !caPem) {
+            mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_NONE);
+        } else {
+            if (mbedtls_x509_crt_parse(&ca, (const unsigned char*)caPem, strlen(caPem) + 1) != 0) return false;
+            mbedtls_ssl_conf_ca_chain(&conf, &ca, NULL);
+            mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+        }
+        if (certPem && keyPem) {
+            if (mbedtls_x509_crt_parse(&cert, (const unsigned char*)certPem, strlen(certPem) + 1) != 0) return false;
+#if MBEDTLS_VERSION_NUMBER >= 0x03000000
+            if (mbedtls_pk_parse_key(&key, (const unsigned char*)keyPem, strlen(keyPem) + 1, NULL, 0,
+                                     mbedtls_ctr_drbg_random, &drbg) != 0) {
+                return false;
+            }
+#else
+            if (mbedtls_pk_parse_key(&key, (const unsigned char*)keyPem, strlen(keyPem) + 1, NULL, 0) != 0) {
+                return false;
+            }
+#endif
+            if (mbedtls_ssl_conf_own_cert(&conf, &cert, &key) != 0) return false;
+        }
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+        mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+        mbedtls_ssl_init(&ssl);
+        if (mbedtls_ssl_setup(&ssl, &conf) != 0) return false;
+        mbedtls_net_init(&net);
+        configured = true;
+        return true;
+    }
+
+    // Non-blocking TCP connect bounded by the handshake timeout
+    bool openSocket(const char* host, uint16_t port, uint32_t deadline) {
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        char service[6];
+        snprintf(service, sizeof(service), "%u", (unsigned)port);
+        struct addrinfo* found = NULL;
+        if (getaddrinfo(host, service, &hints, &found) != 0 || !found) return false;
+        int fd = socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+        if (fd < 0) {
+            freeaddrinfo(found);
+            return false;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        int result = ::connect(fd, found->ai_addr, found->ai_addrlen);
+        freeaddrinfo(found);
+        if (result != 0 && errno != EINPROGRESS) {
+            close(fd);
+            return false;
+        }
+        if (result != 0 && !waitFor(fd, true, deadline)) {
+            close(fd);
+            return false;
+        }
+        int error = 0;
+        socklen_t length = sizeof(error);
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0) {
+            close(fd);
+            return false;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        net.fd = fd;
+        return true;
+    }
+
+    static bool waitFor(int fd, bool writable, uint32_t deadline) {
+        int32_t left = (int32_t)(deadline - millis());
+        if (left <= 0) return false;
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        struct timeval tv = {left / 1000, (left % 1000) * 1000};
+        return select(fd + 1, writable ? NULL : &set, writable ? &set : NULL, NULL, &tv) > 0;
+    }
+
+    void offerSession() {
+        size_t length = 0;
+        const uint8_t* blob = cache.load(length);
+        if (!blob) return;
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        if (mbedtls_ssl_session_load(&session, blob, length) != 0 || mbedtls_ssl_set_session(&ssl, &session) != 0) {
+            cache.clear();
+            stats.invalid++;
+        } else {
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+            memcpy(offeredMaster, session.master, sizeof(offeredMaster));
+            offered = true;
+#endif
+        }
+        mbedtls_ssl_session_free(&session);
+    }
+
+    void saveSession() {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        size_t capacity = 0, length = 0;
+        uint8_t* buffer = cache.prepare(capacity);
+        if (buffer && mbedtls_ssl_get_session(&ssl, &session) == 0 &&
+            mbedtls_ssl_session_save(&session, buffer, capacity, &length) == 0 && cache.commit(length)) {
+            stats.saved++;
+        }
+        mbedtls_ssl_session_free(&session);
+    }
+
+    // Reads what the socket has without blocking
+    void fill() {
+        if (!open || rxStart < rxEnd) return;
+        rxStart = rxEnd = 0;
+        int n = mbedtls_ssl_read(&ssl, rx, sizeof(rx));
+        if (n > 0) {
+            rxEnd = (size_t)n;
+        } else if (n != MBEDTLS_ERR_SSL_WANT_READ && n != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            stop();
+        }
+    }
+
+public:
+    TlsClient()
+        : caPem(NULL), certPem(NULL), keyPem(NULL), insecure(false), configured(false), open(false),
+          handshakeTimeout(PapaConfig::LinkConfig::SOCKET_TIMEOUT * 1000), stats(), rxStart(0), rxEnd(0),
+          offered(false) {}
+
+    void setCACert(const char* pem) { caPem = pem; }
+    void setCertificate(const char* pem) { certPem = pem; }
+    void setPrivateKey(const char* pem) { keyPem = pem; }
+    void setInsecure() { insecure = true; }
+    void setHandshakeTimeout(unsigned long seconds) { handshakeTimeout = seconds * 1000; }
+    void setSessionStore(SessionBlob& blob) { cache.begin(blob); }
+
+    int connect(IPAddress ip, uint16_t port) override {
+        char host[16];
+        snprintf(host, sizeof(host), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+        return connect(host, port);
+    }
+
+    int connect(IPAddress ip, uint16_t port, int32_t timeout) {
+        handshakeTimeout = timeout;
+        return connect(ip, port);
+    }
+
+    int connect(const char* host, uint16_t port, int32_t timeout) {
+        handshakeTimeout = timeout;
+        return connect(host, port);
+    }
+
+    int connect(const char* host, uint16_t port) override {
+        stop();
+        if (!configure()) return 0;
+        uint32_t deadline = millis() + handshakeTimeout;
+        if (!openSocket(host, port, deadline)) return 0;
+        mbedtls_ssl_set_hostname(&ssl, host);
+        mbedtls_ssl_set_bio(&ssl, &net, mbedtls_net_send, mbedtls_net_recv, NULL);
+        offered = false;
+        offerSession();
+        int result;
+        while ((result = mbedtls_ssl_handshake(&ssl)) != 0) {
+            bool reading = result == MBEDTLS_ERR_SSL_WANT_READ;
+            if ((!reading && result != MBEDTLS_ERR_SSL_WANT_WRITE) || !waitFor(net.fd, !reading, deadline)) {
+                // A session the broker chokes on is not offered again
+                cache.clear();
+                stop();
+                return 0;
+            }
+        }
+        open = true;
+        stats.handshakes++;
+#if MBEDTLS_VERSION_NUMBER < 0x03000000
+        const mbedtls_ssl_session* current = mbedtls_ssl_get_session_pointer(&ssl);
+        if (offered && current && memcmp(current->master, offeredMaster, sizeof(offeredMaster)) == 0) {
+            stats.resumed++;
+        }
+#endif
+        saveSession();
+        return 1;
+    }
+
+    size_t write(uint8_t b) override { return write(&b, 1); }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        if (!open) return 0;
+        uint32_t deadline = millis() + handshakeTimeout;
+        size_t sent = 0;
+        while (sent < length) {
+            int n = mbedtls_ssl_write(&ssl, data + sent, length - sent);
+            if (n > 0) {
+                sent += (size_t)n;
+            } else if (n == MBEDTLS_ERR_SSL_WANT_WRITE || n == MBEDTLS_ERR_SSL_WANT_READ) {
+                if (!waitFor(net.fd, n == MBEDTLS_ERR_SSL_WANT_WRITE, deadline)) break;
+            } else {
+                stop();
+                break;
+            }
+        }
+        return sent;
+    }
+
+    int available() override {
+        fill();
+        return (int)(rxEnd - rxStart);
+    }
+
+    int read() override {
+        fill();
+        return rxStart < rxEnd ? rx[rxStart++] : -1;
+    }
+
+    int read(uint8_t* buffer, size_t size) override {
+        fill();
+        size_t n = rxEnd - rxStart;
+        if (n > size) n = size;
+        memcpy(buffer, rx + rxStart, n);
+        rxStart += n;
+        return n ? (int)n : -1;
+    }
+
+    int peek() override {
+        fill();
+        return rxStart < rxEnd ? rx[rxStart] : -1;
+    }
+
+    void flush() override {}
+
+    void stop() override {
+        if (open) {
+            mbedtls_ssl_close_notify(&ssl);
+        }
+        if (configured) {
+            mbedtls_net_free(&net);
+            mbedtls_ssl_session_reset(&ssl);
+        }
+        open = false;
+        rxStart = rxEnd = 0;
+    }
+
+    uint8_t connected() override {
+        if (open) fill();
+        return open || rxStart < rxEnd;
+    }
+
+    operator bool() override { return connected(); }
+
+    const Stats& counters() const { return stats; }
+};
+
+} // namespace PapaTls
+#endif
+
+#endif // PAPA_TLS_H
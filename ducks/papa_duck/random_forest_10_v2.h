@@ -0,0 +1,1507 @@
+#pragma once
+#include <cstdarg>
+#include <cstdint>
+namespace Eloquent {
+    namespace ML {
+        namespace Port {
+            class RandomForestV2 {
+                public:
+                    /**
+                    * Predict class for features vector
+                    */
+                    int predict(float *x, uint8_t *treeVotes = nullptr) {
+                        uint8_t votes[2] = { 0 };
+                        // tree #1
+                        if (x[8] <= -0.10913808271288872) {
+                            if (x[5] <= 1.2062565088272095) {
+                                if (x[2] <= 1.2191058993339539) {
+                                    if (x[10] <= -1.1346611380577087) {
+                                        if (x[0] <= -0.6340156197547913) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            if (x[6] <= 4.932369947433472) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[3] <= -1.0066352486610413) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[8] <= -0.20860296487808228) {
+                                            if (x[2] <= 0.01691002957522869) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                votes[1] += 1;
+                            }
+                        }
+
+                        else {
+                            if (x[3] <= -0.14196499437093735) {
+                                if (x[9] <= -0.06589621491730213) {
+                                    if (x[2] <= 1.2803983688354492) {
+                                        if (x[10] <= 23.821064949035645) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[3] <= -0.42935173213481903) {
+                                        if (x[9] <= 0.9193548560142517) {
+                                            if (x[4] <= 1.2160096168518066) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[7] <= 9277.71826171875) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[8] <= -0.003366116085089743) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            if (x[5] <= 0.09358556196093559) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[8] <= 0.2826866526156664) {
+                                                    if (x[11] <= 32.69240474700928) {
+                                                        if (x[1] <= 0.7941078245639801) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[5] <= 0.10391272604465485) {
+                                                            votes[1] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[1] <= 0.941894143819809) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[7] <= 291.5614929199219) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[2] <= -1.4756553769111633) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[0] <= -0.7794704437255859) {
+                                            if (x[2] <= 0.8476251065731049) {
+                                                if (x[4] <= 1.3594667315483093) {
+                                                    if (x[11] <= 700.1229782104492) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[3] <= 0.4874199777841568) {
+                                                if (x[7] <= 6751.56884765625) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.47103680670261383) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #2
+                        if (x[2] <= 0.27941448986530304) {
+                            if (x[8] <= 0.07943880930542946) {
+                                if (x[3] <= 0.49194397032260895) {
+                                    if (x[9] <= 0.4127465933561325) {
+                                        if (x[1] <= 0.8404099643230438) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            if (x[10] <= 0.019499387592077255) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                if (x[11] <= 7503.483154296875) {
+                                    votes[1] += 1;
+                                }
+
+                                else {
+                                    if (x[3] <= 0.4851781576871872) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[7] <= 8296.79052734375) {
+                                if (x[6] <= 0.02474873699247837) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[3] <= -0.36422254145145416) {
+                                        if (x[8] <= -0.08198402263224125) {
+                                            if (x[1] <= 1.2450781762599945) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[10] <= -11.919280081987381) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[8] <= 1.1159234791994095) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[9] <= -0.14240909926593304) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[9] <= 0.9998845905065536) {
+                                        votes[1] += 1;
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #3
+                        if (x[2] <= 0.27941448986530304) {
+                            if (x[8] <= 0.09440355561673641) {
+                                if (x[6] <= 13.574837684631348) {
+                                    if (x[5] <= 1.1437251567840576) {
+                                        if (x[1] <= -1.135360300540924) {
+                                            if (x[10] <= -0.5098987706005573) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[3] <= 0.4874403327703476) {
+                                                if (x[10] <= 0.06866866908967495) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[4] <= 0.18849501758813858) {
+                                        if (x[1] <= 0.24355606734752655) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                votes[1] += 1;
+                            }
+                        }
+
+                        else {
+                            if (x[10] <= -6.985934495925903) {
+                                votes[0] += 1;
+                            }
+
+                            else {
+                                if (x[10] <= 3.2219537496566772) {
+                                    if (x[11] <= 773.1884765625) {
+                                        if (x[5] <= 0.008838835172355175) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            if (x[4] <= 1.3266393542289734) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.46937038004398346) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[7] <= 6182.725341796875) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[3] <= -0.3058598190546036) {
+                                        if (x[7] <= 33667.5009765625) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #4
+                        if (x[2] <= 0.309169664978981) {
+                            if (x[5] <= 0.46130478382110596) {
+                                if (x[8] <= 0.08182806894183159) {
+                                    if (x[0] <= 0.0508340522646904) {
+                                        if (x[1] <= 0.7097490727901459) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            if (x[5] <= 0.35976921021938324) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[5] <= 0.12709740921854973) {
+                                        if (x[1] <= -0.5746602118015289) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[10] <= -0.07521053776144981) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[3] <= -0.045253731310367584) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[9] <= -0.454291433095932) {
+                                if (x[10] <= 22.70662784576416) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                if (x[5] <= 0.026341348886489868) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[10] <= -7.200815439224243) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[3] <= 4.6162437200546265) {
+                                            if (x[5] <= 1.052605390548706) {
+                                                if (x[11] <= 704.6119537353516) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[7] <= 7150.687255859375) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[1] <= 0.1668086051940918) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #5
+                        if (x[11] <= -457.3918151855469) {
+                            if (x[8] <= -0.10913808271288872) {
+                                if (x[6] <= 6.85237717628479) {
+                                    if (x[5] <= 0.4155108332633972) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[1] <= 1.5653876066207886) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[8] <= -0.7640930265188217) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[2] <= 0.3716501370072365) {
+                                    if (x[9] <= 0.09520990680903196) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[1] <= -0.34251511096954346) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[10] <= -15.024180889129639) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[10] <= -2.437334656715393) {
+                                votes[0] += 1;
+                            }
+
+                            else {
+                                if (x[9] <= -1.0679810643196106) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[10] <= 0.03759358078241348) {
+                                        if (x[1] <= 0.5670369565486908) {
+                                            if (x[11] <= 29.033495903015137) {
+                                                if (x[2] <= 0.40156733989715576) {
+                                                    if (x[4] <= 0.3210845962166786) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[3] <= 0.4269634783267975) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[2] <= 0.3179180175065994) {
+                                                    if (x[2] <= -0.49195222556591034) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[0] <= 0.07709671556949615) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[4] <= 0.0020412413869053125) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[2] <= -0.6306837573647499) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[6] <= 4.38966965675354) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[4] <= 0.18201062828302383) {
+                                                            if (x[2] <= 0.9181519150733948) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[3] <= -0.33874186873435974) {
+                                            if (x[8] <= 0.2238856927724555) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[10] <= 11.167231559753418) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[0] <= 0.5639662444591522) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #6
+                        if (x[0] <= -0.12896424159407616) {
+                            if (x[11] <= -489.7748107910156) {
+                                if (x[4] <= 0.47594840824604034) {
+                                    if (x[5] <= 0.5416828989982605) {
+                                        if (x[1] <= 0.9437969923019409) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[3] <= -0.7974721193313599) {
+                                        votes[1] += 1;
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[2] <= -0.1787397563457489) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[1] <= 0.17759135365486145) {
+                                        if (x[8] <= 0.007173153571784496) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            if (x[6] <= 4.741648077964783) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.49474140256643295) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[11] <= 6207.277099609375) {
+                                            if (x[0] <= -0.7875512540340424) {
+                                                if (x[8] <= -0.26431164517998695) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[4] <= 1.0161928683519363) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[7] <= 10457.9560546875) {
+                                                if (x[7] <= 5550.1624755859375) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[0] <= -0.33502520620822906) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[5] <= 1.1563102006912231) {
+                                if (x[9] <= -0.7248502373695374) {
+                                    if (x[8] <= 3.537779450416565) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[11] <= 7503.483154296875) {
+                                        if (x[3] <= -0.5981237888336182) {
+                                            if (x[8] <= 0.01630607433617115) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[3] <= -0.8252917230129242) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= 0.5639662444591522) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            if (x[6] <= 8.756906032562256) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[10] <= 1.2315410263836384) {
+                                    votes[1] += 1;
+                                }
+
+                                else {
+                                    votes[0] += 1;
+                                }
+                            }
+                        }
+
+                        // tree #7
+                        if (x[2] <= -0.9973583221435547) {
+                            if (x[11] <= -9.944759130477905) {
+                                votes[0] += 1;
+                            }
+
+                            else {
+                                votes[1] += 1;
+                            }
+                        }
+
+                        else {
+                            if (x[8] <= -0.08465871959924698) {
+                                if (x[5] <= 0.7715502381324768) {
+                                    if (x[1] <= 0.9342828392982483) {
+                                        if (x[10] <= 5.262948840856552) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[10] <= -14.44251012802124) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[9] <= -0.7248502373695374) {
+                                    if (x[5] <= 0.3618454486131668) {
+                                        votes[1] += 1;
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[10] <= -0.7141843438148499) {
+                                        if (x[8] <= -0.07011288031935692) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= -0.290580689907074) {
+                                            if (x[2] <= 0.43909884989261627) {
+                                                if (x[9] <= 0.05326286517083645) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= -0.2037118449807167) {
+                                                if (x[9] <= -0.24999027932062745) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[7] <= 13838.1279296875) {
+                                                    if (x[5] <= 1.0659971833229065) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[4] <= 2.6557390689849854) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[11] <= 4130.9625453948975) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #8
+                        if (x[0] <= -0.15926732867956161) {
+                            if (x[8] <= -0.09197618439793587) {
+                                if (x[2] <= 0.9323004484176636) {
+                                    if (x[4] <= 0.23552876710891724) {
+                                        votes[1] += 1;
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[8] <= -0.6542920172214508) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[9] <= 0.06298652430996299) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[2] <= -0.18127785623073578) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[10] <= -11.70287561416626) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[2] <= 0.43445466458797455) {
+                                            if (x[3] <= 0.1060063038021326) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[0] <= -0.9976525902748108) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[8] <= 0.2764237970113754) {
+                                                if (x[11] <= 694.7605743408203) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[6] <= 7.7812676429748535) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[11] <= 16810.427734375) {
+                                if (x[9] <= -0.7248502373695374) {
+                                    if (x[10] <= 24.431328773498535) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[6] <= 9.746155261993408) {
+                                        if (x[0] <= -0.12896424159407616) {
+                                            if (x[11] <= 4156.941577911377) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[5] <= 1.049601435661316) {
+                                                if (x[4] <= 1.1887767910957336) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[6] <= 8.566555976867676) {
+                                                        if (x[6] <= 7.863182544708252) {
+                                                            votes[1] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[0] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[6] <= 6.559415817260742) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                votes[0] += 1;
+                            }
+                        }
+
+                        // tree #9
+                        if (x[8] <= -0.0943923220038414) {
+                            if (x[6] <= 6.801290988922119) {
+                                if (x[7] <= 7574.464599609375) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[1] <= 0.3190349340438843) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[9] <= 0.3932901918888092) {
+                                    if (x[1] <= 1.5019599795341492) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[0] <= -1.015834480524063) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[10] <= -1.5933305025100708) {
+                                if (x[6] <= 18.644216537475586) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                if (x[3] <= 0.31679345667362213) {
+                                    if (x[9] <= -1.1065288186073303) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[8] <= 0.004774637054651976) {
+                                            if (x[1] <= 0.38499966263771057) {
+                                                if (x[2] <= 0.3989752382040024) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[7] <= 788.821533203125) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[11] <= 10959.92529296875) {
+                                                if (x[1] <= -0.8512046039104462) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[2] <= 1.0998151302337646) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[9] <= -0.5185398291796446) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[2] <= -1.0838698148727417) {
+                                        if (x[0] <= 0.3397234082221985) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #10
+                        if (x[10] <= -0.8982694447040558) {
+                            if (x[6] <= 19.062434196472168) {
+                                if (x[11] <= -2769.0384521484375) {
+                                    if (x[10] <= -14.570244371891022) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[10] <= -2.1181201934814453) {
+                                        if (x[3] <= -1.2952701449394226) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[1] <= 0.9526768326759338) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[0] <= -1.3410875797271729) {
+                                    votes[1] += 1;
+                                }
+
+                                else {
+                                    votes[0] += 1;
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[9] <= -1.1381237506866455) {
+                                votes[0] += 1;
+                            }
+
+                            else {
+                                if (x[11] <= 28.640721321105957) {
+                                    if (x[3] <= -0.32845984399318695) {
+                                        if (x[0] <= 0.5821481049060822) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[7] <= 3714.393798828125) {
+                                            if (x[0] <= -0.2097724713385105) {
+                                                if (x[1] <= 0.5619627237319946) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= -0.09058032929897308) {
+                                                if (x[1] <= 0.8778322786092758) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[7] <= 13729.4091796875) {
+                                        if (x[7] <= 593.9938354492188) {
+                                            if (x[8] <= -0.10175387223716825) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[9] <= -0.7248502373695374) {
+                                                if (x[2] <= 0.7949190139770508) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[7] <= 6756.2041015625) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[3] <= 0.4851781576871872) {
+                                                        if (x[11] <= 82.21003723144531) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[1] <= -0.12368984520435333) {
+                                                                if (x[2] <= 0.2512253522872925) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[4] <= 0.8852786719799042) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        if (treeVotes) {
+                            treeVotes[0] = votes[0];
+                            treeVotes[1] = votes[1];
+                        }
+
+                        // return argmax of votes
+                        uint8_t classIdx = 0;
+                        float maxVotes = votes[0];
+
+                        for (uint8_t i = 1; i < 2; i++) {
+                            if (votes[i] > maxVotes) {
+                                classIdx = i;
+                                maxVotes = votes[i];
+                            }
+                        }
+
+                        return classIdx;
+                    }
+
+                protected:
+                };
+            }
+        }
+    }
\ No newline at end of file
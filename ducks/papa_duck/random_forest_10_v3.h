@@ -0,0 +1,2581 @@
+#pragma once
+#include <cstdarg>
+#include <cstdint>
+namespace Eloquent {
+    namespace ML {
+        namespace Port {
+            class RandomForestV3 {
+                public:
+                    /**
+                    * Predict class for features vector
+                    */
+                    int predict(float *x, uint8_t *treeVotes = nullptr) {
+                        uint8_t votes[2] = { 0 };
+                        // tree #1
+                        if (x[2] <= 0.207928366959095) {
+                            if (x[4] <= 0.07962411269545555) {
+                                if (x[2] <= 0.20640213042497635) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[10] <= -0.8149999976158142) {
+                                        if (x[0] <= 0.8534253388643265) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= 0.9131873846054077) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[3] <= -0.44641686975955963) {
+                                    if (x[6] <= 47556.552734375) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[2] <= 0.19824472814798355) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[3] <= -0.48789849877357483) {
+                                if (x[7] <= 850.4591369628906) {
+                                    if (x[2] <= 0.21527886390686035) {
+                                        if (x[10] <= -1.3450000286102295) {
+                                            if (x[3] <= -0.4974849671125412) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= 0.6818150877952576) {
+                                            if (x[7] <= 798.19189453125) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[6] <= 1.6746270954608917) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[4] <= 0.09609026461839676) {
+                                                if (x[5] <= 0.18140195310115814) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.7523171305656433) {
+                                                    if (x[5] <= 0.3864487558603287) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[4] <= 0.3409957140684128) {
+                                        if (x[5] <= 1.0559723377227783) {
+                                            if (x[1] <= -0.7908194959163666) {
+                                                if (x[0] <= 0.7251288592815399) {
+                                                    if (x[4] <= 0.2167738825082779) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= 0.8386218845844269) {
+                                            if (x[6] <= 1.400863528251648) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[5] <= 0.0062500000931322575) {
+                                    if (x[1] <= -0.7422687709331512) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+                        }
+
+                        // tree #2
+                        if (x[2] <= 0.20651499927043915) {
+                            if (x[2] <= -2.446632593870163) {
+                                if (x[4] <= 6.230423450469971) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                votes[0] += 1;
+                            }
+                        }
+
+                        else {
+                            if (x[5] <= 0.07310611754655838) {
+                                if (x[0] <= 0.6927805840969086) {
+                                    if (x[2] <= 0.21583256870508194) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[6] <= 1.609829843044281) {
+                                            if (x[1] <= -0.7691944241523743) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[7] <= 5150.562591552734) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[0] <= 0.7119702398777008) {
+                                        if (x[8] <= 0.029999999329447746) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[7] <= 724.5424499511719) {
+                                    if (x[3] <= -0.4781799167394638) {
+                                        if (x[4] <= 0.012957804836332798) {
+                                            if (x[3] <= -1.0914193093776703) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.8051278293132782) {
+                                                    if (x[3] <= -0.6509236693382263) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= 1.0826045274734497) {
+                                                if (x[1] <= -0.7097824215888977) {
+                                                    if (x[11] <= -716.0549926757812) {
+                                                        if (x[11] <= -719.8249816894531) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[2] <= 0.21533814817667007) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[2] <= 0.21793100237846375) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[6] <= 0.45750971138477325) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[2] <= 0.21984559297561646) {
+                                        if (x[0] <= 0.5359738171100616) {
+                                            if (x[10] <= -1.5550000071525574) {
+                                                if (x[6] <= 3.304860293865204) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[10] <= 1.2599999904632568) {
+                                                if (x[7] <= 37089.9267578125) {
+                                                    if (x[10] <= -0.824999988079071) {
+                                                        if (x[10] <= -0.875) {
+                                                            if (x[7] <= 951.1377258300781) {
+                                                                if (x[2] <= 0.21283340454101562) {
+                                                                    if (x[10] <= -0.9849999845027924) {
+                                                                        votes[0] += 1;
+                                                                    }
+
+                                                                    else {
+                                                                        votes[1] += 1;
+                                                                    }
+                                                                }
+
+                                                                else {
+                                                                    votes[0] += 1;
+                                                                }
+                                                            }
+
+                                                            else {
+                                                                if (x[8] <= -0.24499999731779099) {
+                                                                    if (x[1] <= -0.816314309835434) {
+                                                                        votes[0] += 1;
+                                                                    }
+
+                                                                    else {
+                                                                        votes[1] += 1;
+                                                                    }
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            votes[0] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[8] <= 0.2199999988079071) {
+                                                            if (x[7] <= 779.3826599121094) {
+                                                                if (x[9] <= -0.1875) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[7] <= 4634.302825927734) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[3] <= -0.8623544871807098) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #3
+                        if (x[2] <= 0.20649568736553192) {
+                            if (x[5] <= 2.8837220668792725) {
+                                votes[0] += 1;
+                            }
+
+                            else {
+                                if (x[6] <= 47555.763671875) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[7] <= 903.7586059570312) {
+                                if (x[1] <= -0.8318583369255066) {
+                                    if (x[8] <= 0.14500000327825546) {
+                                        if (x[3] <= -0.6570566296577454) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[3] <= -0.49003705382347107) {
+                                        if (x[5] <= 0.05935226380825043) {
+                                            if (x[0] <= 0.7443185150623322) {
+                                                if (x[4] <= 0.19713567197322845) {
+                                                    if (x[10] <= -0.9899999797344208) {
+                                                        if (x[2] <= 0.2140958458185196) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= 0.8117564022541046) {
+                                                if (x[11] <= -1976.6199951171875) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[1] <= -0.6960269510746002) {
+                                                        if (x[1] <= -0.7100425660610199) {
+                                                            if (x[2] <= 0.21592340618371964) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                if (x[3] <= -0.8868041038513184) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[11] <= 192.18499755859375) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[8] <= 0.19500000029802322) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[2] <= 0.2180248275399208) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[4] <= 0.0020000000949949026) {
+                                            if (x[1] <= -0.7422687709331512) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= 0.362170472741127) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[5] <= 0.9842127859592438) {
+                                    if (x[1] <= -0.7777794301509857) {
+                                        if (x[0] <= 0.7476081252098083) {
+                                            if (x[2] <= 0.2202451005578041) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[5] <= 0.3040064722299576) {
+                                            if (x[7] <= 1038.7857666015625) {
+                                                if (x[8] <= 0.2199999988079071) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[6] <= 2.7100284099578857) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.7204811573028564) {
+                                                    if (x[2] <= 0.22133048623800278) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[6] <= 19478.634470701218) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #4
+                        if (x[2] <= 0.20647365599870682) {
+                            if (x[7] <= 38573.943359375) {
+                                if (x[6] <= 38798.87109375) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[0] <= -1.6593213975429535) {
+                                        votes[1] += 1;
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                votes[1] += 1;
+                            }
+                        }
+
+                        else {
+                            if (x[7] <= 704.7248229980469) {
+                                if (x[5] <= 0.09900354593992233) {
+                                    if (x[1] <= -0.8051277995109558) {
+                                        if (x[0] <= 0.7569288313388824) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[11] <= 852.9150085449219) {
+                                            if (x[4] <= 0.1801403984427452) {
+                                                if (x[9] <= -0.1810000017285347) {
+                                                    if (x[10] <= -0.1599999973550439) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.756380558013916) {
+                                                        if (x[1] <= -0.7088068425655365) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[11] <= 1209.6199951171875) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[5] <= 0.14860302209854126) {
+                                        if (x[2] <= 0.2087540328502655) {
+                                            if (x[3] <= -0.4041144847869873) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[3] <= -0.5243716090917587) {
+                                                if (x[9] <= 0.2574999928474426) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[3] <= -0.6815153956413269) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= 1.074928641319275) {
+                                            if (x[5] <= 0.25672438740730286) {
+                                                if (x[4] <= 0.007741657551378012) {
+                                                    if (x[4] <= 0.006903934990987182) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[9] <= -0.1834999993443489) {
+                                                        if (x[11] <= -224.73500442504883) {
+                                                            if (x[4] <= 0.16903888434171677) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            votes[0] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[8] <= 0.16499999910593033) {
+                                                    if (x[1] <= -0.7182048261165619) {
+                                                        if (x[1] <= -0.7579103708267212) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[0] <= 0.7053909301757812) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[1] <= -0.7543658316135406) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[4] <= 0.33436399698257446) {
+                                    if (x[9] <= 2.1990000009536743) {
+                                        if (x[7] <= 945.1515502929688) {
+                                            if (x[8] <= -0.13999999687075615) {
+                                                if (x[11] <= 1766.5699462890625) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.8056156039237976) {
+                                                    if (x[10] <= -0.9699999690055847) {
+                                                        if (x[4] <= 0.0285510984249413) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[6] <= 1.3868026733398438) {
+                                                            if (x[0] <= 0.7031978070735931) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[9] <= -0.025000000838190317) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[6] <= 1.177032232284546) {
+                                                        if (x[1] <= -0.7343667149543762) {
+                                                            if (x[0] <= 0.6955219805240631) {
+                                                                if (x[4] <= 0.13598010502755642) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+
+                                                            else {
+                                                                if (x[6] <= 0.6754847764968872) {
+                                                                    votes[1] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[0] += 1;
+                                                                }
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= 0.5359738171100616) {
+                                                if (x[2] <= 0.2196875885128975) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[5] <= 0.058759307488799095) {
+                                                    if (x[8] <= -0.1900000050663948) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[3] <= -0.9375874400138855) {
+                                        if (x[6] <= 1.426772117614746) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            if (x[3] <= -1.4002999663352966) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[7] <= 4260.87841796875) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            if (x[7] <= 18281.644775390625) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #5
+                        if (x[1] <= -0.6481266021728516) {
+                            if (x[6] <= 0.017500000074505806) {
+                                if (x[1] <= -0.7422687709331512) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                if (x[0] <= 0.7108736634254456) {
+                                    if (x[7] <= 1177.515869140625) {
+                                        if (x[8] <= 0.14000000059604645) {
+                                            if (x[11] <= -1244.7300415039062) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[3] <= -0.4480569660663605) {
+                                                    if (x[7] <= 1039.9287109375) {
+                                                        if (x[7] <= 799.4565734863281) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[6] <= 0.9913156926631927) {
+                                                                if (x[9] <= -0.11299999803304672) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[0] <= 0.6231496036052704) {
+                                                            if (x[9] <= 0.07200000062584877) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[11] <= 1187.324951171875) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[2] <= 0.21571671217679977) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[9] <= 0.40450000017881393) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[1] <= -0.7809987962245941) {
+                                            if (x[5] <= 0.6388019621372223) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[11] <= -1511.52001953125) {
+                                                if (x[9] <= 0.6694999933242798) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[4] <= 0.23843498528003693) {
+                                        if (x[2] <= 0.2186533287167549) {
+                                            votes[1] += 1;
+                                        }
+
+                                        else {
+                                            if (x[7] <= 998.9065856933594) {
+                                                if (x[3] <= -0.7211963981389999) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[2] <= 0.22117193043231964) {
+                                            if (x[6] <= 1.6700711846351624) {
+                                                if (x[0] <= 0.94005286693573) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[8] <= -0.20999999903142452) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            votes[0] += 1;
+                        }
+
+                        // tree #6
+                        if (x[1] <= -0.6481266021728516) {
+                            if (x[7] <= 840.1624145507812) {
+                                if (x[4] <= 0.0020000000949949026) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[5] <= 0.0953773483633995) {
+                                        if (x[0] <= 0.7059392035007477) {
+                                            if (x[3] <= -0.25997941195964813) {
+                                                if (x[2] <= 0.21583284437656403) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[4] <= 0.06975069083273411) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[8] <= 0.12000000476837158) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[5] <= 0.1544281467795372) {
+                                            if (x[1] <= -0.8528980612754822) {
+                                                if (x[11] <= 1024.9049682617188) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[0] <= 0.6949736773967743) {
+                                                    if (x[9] <= 0.36399999260902405) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[2] <= 0.2183658704161644) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[1] <= -0.8468820750713348) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[8] <= -0.1549999974668026) {
+                                                if (x[0] <= 1.0683493614196777) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[4] <= 0.17762819677591324) {
+                                                    if (x[10] <= -1.4800000190734863) {
+                                                        if (x[5] <= 0.18384381383657455) {
+                                                            votes[1] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[0] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[11] <= -646.6100158691406) {
+                                                            if (x[3] <= -0.4256398230791092) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[7] <= 729.0544738769531) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                if (x[3] <= -1.1248079538345337) {
+                                                                    votes[1] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[0] += 1;
+                                                                }
+                                                            }
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.802983969449997) {
+                                                        if (x[0] <= 0.7229357659816742) {
+                                                            if (x[10] <= -2.715000033378601) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[6] <= 2.8373817205429077) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[2] <= 0.20712091773748398) {
+                                    if (x[2] <= -2.4335725903511047) {
+                                        votes[1] += 1;
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[4] <= 0.32021865248680115) {
+                                        if (x[5] <= 1.0010249018669128) {
+                                            if (x[4] <= 0.01092997146770358) {
+                                                if (x[7] <= 947.9269714355469) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[9] <= 0.13350000232458115) {
+                                                    if (x[2] <= 0.21229302883148193) {
+                                                        if (x[5] <= 0.38593772053718567) {
+                                                            if (x[2] <= 0.21209096163511276) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[0] <= 0.7437702417373657) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[2] <= 0.21849831193685532) {
+                                                        if (x[7] <= 1063.79443359375) {
+                                                            if (x[6] <= 1.0416413843631744) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[0] += 1;
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            if (x[11] <= -1013.3599853515625) {
+                                                                if (x[6] <= 0.4964880794286728) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[3] <= -0.9931725561618805) {
+                                            if (x[3] <= -1.2507519721984863) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[5] <= 0.4771486669778824) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[6] <= 19492.677225112915) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            votes[0] += 1;
+                        }
+
+                        // tree #7
+                        if (x[2] <= 0.20649568736553192) {
+                            if (x[6] <= 38829.9609375) {
+                                votes[0] += 1;
+                            }
+
+                            else {
+                                if (x[5] <= 4.948166370391846) {
+                                    votes[1] += 1;
+                                }
+
+                                else {
+                                    votes[0] += 1;
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[11] <= 1102.9099731445312) {
+                                if (x[1] <= -0.8231757879257202) {
+                                    if (x[6] <= 1.4036592841148376) {
+                                        if (x[5] <= 0.1718507558107376) {
+                                            if (x[8] <= 0.2150000035762787) {
+                                                if (x[3] <= -0.761601597070694) {
+                                                    if (x[7] <= 842.904296875) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[0] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[8] <= -0.0400000000372529) {
+                                            if (x[0] <= 1.038742482662201) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[3] <= -0.7282610833644867) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[5] <= 0.27419044077396393) {
+                                        if (x[0] <= 0.6971668004989624) {
+                                            if (x[1] <= -0.7446426749229431) {
+                                                if (x[8] <= 0.14000000059604645) {
+                                                    if (x[3] <= -1.054214358329773) {
+                                                        if (x[4] <= 0.4285155162215233) {
+                                                            votes[1] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[0] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[11] <= -512.7249908447266) {
+                                                        if (x[10] <= -5.120000004768372) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[4] <= 0.09162230044603348) {
+                                                    if (x[2] <= 0.21414398401975632) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[6] <= 0.3078348785638809) {
+                                                        if (x[2] <= 0.21318695694208145) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[6] <= 1.342038094997406) {
+                                                            votes[1] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[1] <= -0.7413257360458374) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[2] <= 0.21135640889406204) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[9] <= -0.42900000512599945) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[11] <= -1979.02001953125) {
+                                            if (x[2] <= 0.21938272565603256) {
+                                                if (x[10] <= 1.1749999821186066) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= 0.7881805300712585) {
+                                                if (x[2] <= 0.2198668047785759) {
+                                                    if (x[3] <= -1.6628496050834656) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[7] <= 943.9452819824219) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[8] <= -0.2750000059604645) {
+                                    if (x[10] <= -0.6050000041723251) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[9] <= -1.6584999859333038) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[4] <= 0.046946294605731964) {
+                                            if (x[7] <= 760.7123107910156) {
+                                                if (x[5] <= 0.0882098600268364) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.764056384563446) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[5] <= 0.06099388748407364) {
+                                                if (x[5] <= 0.05102760158479214) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #8
+                        if (x[2] <= 0.20649568736553192) {
+                            if (x[11] <= 26.225000381469727) {
+                                if (x[4] <= 6.353126347064972) {
+                                    votes[0] += 1;
+                                }
+
+                                else {
+                                    if (x[7] <= 31795.9482421875) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                votes[0] += 1;
+                            }
+                        }
+
+                        else {
+                            if (x[7] <= 726.0340576171875) {
+                                if (x[6] <= 1.3737452030181885) {
+                                    if (x[2] <= 0.20877905189990997) {
+                                        if (x[8] <= 0.11999999731779099) {
+                                            if (x[2] <= 0.207454614341259) {
+                                                if (x[3] <= -0.5177561342716217) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[3] <= -0.44376471638679504) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[0] <= 0.9477287232875824) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[8] <= 0.03499999921768904) {
+                                            if (x[0] <= 0.7201943695545197) {
+                                                if (x[11] <= -967.9750061035156) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[2] <= 0.22091656178236008) {
+                                                        if (x[1] <= -0.7501383423805237) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[6] <= 0.48274947702884674) {
+                                                if (x[0] <= 0.7646046876907349) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[11] <= -1032.8050231933594) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.6406944096088409) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[0] <= 1.0782182812690735) {
+                                        if (x[0] <= 0.7558322846889496) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            if (x[11] <= 955.0250244140625) {
+                                                if (x[6] <= 3.5170072317123413) {
+                                                    if (x[4] <= 0.07517134770751) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.9268942475318909) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.8485730588436127) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[7] <= 1148.3545532226562) {
+                                    if (x[3] <= -0.5070092678070068) {
+                                        if (x[6] <= 1.189723789691925) {
+                                            if (x[5] <= 0.2943445146083832) {
+                                                if (x[7] <= 786.6585998535156) {
+                                                    if (x[6] <= 0.8300820291042328) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[11] <= -418.1499938964844) {
+                                                        if (x[0] <= 0.48772555589675903) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[10] <= -1.034999966621399) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[1] <= -0.7714057266712189) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[5] <= 0.4859364479780197) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[11] <= 537.6999816894531) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[7] <= 45791.421875) {
+                                        if (x[0] <= 0.4296083450317383) {
+                                            if (x[0] <= 0.39068078994750977) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                if (x[8] <= 0.12000000197440386) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[1] <= -0.6092665493488312) {
+                                                if (x[10] <= 6.1549999713897705) {
+                                                    if (x[8] <= 0.2149999961256981) {
+                                                        if (x[1] <= -0.7356024384498596) {
+                                                            votes[1] += 1;
+                                                        }
+
+                                                        else {
+                                                            if (x[1] <= -0.7352447211742401) {
+                                                                votes[0] += 1;
+                                                            }
+
+                                                            else {
+                                                                votes[1] += 1;
+                                                            }
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        if (x[4] <= 0.23170919716358185) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+                            }
+                        }
+
+                        // tree #9
+                        if (x[1] <= -0.6528093218803406) {
+                            if (x[0] <= 0.7081322968006134) {
+                                if (x[7] <= 1041.9927368164062) {
+                                    if (x[1] <= -0.7004494965076447) {
+                                        if (x[0] <= 0.6406944394111633) {
+                                            if (x[4] <= 0.38496115803718567) {
+                                                if (x[0] <= 0.5595496296882629) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[9] <= 0.12150000035762787) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[7] <= 905.083984375) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[2] <= 0.21553423255681992) {
+                                                if (x[4] <= 0.08303697779774666) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[11] <= 557.9999847412109) {
+                                                        if (x[7] <= 657.7236022949219) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[10] <= -3.990000009536743) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    if (x[7] <= 47880.53515625) {
+                                        if (x[1] <= -0.7778444588184357) {
+                                            if (x[6] <= 10.129311084747314) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[0] <= 0.3725876957178116) {
+                                                    votes[1] += 1;
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[5] <= 1.0585291385650635) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        votes[0] += 1;
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[2] <= 0.21866393089294434) {
+                                    votes[1] += 1;
+                                }
+
+                                else {
+                                    if (x[6] <= 1.56913423538208) {
+                                        if (x[7] <= 705.2908020019531) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[2] <= 0.22053636610507965) {
+                                            if (x[3] <= -1.4890824556350708) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            votes[0] += 1;
+                        }
+
+                        // tree #10
+                        if (x[4] <= 0.024657122790813446) {
+                            if (x[4] <= 0.011830952018499374) {
+                                if (x[9] <= 0.19350000470876694) {
+                                    if (x[0] <= 1.1001493036746979) {
+                                        if (x[2] <= 0.22002780437469482) {
+                                            if (x[10] <= -0.8949999809265137) {
+                                                if (x[1] <= -0.8242489099502563) {
+                                                    if (x[0] <= 0.8002425730228424) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+
+                                    else {
+                                        votes[1] += 1;
+                                    }
+                                }
+
+                                else {
+                                    votes[1] += 1;
+                                }
+                            }
+
+                            else {
+                                if (x[5] <= 0.04093432426452637) {
+                                    if (x[2] <= 0.2008778303861618) {
+                                        votes[0] += 1;
+                                    }
+
+                                    else {
+                                        if (x[3] <= -0.4226320683956146) {
+                                            votes[0] += 1;
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[2] <= 0.2087872102856636) {
+                                        if (x[5] <= 0.04457889311015606) {
+                                            if (x[0] <= 0.18014299869537354) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[1] <= -0.8197613060474396) {
+                                                votes[1] += 1;
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[0] <= 0.6922323107719421) {
+                                            if (x[1] <= -0.7308221459388733) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[3] <= -0.7531207799911499) {
+                                                if (x[7] <= 538.2159576416016) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        else {
+                            if (x[3] <= -0.054563792422413826) {
+                                if (x[0] <= 0.7163564562797546) {
+                                    if (x[2] <= 0.21596909314393997) {
+                                        if (x[7] <= 1504.543701171875) {
+                                            if (x[11] <= 1329.7900390625) {
+                                                if (x[11] <= -1065.8250122070312) {
+                                                    if (x[11] <= -1105.0549926757812) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    if (x[3] <= -0.3498099148273468) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        if (x[4] <= 0.0698308702558279) {
+                                                            votes[0] += 1;
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[9] <= -0.22350000590085983) {
+                                                if (x[0] <= 0.5403600037097931) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[0] <= 0.47182556986808777) {
+                                                    if (x[0] <= -1.6659006774425507) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[3] <= -0.8890217244625092) {
+                                            if (x[7] <= 1586.0645751953125) {
+                                                if (x[1] <= -0.7242533266544342) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    if (x[0] <= 0.6708495914936066) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[6] <= 3.52586567401886) {
+                                                    if (x[0] <= 0.5485841333866119) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[0] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            votes[1] += 1;
+                                        }
+                                    }
+                                }
+
+                                else {
+                                    if (x[4] <= 0.2684185206890106) {
+                                        if (x[3] <= -0.13850076496601105) {
+                                            if (x[4] <= 0.21284551918506622) {
+                                                if (x[3] <= -1.0127710402011871) {
+                                                    if (x[3] <= -1.0518745183944702) {
+                                                        if (x[5] <= 0.14014758169651031) {
+                                                            if (x[9] <= 0.06000000052154064) {
+                                                                votes[1] += 1;
+                                                            }
+
+                                                            else {
+                                                                if (x[1] <= -0.8368012011051178) {
+                                                                    votes[0] += 1;
+                                                                }
+
+                                                                else {
+                                                                    votes[1] += 1;
+                                                                }
+                                                            }
+                                                        }
+
+                                                        else {
+                                                            votes[1] += 1;
+                                                        }
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                if (x[1] <= -0.8152737021446228) {
+                                                    if (x[11] <= 484.2749938964844) {
+                                                        votes[0] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[1] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[6] <= 1.2342413663864136) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                votes[1] += 1;
+                                            }
+                                        }
+                                    }
+
+                                    else {
+                                        if (x[7] <= 1039.821044921875) {
+                                            if (x[6] <= 1.9753136038780212) {
+                                                if (x[3] <= -0.9786359965801239) {
+                                                    if (x[3] <= -1.725335419178009) {
+                                                        votes[1] += 1;
+                                                    }
+
+                                                    else {
+                                                        votes[0] += 1;
+                                                    }
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+
+                                            else {
+                                                votes[0] += 1;
+                                            }
+                                        }
+
+                                        else {
+                                            if (x[2] <= 0.20160097628831863) {
+                                                votes[0] += 1;
+                                            }
+
+                                            else {
+                                                if (x[9] <= -0.5099999904632568) {
+                                                    votes[0] += 1;
+                                                }
+
+                                                else {
+                                                    votes[1] += 1;
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+
+                            else {
+                                if (x[1] <= -0.661394327878952) {
+                                    votes[1] += 1;
+                                }
+
+                                else {
+                                    votes[0] += 1;
+                                }
+                            }
+                        }
+
+                        if (treeVotes) {
+                            treeVotes[0] = votes[0];
+                            treeVotes[1] = votes[1];
+                        }
+
+                        // return argmax of votes
+                        uint8_t classIdx = 0;
+                        float maxVotes = votes[0];
+
+                        for (uint8_t i = 1; i < 2; i++) {
+                            if (votes[i] > maxVotes) {
+                                classIdx = i;
+                                maxVotes = votes[i];
+                            }
+                        }
+
+                        return classIdx;
+                    }
+
+                protected:
+                };
+            }
+        }
+    }
\ No newline at end of file
@@ -0,0 +1,85 @@
+#ifndef DATASET_READER_H
+#define DATASET_READER_H
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "DuckPayload.h"
+
+// Loads the gateway exports in datasets/ ("Papa ID","Device ID","Event Type",
+// "Date","Message ID","Payload","# of Hops") for the host tools. Rows whose
+// Payload is not the MamaDuck telemetry text are skipped.
+
+struct Sample {
+    uint64_t timeMs;
+    size_t textLength;
+    DuckPayload::Reading reading;
+};
+
+// Splits one line of a quoted CSV export
+inline std::vector<std::string> splitCsv(const std::string& line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (c == '"') {
+            quoted = !quoted;
+        } else if (c == ',' && !quoted) {
+            fields.push_back("");
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// "2025-04-13T05:47:16.65+00:00" to milliseconds since the epoch (UTC)
+inline bool parseDate(const std::string& s, uint64_t& ms) {
+    int y, mo, d, h, mi;
+    double sec;
+    if (sscanf(s.c_str(), "%d-%d-%dT%d:%d:%lf", &y, &mo, &d, &h, &mi, &sec) != 6) {
+        return false;
+    }
+    y -= mo <= 2;
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (mo + (mo > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t days = era * 146097LL + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+    ms = (uint64_t)(((days * 24 + h) * 60 + mi) * 60000LL + (int64_t)(sec * 1000));
+    return true;
+}
+
+inline bool parsePayload(const std::string& p, DuckPayload::Reading& r) {
+    return DuckPayload::fromText(p.c_str(), r);
+}
+
+typedef std::map<std::string, std::vector<Sample>> DeviceSeries;
+
+// Readings per device in time order, keyed by file and device so separate
+// collections are not stitched together
+inline DeviceSeries loadDatasets(int fileCount, char** files) {
+    DeviceSeries devices;
+    for (int i = 0; i < fileCount; i++) {
+        std::ifstream in(files[i]);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::vector<std::string> f = splitCsv(line);
+            if (f.size() < 7) continue;  // header, or not a gateway export
+            Sample s;
+            if (!parseDate(f[3], s.timeMs) || !parsePayload(f[5], s.reading)) continue;
+            s.textLength = f[5].size();
+            devices[std::string(files[i]) + ":" + f[1]].push_back(s);
+        }
+    }
+    for (auto& device : devices) {
+        std::stable_sort(device.second.begin(), device.second.end(),
+                         [](const Sample& a, const Sample& b) { return a.timeMs < b.timeMs; });
+    }
+    return devices;
+}
+
+#endif // DATASET_READER_H
@@ -0,0 +1,190 @@
+/**
+ * @file ack_sim.cpp
+ * @brief Host simulation of MamaDuck end-to-end acks over a lossy mesh
+ *
+ * One MamaDuck sends a telemetry packet every 10 s for a day through a
+ * mesh with per-packet loss in both directions and 1-6 s of relay latency
+ * each way. The ack scheme runs the real DuckSequence::Window on the node
+ * and PapaSequence::Table on the gateway with the firmware configuration;
+ * it is compared with what the firmware did before:
+ *   once       each packet sent once, a successful local send counts as done
+ *   twice      each packet blindly sent twice, the usual fix for loss
+ *   acks       sequence numbers, bitmap acks and selective resends
+ * Loss is either independent per packet or bursty (Gilbert-Elliott: mostly
+ * clean, with outages averaging 60 s). Airtime counts CDP frames: a 27 byte
+ * header plus the payload, 24 byte records, the 3 byte sequence header and
+ * 7 byte acks. The last columns check the loss statistics each side keeps
+ * against the true number of packets that never arrived: the node counts
+ * packets it gave up on (some of which did arrive, only their acks were
+ * lost) and packets refused by a full window, which never get a sequence
+ * number; the gateway counts sequence numbers that never arrived.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/tools/host -Iducks/mama_duck/mama_duck_v6 -Iducks/common -Iducks/papa_duck \
+ *       ducks/tools/ack_sim.cpp -o /tmp/ack_sim
+ *   /tmp/ack_sim
+ */
+
+#include <stdio.h>
+#include <map>
+#include <random>
+#include <set>
+#include "DuckConfig.h"
+#include "DuckSequence.h"
+#include "PapaSequence.h"
+
+static const uint32_t DAY = 86400000;
+static const uint32_t INTERVAL = 10000;
+static const uint32_t TICK = 100;
+static const size_t CDP_HEADER = 27;
+static const size_t RECORD = 24;
+
+typedef DuckSequence::Window<DuckConfig::AckConfig::WINDOW, RECORD> Window;
+
+enum class Scheme { ONCE, TWICE, ACKS };
+
+// Both directions share the outage state and draw loss independently
+struct Channel {
+    double loss;        // independent loss, or loss outside an outage
+    bool bursty;
+    bool outage;
+    std::mt19937 rng;
+
+    Channel(double loss, bool bursty) : loss(loss), bursty(bursty), outage(false), rng(7) {}
+
+    // Advances the outage state by one tick
+    void tick() {
+        if (!bursty) return;
+        std::uniform_real_distribution<double> u(0, 1);
+        // Outages start about every 10 minutes and last 60 s on average
+        if (outage ? u(rng) < TICK / 60000.0 : u(rng) < TICK / 600000.0) outage = !outage;
+    }
+
+    bool delivers() {
+        std::uniform_real_distribution<double> u(0, 1);
+        return !outage && u(rng) >= loss;
+    }
+
+    uint32_t latency() {
+        std::uniform_int_distribution<uint32_t> d(1000, 6000);
+        return d(rng);
+    }
+};
+
+struct Result {
+    uint32_t packets = 0, delivered = 0, duplicates = 0;
+    uint64_t upBytes = 0, downBytes = 0;
+    uint32_t upFrames = 0;
+    uint32_t windowFull = 0, expired = 0, gatewayLost = 0;
+};
+
+static Result run(Scheme scheme, double loss, bool bursty) {
+    Channel channel(loss, bursty);
+    Result r;
+    std::set<uint16_t> received;
+    std::multimap<uint32_t, uint16_t> toGateway;                // arrival time, sequence
+    std::multimap<uint32_t, DuckSequence::Ack> toNode;          // arrival time, ack
+    static Window window({DuckConfig::AckConfig::ACK_TIMEOUT, DuckConfig::AckConfig::RESEND_HOLDOFF,
+                          DuckConfig::AckConfig::MAX_TRANSMISSIONS});
+    window = Window({DuckConfig::AckConfig::ACK_TIMEOUT, DuckConfig::AckConfig::RESEND_HOLDOFF,
+                     DuckConfig::AckConfig::MAX_TRANSMISSIONS});
+    window.begin(65530);  // exercise wraparound
+    static PapaSequence::Table<> gateway;
+    gateway = PapaSequence::Table<>();
+    const uint8_t id[8] = {'D', 'U', 'C', 'K', '0', '0', '0', '1'};
+    uint8_t record[RECORD] = {0x10};
+    uint16_t nextSequence = 65530;
+
+    auto transmit = [&](uint16_t sequence, uint32_t now, size_t payload) {
+        r.upFrames++;
+        r.upBytes += CDP_HEADER + payload;
+        if (channel.delivers()) toGateway.insert(std::make_pair(now + channel.latency(), sequence));
+    };
+
+    for (uint32_t now = 0; now < DAY + 120000; now += TICK) {
+        channel.tick();
+        if (now < DAY && now % INTERVAL == 0) {
+            r.packets++;
+            if (scheme == Scheme::ACKS) {
+                if (!window.add(0, record, sizeof(record), false)) r.windowFull++;
+            } else {
+                transmit(nextSequence, now, RECORD);
+                if (scheme == Scheme::TWICE) transmit(nextSequence, now, RECORD);
+                nextSequence++;
+            }
+        }
+
+        // Gateway: forward new packets, ack everything sequenced
+        while (!toGateway.empty() && toGateway.begin()->first <= now) {
+            uint16_t sequence = toGateway.begin()->second;
+            toGateway.erase(toGateway.begin());
+            if (scheme != Scheme::ACKS) {
+                if (!received.insert(sequence).second) r.duplicates++;
+                continue;
+            }
+            DuckSequence::Ack ack;
+            if (gateway.receive(id, sizeof(id), sequence, now, ack)) {
+                received.insert(sequence);
+            } else {
+                r.duplicates++;
+            }
+            r.downBytes += CDP_HEADER + DuckSequence::ACK_SIZE;
+            if (channel.delivers()) toNode.insert(std::make_pair(now + channel.latency(), ack));
+        }
+        if (scheme != Scheme::ACKS) continue;
+
+        // Node: the TX task's order, acks first, then timeouts and sends
+        while (!toNode.empty() && toNode.begin()->first <= now) {
+            window.onAck(toNode.begin()->second, now);
+            toNode.erase(toNode.begin());
+        }
+        window.poll(now);
+        Window::Slot* slot;
+        while ((slot = window.due()) != nullptr) {
+            window.sending(slot);
+            transmit(slot->sequence, now, slot->length);
+            window.sent(slot, now);
+        }
+    }
+    r.delivered = received.size();
+    if (scheme == Scheme::ACKS) {
+        r.expired = window.counters().expired;
+        r.gatewayLost = gateway.counters().packets.lost;
+    }
+    return r;
+}
+
+int main() {
+    static const struct { const char* name; double loss; bool bursty; } CHANNELS[] = {
+        {"5% loss", 0.05, false},
+        {"20% loss", 0.20, false},
+        {"40% loss", 0.40, false},
+        {"5% + 60 s outages", 0.05, true},
+    };
+    static const struct { const char* name; Scheme scheme; } SCHEMES[] = {
+        {"once", Scheme::ONCE},
+        {"twice", Scheme::TWICE},
+        {"acks", Scheme::ACKS},
+    };
+
+    printf("%u packets, window %u, ack timeout %u s, holdoff %u s, %u transmissions max\n", DAY / INTERVAL,
+           (unsigned)DuckConfig::AckConfig::WINDOW, (unsigned)(DuckConfig::AckConfig::ACK_TIMEOUT / 1000),
+           (unsigned)(DuckConfig::AckConfig::RESEND_HOLDOFF / 1000), (unsigned)DuckConfig::AckConfig::MAX_TRANSMISSIONS);
+    printf("%-19s %-6s %10s %8s %9s %9s %9s %10s  %s\n", "channel", "scheme", "delivered", "tx/pkt", "up KB",
+           "down KB", "dups", "true loss", "node: expired + window full / gateway");
+    for (const auto& c : CHANNELS) {
+        for (const auto& s : SCHEMES) {
+            Result r = run(s.scheme, c.loss, c.bursty);
+            uint32_t lost = r.packets - r.delivered;
+            printf("%-19s %-6s %9.2f%% %8.2f %9.1f %9.1f %9u %10u", c.name, s.name, 100.0 * r.delivered / r.packets,
+                   (double)r.upFrames / r.packets, r.upBytes / 1024.0, r.downBytes / 1024.0, r.duplicates, lost);
+            if (s.scheme == Scheme::ACKS) {
+                printf("  %u + %u / %u", r.expired, r.windowFull, r.gatewayLost);
+            } else {
+                printf("  - / -");
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
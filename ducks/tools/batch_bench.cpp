@@ -0,0 +1,123 @@
+/**
+ * @file batch_bench.cpp
+ * @brief Host benchmark of DuckBatch compression on recorded MamaDuck traffic
+ *
+ * Replays the Payload column of the gateway exports in datasets/ per device
+ * in time order, batches readings the way the MamaDuck TX task does
+ * and compares bytes on air per reading for the ASCII, single binary record
+ * and batched formats. Every batch is decoded again and checked against the
+ * single-record encoding.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/common ducks/tools/batch_bench.cpp -o /tmp/batch_bench
+ *   /tmp/batch_bench datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "DuckPayload.h"
+#include "DuckBatch.h"
+#include "DatasetReader.h"
+
+static const size_t CDP_HEADER_SIZE = 27;
+
+struct Totals {
+    size_t readings = 0;
+    size_t textBytes = 0;
+    size_t binaryBytes = 0;
+    size_t batchBytes = 0;
+    size_t packets = 0;
+    size_t mismatches = 0;
+};
+
+static bool sameRecord(const DuckPayload::Reading& a, const DuckPayload::Reading& b) {
+    uint8_t ea[DuckPayload::RECORD_SIZE], eb[DuckPayload::RECORD_SIZE];
+    DuckPayload::encode(a, ea, sizeof(ea));
+    DuckPayload::encode(b, eb, sizeof(eb));
+    return memcmp(ea, eb, sizeof(ea)) == 0;
+}
+
+// Mirrors DuckBatcher: flush on MAX_READINGS, age, or a full payload; fire
+// predictions are sent on their own as binary records when bypassFire is set
+static void replay(const std::vector<Sample>& samples, uint8_t maxReadings, uint32_t maxAgeMs,
+                   bool bypassFire, Totals& t) {
+    DuckBatch::Encoder encoder;
+    std::vector<DuckPayload::Reading> pending;
+    uint64_t openedAt = 0;
+
+    auto flush = [&]() {
+        if (encoder.empty()) return;
+        const uint8_t* data = encoder.data();
+        size_t size = encoder.size();
+        t.batchBytes += CDP_HEADER_SIZE + size;
+        t.packets++;
+        DuckBatch::Decoder decoder(data, size);
+        DuckBatch::Entry e;
+        size_t i = 0;
+        while (decoder.next(e)) {
+            DuckPayload::Reading r;
+            DuckBatch::toReading(e, r);
+            if (i >= pending.size() || !sameRecord(r, pending[i])) t.mismatches++;
+            i++;
+        }
+        if (i != pending.size()) t.mismatches += pending.size() - i;
+        encoder.reset();
+        pending.clear();
+    };
+
+    for (const Sample& s : samples) {
+        t.readings++;
+        t.textBytes += CDP_HEADER_SIZE + s.textLength;
+        t.binaryBytes += CDP_HEADER_SIZE + DuckPayload::RECORD_SIZE;
+        if (bypassFire && s.reading.prediction == 1) {
+            t.batchBytes += CDP_HEADER_SIZE + DuckPayload::RECORD_SIZE;
+            t.packets++;
+            flush();
+            continue;
+        }
+        DuckBatch::Entry e = DuckBatch::fromReading(s.reading, (uint32_t)s.timeMs);
+        if (encoder.count() >= maxReadings || !encoder.append(e)) {
+            flush();
+            encoder.append(e);
+        }
+        if (encoder.count() == 1) openedAt = s.timeMs;
+        pending.push_back(s.reading);
+        if (encoder.count() >= maxReadings || s.timeMs - openedAt >= maxAgeMs) {
+            flush();
+        }
+    }
+    flush();
+}
+
+static void report(const char* label, const Totals& t) {
+    printf("%-28s %7zu readings %6zu packets  text %6.1f  record %5.1f  batch %5.1f B/reading"
+           "  ratio %5.2fx vs text %5.2fx vs record  %zu mismatches\n",
+           label, t.readings, t.packets,
+           (double)t.textBytes / t.readings, (double)t.binaryBytes / t.readings,
+           (double)t.batchBytes / t.readings,
+           (double)t.textBytes / t.batchBytes, (double)t.binaryBytes / t.batchBytes, t.mismatches);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+
+    DeviceSeries devices = loadDatasets(argc - 1, argv + 1);
+
+    static const uint8_t SIZES[] = {4, 8, 12, 16, 32, 64};
+    for (size_t n = 0; n < sizeof(SIZES); n++) {
+        for (int bypass = 0; bypass < 2; bypass++) {
+            Totals totals;
+            for (auto& device : devices) {
+                replay(device.second, SIZES[n], SIZES[n] * 10000u, bypass, totals);
+            }
+            char label[64];
+            snprintf(label, sizeof(label), "N=%-2u T=%3us%s", SIZES[n], SIZES[n] * 10,
+                     bypass ? " fire bypass" : "");
+            report(label, totals);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file dedup_bench.cpp
+ * @brief Host benchmark of the PapaDuck duplicate filter
+ *
+ * Generates an hour of fleet traffic: every device sends a message with a
+ * random 4-byte MUID at a fixed interval, and each message reaches the
+ * gateway one or more times through relays, the copies spread over a few
+ * seconds. The stream runs through PapaDedup::Filter with the firmware
+ * configuration and is scored against an exact set:
+ *   false positive  a new message reported as a duplicate (lost data)
+ *   missed          a copy let through (costs one extra publish)
+ * Lookup cost is host wall time per call, hashing included. With 32-bit
+ * fingerprints the expected false positive rate is below 1e-8 per
+ * message, so any false positive here points at a bug.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/papa_duck ducks/tools/dedup_bench.cpp -o /tmp/dedup_bench
+ *   /tmp/dedup_bench
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "PapaDedup.h"
+
+struct Arrival {
+    uint32_t at;       // ms
+    uint16_t device;
+    uint32_t muid;
+    bool copy;         // not the first arrival of this message
+};
+
+static std::vector<Arrival> traffic(uint32_t devices, uint32_t intervalMs, uint32_t durationMs,
+                                    double meanCopies, std::mt19937& rng) {
+    std::vector<Arrival> arrivals;
+    std::uniform_int_distribution<uint32_t> phase(0, intervalMs - 1);
+    std::uniform_int_distribution<uint32_t> delay(100, 5000);
+    std::poisson_distribution<int> extra(meanCopies - 1);
+    for (uint32_t d = 0; d < devices; d++) {
+        for (uint32_t t = phase(rng); t < durationMs; t += intervalMs) {
+            uint32_t muid = rng();
+            std::vector<uint32_t> times(1, t + delay(rng) / 10);
+            for (int c = extra(rng); c > 0; c--) times.push_back(t + delay(rng));
+            std::sort(times.begin(), times.end());
+            for (size_t i = 0; i < times.size(); i++) {
+                Arrival a = {times[i], (uint16_t)d, muid, i > 0};
+                arrivals.push_back(a);
+            }
+        }
+    }
+    std::stable_sort(arrivals.begin(), arrivals.end(),
+                     [](const Arrival& a, const Arrival& b) { return a.at < b.at; });
+    return arrivals;
+}
+
+static void deviceId(uint16_t device, uint8_t* sduid) {
+    snprintf((char*)sduid, 10, "DUCK%04u", (unsigned)device);
+}
+
+int main() {
+    static const uint32_t HOUR = 3600000;
+    static const struct { uint32_t devices; uint32_t interval; double copies; } FLEETS[] = {
+        {50, 10000, 2.0},
+        {128, 10000, 3.0},  // classic ESP32 gateway, MemoryConfig::DEVICES
+        {200, 10000, 2.0},
+        {500, 10000, 3.0},
+        {512, 10000, 3.0},  // ESP32-S3 gateway
+        {1000, 10000, 3.0},
+        {2000, 5000, 3.0},
+    };
+
+    static PapaDedup::Filter<> filter;
+    printf("filter: %u slots, probe %u, %u s window, %u bytes\n", (unsigned)filter.capacity(),
+           (unsigned)PapaConfig::DedupConfig::PROBE, (unsigned)filter.retention(),
+           (unsigned)filter.memoryBytes());
+
+    std::mt19937 rng(42);
+    for (const auto& f : FLEETS) {
+        std::vector<Arrival> arrivals = traffic(f.devices, f.interval, HOUR, f.copies, rng);
+        filter.begin();
+        PapaDedup::Stats before = filter.counters();
+
+        size_t messages = 0, copies = 0, falsePositives = 0, missed = 0;
+        std::vector<uint8_t> verdicts(arrivals.size());
+        std::vector<uint8_t> keys(arrivals.size() * 12);  // sduid then muid, as in the packet
+        for (size_t i = 0; i < arrivals.size(); i++) {
+            uint8_t sduid[10];
+            deviceId(arrivals[i].device, sduid);
+            memcpy(&keys[i * 12], sduid, 8);
+            memcpy(&keys[i * 12 + 8], &arrivals[i].muid, 4);
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < arrivals.size(); i++) {
+            verdicts[i] = filter.seen(&keys[i * 12], 8, &keys[i * 12 + 8], 4, arrivals[i].at);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (size_t i = 0; i < arrivals.size(); i++) {
+            if (arrivals[i].copy) {
+                copies++;
+                missed += !verdicts[i];
+            } else {
+                messages++;
+                falsePositives += verdicts[i];
+            }
+        }
+        const PapaDedup::Stats& s = filter.counters();
+        double rate = (double)messages / (HOUR / 1000);
+        printf("%5u devices, %5.1f msg/s, %.1f copies each: %8zu lookups, %6.1f ns/lookup,"
+               " duplicates caught %6.2f%%, missed %zu, false positives %zu (%.2g per message),"
+               " early evictions %u\n",
+               (unsigned)f.devices, rate, f.copies, arrivals.size(), elapsed * 1e9 / arrivals.size(),
+               copies ? 100.0 * (copies - missed) / copies : 100.0, missed, falsePositives,
+               (double)falsePositives / messages, (unsigned)(s.evictions - before.evictions));
+    }
+    return 0;
+}
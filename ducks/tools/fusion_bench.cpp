@@ -0,0 +1,320 @@
+/**
+ * @file fusion_bench.cpp
+ * @brief Host benchmark of PapaDuck spatial alert fusion: pages, confirmation latency and throughput
+ *
+ * Pages: each export is replayed through a fresh table on its recorded
+ * timestamps. Without fusion every alert after CLEAR_AFTER of quiet from
+ * its device pages; with fusion each new incident does. Fusion is fed the
+ * edge predictions (Pred) as recorded, and again after gateway re-scoring
+ * (PapaInference, vetoed alerts dropped). The Data_NoFire collections had
+ * no fire, so every page there is a false one.
+ *
+ * Field: each export with GPS is also replayed as a 3 x 3 field of nodes
+ * 150 m apart, every node running the export from its own offset, so
+ * neighbours see unrelated false alarms at the same time.
+ *
+ * Latency: for every export with more than one device, the time from each
+ * device's first edge alert to its first confirmed one, fused with the
+ * other devices and alone.
+ *
+ * Reported: the same exports as the PapaDuck hears them from MamaDucks
+ * running the report policy and batching of mama_duck_v6 (DuckConfig
+ * defaults). Readings inside the deadbands are suppressed, an alert goes
+ * out at once with the open batch right behind it, and routine readings
+ * arrive in batches, with sensing times from their batch timestamps.
+ *
+ * Throughput: 500 nodes scattered over 3 x 3 km report once per 10 s
+ * round, one in twenty readings an alert, into the table as the firmware
+ * sizes it. Built with -DPAPA_LARGE_TABLES that is the ESP32-S3 gateway
+ * tracking 500 nodes; without it the classic ESP32 one, which tracks 128
+ * and evicts.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -DPAPA_LARGE_TABLES -Iducks/tools/host -Iducks/mama_duck/mama_duck_v6 -Iducks/common \
+ *       -Iducks/papa_duck ducks/tools/fusion_bench.cpp -o /tmp/fusion_bench
+ *   /tmp/fusion_bench datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "DuckConfig.h"
+#include "DuckPayload.h"
+#include "DuckReportPolicy.h"
+#include "PapaInference.h"
+#include "PapaFusion.h"
+#include "DatasetReader.h"
+
+using PapaConfig::FusionConfig;
+using DuckConfig::BatchConfig;
+using DuckConfig::ReportConfig;
+
+static const size_t FIELD_SIDE = 3;
+static const double FIELD_SPACING = 150.0;   // m
+static const size_t NODES = 500;
+static const size_t ROUNDS = 2000;
+static const size_t MIN_SERIES = 20;
+
+struct Event {
+    uint64_t timeMs;          // arrival at the gateway
+    std::string id;
+    DuckPayload::Reading reading;
+    uint64_t takenMs;         // sensing time as the gateway works it out
+
+    bool operator<(const Event& other) const { return timeMs < other.timeMs; }
+};
+
+struct Outcome {
+    unsigned alerts;
+    unsigned basePages;
+    unsigned edgePages;
+    unsigned scoredPages;
+    unsigned held;
+    // Per device: first edge alert and first confirmed alert, fused on
+    // edge predictions, in ms from the start
+    std::map<std::string, std::pair<int64_t, int64_t> > latency;
+};
+
+static Outcome replay(const std::vector<Event>& events) {
+    static PapaInference::Table<> inference;
+    static PapaFusion::Table<> edge;
+    static PapaFusion::Table<> scored;
+    inference = PapaInference::Table<>();
+    edge = PapaFusion::Table<>();
+    scored = PapaFusion::Table<>();
+    std::map<std::string, uint32_t> lastAlert;
+    Outcome o = Outcome();
+    uint64_t start = UINT64_MAX;
+    for (const Event& e : events) start = std::min(start, e.takenMs);
+    for (const Event& e : events) {
+        // 0 is the reading-less marker of takenAt; shift by one
+        uint32_t now = (uint32_t)(e.timeMs - start) + 1;
+        uint32_t taken = (uint32_t)(e.takenMs - start) + 1;
+        const uint8_t* id = (const uint8_t*)e.id.data();
+        bool fire = e.reading.prediction == 1;
+        uint8_t score = 0;
+        PapaInference::Verdict verdict = inference.score(id, e.id.size(), e.reading, taken, now, score);
+        bool kept = fire && verdict != PapaInference::Verdict::VETOED;
+
+        if (fire) {
+            o.alerts++;
+            if (!o.latency.count(e.id)) o.latency[e.id] = std::make_pair((int64_t)now, (int64_t)-1);
+            auto last = lastAlert.find(e.id);
+            if (last == lastAlert.end() || now - last->second >= FusionConfig::CLEAR_AFTER) o.basePages++;
+            lastAlert[e.id] = now;
+        }
+        PapaFusion::Assessment a = edge.add(id, e.id.size(), e.reading, fire, taken, now);
+        o.edgePages += a.paged;
+        if (a.confirmed && o.latency[e.id].second < 0) o.latency[e.id].second = now;
+        o.held += fire && !a.confirmed;
+        if (scored.add(id, e.id.size(), e.reading, kept, taken, now).paged) o.scoredPages++;
+    }
+    return o;
+}
+
+// One device's readings as a MamaDuck with the report policy and batching
+// sends them: counters advance on sent readings only, an alert goes out
+// at once and flushes the open batch behind it, and the gateway dates
+// batch readings back from the batch's arrival
+static void reported(const std::string& id, const std::vector<Sample>& series, std::vector<Event>& out,
+                     unsigned& sent) {
+    DuckReport::Policy policy({ReportConfig::TEMP_DEADBAND, ReportConfig::HUMIDITY_DEADBAND,
+                               ReportConfig::PRESSURE_DEADBAND, ReportConfig::GAS_DEADBAND,
+                               ReportConfig::POSITION_DEADBAND, ReportConfig::HEARTBEAT_INTERVAL});
+    std::vector<Event> batch;
+    uint32_t counter = 1;
+    auto flush = [&](uint64_t at) {
+        if (batch.empty()) return;
+        uint64_t newest = batch.back().takenMs;
+        for (Event e : batch) {
+            e.takenMs = at - (newest - e.takenMs);
+            e.timeMs = at;
+            out.push_back(e);
+        }
+        batch.clear();
+    };
+    for (const Sample& s : series) {
+        if (!batch.empty() && s.timeMs - batch.front().takenMs >= BatchConfig::MAX_AGE) flush(s.timeMs);
+        if (policy.evaluate(s.reading, (uint32_t)s.timeMs) == DuckReport::Reason::SUPPRESSED) continue;
+        Event e = {s.timeMs, id, s.reading, s.timeMs};
+        e.reading.counter = counter++;
+        sent++;
+        if (e.reading.prediction == 1) {
+            out.push_back(e);
+            flush(s.timeMs);
+        } else {
+            batch.push_back(e);
+            if (batch.size() >= BatchConfig::MAX_READINGS) flush(s.timeMs);
+        }
+    }
+    if (!series.empty()) flush(series.back().timeMs);
+}
+
+static void latency(const Outcome& o, const std::string& device, char* out, size_t size) {
+    auto t = o.latency.find(device);
+    if (t == o.latency.end()) {
+        snprintf(out, size, "no alerts");
+    } else if (t->second.second < 0) {
+        snprintf(out, size, "never");
+    } else {
+        snprintf(out, size, "%.1f s", (t->second.second - t->second.first) / 1000.0);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    DeviceSeries data = loadDatasets(argc - 1, argv + 1);
+    std::map<std::string, std::map<std::string, const std::vector<Sample>*> > files;
+    for (const auto& device : data) {
+        // Corrupted rows show up as short series under garbled IDs
+        if (device.second.size() < MIN_SERIES) continue;
+        // Device IDs may contain ':' themselves
+        size_t colon = device.first.find(".csv:") + 4;
+        files[device.first.substr(0, colon)][device.first.substr(colon + 1)] = &device.second;
+    }
+
+    printf("%-34s %7s %9s %9s %11s %9s   %s\n", "export", "alerts", "held", "pages", "fused pages", "+rescore",
+           "field: pages, fused, +rescore");
+    std::vector<std::pair<std::string, const std::map<std::string, const std::vector<Sample>*>*> > multi;
+    for (const auto& file : files) {
+        std::vector<Event> events;
+        bool positioned = false;
+        for (const auto& device : file.second) {
+            for (const Sample& s : *device.second) {
+                events.push_back(Event{s.timeMs, device.first, s.reading, s.timeMs});
+                positioned |= s.reading.hasGPS;
+            }
+        }
+        std::stable_sort(events.begin(), events.end());
+        Outcome o = replay(events);
+        const char* name = strrchr(file.first.c_str(), '/');
+        printf("%-34s %7u %9u %9u %11u %9u", name ? name + 1 : file.first.c_str(), o.alerts, o.held, o.basePages,
+               o.edgePages, o.scoredPages);
+        if (file.second.size() > 1) multi.push_back(std::make_pair(file.first, &file.second));
+
+        if (!positioned) {
+            printf("   no GPS\n");
+            continue;
+        }
+        // The same export as a field of nodes, each from its own offset
+        const auto& series = *file.second.begin()->second;
+        uint64_t start = series.front().timeMs;
+        uint64_t span = series.back().timeMs - start;
+        std::vector<Event> field;
+        for (size_t node = 0; node < FIELD_SIDE * FIELD_SIDE; node++) {
+            uint64_t offset = span * node / (FIELD_SIDE * FIELD_SIDE);
+            char id[9];
+            snprintf(id, sizeof(id), "F%07u", (unsigned)node);
+            for (const Sample& s : series) {
+                uint64_t t = start + (s.timeMs - start + span - offset) % (span + 1);
+                Event e = {t, id, s.reading, t};
+                e.reading.hasGPS = true;
+                e.reading.latitude = 33.4 + (node / FIELD_SIDE) * FIELD_SPACING / 110540.0;
+                e.reading.longitude = -111.9 + (node % FIELD_SIDE) * FIELD_SPACING / 92900.0;
+                field.push_back(e);
+            }
+        }
+        std::stable_sort(field.begin(), field.end());
+        Outcome f = replay(field);
+        printf("   %u, %u, %u\n", f.basePages, f.edgePages, f.scoredPages);
+    }
+
+    // The exports through the MamaDuck report policy and batching
+    printf("\nreported: %.0f s heartbeat, batches of %u readings or %.0f s\n",
+           ReportConfig::HEARTBEAT_INTERVAL / 1000.0, (unsigned)BatchConfig::MAX_READINGS,
+           BatchConfig::MAX_AGE / 1000.0);
+    printf("%-34s %7s %7s %9s %9s %11s %9s\n", "export", "sent", "alerts", "held", "pages", "fused pages",
+           "+rescore");
+    for (const auto& file : files) {
+        std::vector<Event> events;
+        unsigned sent = 0, readings = 0;
+        for (const auto& device : file.second) {
+            reported(device.first, *device.second, events, sent);
+            readings += device.second->size();
+        }
+        std::stable_sort(events.begin(), events.end());
+        Outcome o = replay(events);
+        const char* name = strrchr(file.first.c_str(), '/');
+        printf("%-34s %7u %7u %9u %9u %11u %9u   of %u readings\n", name ? name + 1 : file.first.c_str(), sent,
+               o.alerts, o.held, o.basePages, o.edgePages, o.scoredPages, readings);
+    }
+
+    // Confirmation latency with the neighbours and without, every reading
+    // sent and reported
+    printf("\n%-34s %-10s %18s %12s %12s %12s\n", "export", "device", "alert to confirmed", "alone", "reported",
+           "rep. alone");
+    for (const auto& file : multi) {
+        const char* name = strrchr(file.first.c_str(), '/');
+        std::vector<Event> events, sent;
+        unsigned count = 0;
+        for (const auto& device : *file.second) {
+            for (const Sample& s : *device.second) events.push_back(Event{s.timeMs, device.first, s.reading, s.timeMs});
+            reported(device.first, *device.second, sent, count);
+        }
+        std::stable_sort(events.begin(), events.end());
+        std::stable_sort(sent.begin(), sent.end());
+        Outcome fused = replay(events);
+        Outcome fusedReported = replay(sent);
+        for (const auto& device : *file.second) {
+            std::vector<Event> own, ownSent;
+            for (const Sample& s : *device.second) own.push_back(Event{s.timeMs, device.first, s.reading, s.timeMs});
+            reported(device.first, *device.second, ownSent, count);
+            std::stable_sort(ownSent.begin(), ownSent.end());
+            Outcome alone = replay(own);
+            Outcome aloneReported = replay(ownSent);
+            char times[4][24];
+            const Outcome* outcomes[4] = {&fused, &alone, &fusedReported, &aloneReported};
+            for (int i = 0; i < 4; i++) latency(*outcomes[i], device.first, times[i], sizeof(times[i]));
+            printf("%-34s %-10s %18s %12s %12s %12s\n", name ? name + 1 : file.first.c_str(), device.first.c_str(),
+                   times[0], times[1], times[2], times[3]);
+        }
+    }
+
+    // Throughput
+    static PapaFusion::Table<> table;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> position(0.0, 3000.0);
+    std::vector<DuckPayload::Reading> readings(NODES);
+    std::vector<std::string> ids(NODES);
+    for (size_t i = 0; i < NODES; i++) {
+        char id[9];
+        snprintf(id, sizeof(id), "D%07u", (unsigned)i);
+        ids[i] = id;
+        DuckPayload::Reading& r = readings[i];
+        memset(&r, 0, sizeof(r));
+        r.temp = 25.0f;
+        r.gas = 80000.0f;
+        r.hasGPS = true;
+        r.latitude = 33.4 + position(rng) / 110540.0;
+        r.longitude = -111.9 + position(rng) / 92900.0;
+    }
+    unsigned pages = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < ROUNDS; round++) {
+        uint32_t now = (uint32_t)(round * 10000 + 1);
+        for (size_t i = 0; i < NODES; i++) {
+            readings[i].temp += (rng() & 1) ? 0.05f : -0.05f;
+            bool fire = rng() % 20 == 0;
+            pages += table.add((const uint8_t*)ids[i].data(), 8, readings[i], fire, now + (uint32_t)i, now + (uint32_t)i).paged;
+        }
+    }
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t count = NODES * ROUNDS;
+    printf("\n%u nodes x %u readings: %.3f s, %.0f readings/s, %.2f us per reading\n", (unsigned)NODES,
+           (unsigned)ROUNDS, total, count / total, total / count * 1e6);
+    printf("  table for %u nodes: %u bytes; %u alerts, %u held, %u incidents, %u joined, %u evictions\n",
+           (unsigned)table.capacity(), (unsigned)table.memoryBytes(), (unsigned)table.counters().alerts,
+           (unsigned)table.counters().held, pages, (unsigned)table.counters().joined,
+           (unsigned)table.counters().evictions);
+    return 0;
+}
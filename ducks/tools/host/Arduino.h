@@ -0,0 +1,69 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Minimal Arduino/ESP32 stand-in so the host tools can compile the MamaDuck
+// headers unchanged. Time is a virtual clock the tool advances itself, and
+// esp_random() is a seeded xorshift so runs are reproducible.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef void* TaskHandle_t;
+typedef unsigned int UBaseType_t;
+
+namespace HostClock {
+inline uint64_t& nowMs() {
+    static uint64_t now = 0;
+    return now;
+}
+inline void advance(uint64_t ms) { nowMs() += ms; }
+inline void set(uint64_t ms) { nowMs() = ms; }
+}
+
+inline unsigned long millis() { return (unsigned long)(uint32_t)HostClock::nowMs(); }
+inline void delay(unsigned long ms) { HostClock::advance(ms); }
+
+namespace HostRandom {
+inline uint32_t& state() {
+    static uint32_t s = 0x2545F491;
+    return s;
+}
+inline void seed(uint32_t s) { state() = s ? s : 1; }
+}
+
+inline uint32_t esp_random() {
+    uint32_t& s = HostRandom::state();
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) { return 4096; }
+
+// Serial output is muted by default so firmware logging does not swamp
+// the tool's own report
+class HostSerial {
+public:
+    bool enabled = false;
+
+    void printf(const char* format, ...) {
+        if (!enabled) return;
+        va_list args;
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+    }
+    void print(const char* s) { if (enabled) fputs(s, stdout); }
+    void println(const char* s = "") { if (enabled) puts(s); }
+};
+
+static HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,32 @@
+#ifndef HOST_CIRCULAR_BUFFER_H
+#define HOST_CIRCULAR_BUFFER_H
+
+#include <stddef.h>
+
+// Host stand-in for the CircularBuffer library: push() appends and drops the
+// oldest element when full, operator[] indexes from the oldest element
+template <typename T, size_t S>
+class CircularBuffer {
+private:
+    T buffer[S] = {};
+    size_t head = 0;
+    size_t count = 0;
+
+public:
+    bool push(T value) {
+        buffer[(head + count) % S] = value;
+        if (count < S) {
+            count++;
+            return true;
+        }
+        head = (head + 1) % S;
+        return false;
+    }
+
+    T operator[](size_t index) const { return buffer[(head + index) % S]; }
+    size_t size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count == S; }
+};
+
+#endif // HOST_CIRCULAR_BUFFER_H
@@ -0,0 +1,84 @@
+#ifndef HOST_FILE_FLASH_H
+#define HOST_FILE_FLASH_H
+
+// File-backed NOR flash emulator for PapaStore. Writes can only clear bits
+// and erase resets a sector to 0xFF, like the ESP32 SPI flash. The file
+// outlives the object, so reopening it emulates a reboot. A write budget
+// emulates a power cut in the middle of a write.
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "PapaStore.h"
+
+class FileFlash : public PapaStore::Flash {
+private:
+    FILE* file;
+    size_t bytes;
+    size_t sector;
+    long budget;  // bytes left before the power cut, -1 for none
+
+public:
+    std::vector<uint32_t> sectorErases;
+    size_t reads = 0;
+
+    // Opens path, creating a blank (erased) image when it does not exist
+    FileFlash(const char* path, size_t size, size_t sectorSize)
+        : file(NULL), bytes(size), sector(sectorSize), budget(-1), sectorErases(size / sectorSize) {
+        file = fopen(path, "r+b");
+        if (!file) {
+            file = fopen(path, "w+b");
+            std::vector<uint8_t> blank(sectorSize, 0xFF);
+            for (size_t i = 0; i < size / sectorSize; i++) {
+                fwrite(blank.data(), 1, blank.size(), file);
+            }
+            fflush(file);
+        }
+    }
+
+    ~FileFlash() {
+        if (file) fclose(file);
+    }
+
+    void cutPowerAfter(long bytesWritten) { budget = bytesWritten; }
+
+    size_t size() const override { return bytes; }
+    size_t sectorSize() const override { return sector; }
+
+    bool read(size_t address, void* buffer, size_t length) override {
+        if (address + length > bytes) return false;
+        reads++;
+        fseek(file, (long)address, SEEK_SET);
+        return fread(buffer, 1, length, file) == length;
+    }
+
+    bool write(size_t address, const void* data, size_t length) override {
+        if (address + length > bytes) return false;
+        size_t allowed = length;
+        if (budget >= 0 && (size_t)budget < length) allowed = (size_t)budget;
+        std::vector<uint8_t> cell(allowed);
+        fseek(file, (long)address, SEEK_SET);
+        if (fread(cell.data(), 1, allowed, file) != allowed) return false;
+        const uint8_t* in = (const uint8_t*)data;
+        for (size_t i = 0; i < allowed; i++) cell[i] &= in[i];
+        fseek(file, (long)address, SEEK_SET);
+        fwrite(cell.data(), 1, allowed, file);
+        fflush(file);
+        if (budget >= 0) budget -= (long)allowed;
+        return allowed == length;
+    }
+
+    bool erase(size_t address) override {
+        if (budget == 0) return false;
+        size_t start = address - address % sector;
+        std::vector<uint8_t> blank(sector, 0xFF);
+        fseek(file, (long)start, SEEK_SET);
+        fwrite(blank.data(), 1, sector, file);
+        fflush(file);
+        sectorErases[start / sector]++;
+        return true;
+    }
+};
+
+#endif // HOST_FILE_FLASH_H
@@ -0,0 +1,20 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// Minimal FreeRTOS stand-in for the host tools. There is no scheduler:
+// DuckLog's drain task is never created, so log records stay in its ring.
+
+#include <stdint.h>
+#include "Arduino.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef uint8_t StackType_t;
+typedef struct { uint8_t unused; } StaticTask_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define tskIDLE_PRIORITY ((UBaseType_t)0)
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,15 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+
+inline TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t,
+                                                  StackType_t*, StaticTask_t*, BaseType_t) {
+    return NULL;
+}
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,168 @@
+/**
+ * @file inference_bench.cpp
+ * @brief Host benchmark of PapaDuck re-scoring: throughput at 500 devices and verdicts per export
+ *
+ * Throughput: 500 devices, each replaying one device series from the
+ * gateway exports from its own offset, report one reading per 10 s round
+ * into a PapaInference::Table of the shipped InferenceConfig::DEVICES, as
+ * the publish task would call it: built with -DPAPA_LARGE_TABLES that is
+ * the ESP32-S3 gateway, which tracks all 500; without it the classic
+ * ESP32 one, which tracks 128 and evicts. Reported per reading: the whole score()
+ * call, the worst case of a device the full table has not seen (eviction
+ * and index rebuild), and the ensemble alone on a fixed window.
+ *
+ * Verdicts: each export is replayed through a fresh table on its recorded
+ * timestamps, and the edge predictions in it (Pred) are set against what
+ * the gateway made of them. The Data_NoFire collections had no fire, so
+ * every edge alert there is a false alarm a veto should catch.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -DPAPA_LARGE_TABLES -Iducks/common -Iducks/papa_duck ducks/tools/inference_bench.cpp \
+ *       -o /tmp/inference_bench
+ *   /tmp/inference_bench datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "DuckPayload.h"
+#include "PapaInference.h"
+#include "DatasetReader.h"
+
+using PapaInference::Verdict;
+
+static const size_t DEVICES = 500;
+static const size_t ROUNDS = 2000;
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void deviceId(size_t i, uint8_t id[8]) {
+    char text[9];
+    snprintf(text, sizeof(text), "D%07u", (unsigned)i);
+    memcpy(id, text, 8);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    DeviceSeries data = loadDatasets(argc - 1, argv + 1);
+    std::vector<const std::vector<Sample>*> series;
+    for (const auto& device : data) {
+        if (device.second.size() > PapaConfig::InferenceConfig::HISTORY) series.push_back(&device.second);
+    }
+    if (series.empty()) {
+        fprintf(stderr, "no device series in the given files\n");
+        return 1;
+    }
+
+    // Throughput at 500 devices
+    static PapaInference::Table<> table;
+    printf("table for %u devices: %u bytes, %u per device\n", (unsigned)table.capacity(),
+           (unsigned)table.memoryBytes(), (unsigned)(table.memoryBytes() / table.capacity()));
+    std::vector<size_t> position(DEVICES);
+    std::vector<uint32_t> counter(DEVICES);
+    std::vector<std::array<uint8_t, 8> > ids(DEVICES);
+    for (size_t i = 0; i < DEVICES; i++) {
+        position[i] = (i * 7919) % series[i % series.size()]->size();
+        counter[i] = 1;
+        deviceId(i, ids[i].data());
+    }
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < ROUNDS; round++) {
+        uint32_t now = (uint32_t)(round * PapaConfig::InferenceConfig::SENSE_INTERVAL);
+        for (size_t i = 0; i < DEVICES; i++) {
+            const std::vector<Sample>& s = *series[i % series.size()];
+            DuckPayload::Reading r = s[position[i]].reading;
+            position[i] = (position[i] + 1) % s.size();
+            r.counter = counter[i]++;
+            uint8_t score = 0;
+            checksum += (uint8_t)table.score(ids[i].data(), 8, r, now + (uint32_t)i, now + (uint32_t)i, score) + score;
+        }
+    }
+    double total = seconds(start);
+    size_t readings = ROUNDS * DEVICES;
+
+    // A new device every reading into a table kept full
+    static PapaInference::Table<> fresh;
+    DuckPayload::Reading r = series[0]->front().reading;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < 50000; i++) {
+        uint8_t id[8], score = 0;
+        deviceId(i % 4096, id);
+        checksum += (uint8_t)fresh.score(id, 8, r, (uint32_t)i, (uint32_t)i, score);
+    }
+    double admit = seconds(start) / 50000;
+
+    // Ensemble only
+    float v3[PapaInference::FEATURES], v2[PapaInference::FEATURES];
+    float window[PapaConfig::InferenceConfig::HISTORY][4];
+    for (size_t i = 0; i < PapaConfig::InferenceConfig::HISTORY; i++) {
+        const DuckPayload::Reading& x = (*series[0])[i].reading;
+        float values[4] = {x.temp, x.humidity, x.pressure, x.gas};
+        memcpy(window[i], values, sizeof(values));
+    }
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < 200000; i++) {
+        window[i % PapaConfig::InferenceConfig::HISTORY][3] += 1.0f;
+        PapaInference::features(window, i % PapaConfig::InferenceConfig::HISTORY, v3, v2);
+        checksum += PapaInference::ensembleScore(v3, v2);
+    }
+    double ensemble = seconds(start) / 200000;
+
+    printf("%u devices x %u readings: %.3f s, %.0f readings/s, %.2f us per reading (%u scored)\n",
+           (unsigned)DEVICES, (unsigned)ROUNDS, total, readings / total, total / readings * 1e6,
+           (unsigned)table.counters().scored);
+    printf("  new device in a full table %.2f us, features and 20 trees %.2f us\n", admit * 1e6, ensemble * 1e6);
+    printf("  %u devices tracked, %u evictions, checksum %llu\n\n", (unsigned)table.tracked(),
+           (unsigned)table.counters().evictions, (unsigned long long)checksum);
+
+    // Verdicts on the recorded exports
+    std::map<std::string, std::vector<std::pair<std::string, const std::vector<Sample>*> > > files;
+    for (const auto& device : data) {
+        // Device IDs may contain ':' themselves
+        size_t colon = device.first.find(".csv:") + 4;
+        files[device.first.substr(0, colon)].push_back(std::make_pair(device.first.substr(colon + 1), &device.second));
+    }
+    printf("%-44s %8s %8s %11s %10s %8s %8s %8s\n", "export", "readings", "scored", "edge fire", "confirmed",
+           "uncert.", "vetoed", "raised");
+    for (const auto& file : files) {
+        static PapaInference::Table<> replay;
+        replay = PapaInference::Table<>();
+        unsigned edgeFire = 0, readingsIn = 0;
+        // Interleave the devices of one export in time order
+        std::vector<std::pair<uint64_t, std::pair<size_t, size_t> > > order;
+        for (size_t d = 0; d < file.second.size(); d++) {
+            for (size_t k = 0; k < file.second[d].second->size(); k++) {
+                order.push_back(std::make_pair((*file.second[d].second)[k].timeMs, std::make_pair(d, k)));
+            }
+        }
+        std::sort(order.begin(), order.end());
+        uint64_t first = order.empty() ? 0 : order.front().first;
+        for (const auto& o : order) {
+            const std::string& id = file.second[o.second.first].first;
+            const DuckPayload::Reading& reading = (*file.second[o.second.first].second)[o.second.second].reading;
+            uint8_t score = 0;
+            uint32_t now = (uint32_t)(o.first - first);
+            Verdict v = replay.score((const uint8_t*)id.data(), id.size(), reading, now, now, score);
+            readingsIn++;
+            if (reading.prediction == 1 && v != Verdict::UNSCORED) edgeFire++;
+        }
+        const PapaInference::Stats& s = replay.counters();
+        const char* name = strrchr(file.first.c_str(), '/');
+        printf("%-44s %8u %8u %11u %10u %8u %8u %8u\n", name ? name + 1 : file.first.c_str(), readingsIn,
+               (unsigned)s.scored, edgeFire, (unsigned)s.confirmed, (unsigned)s.uncertain, (unsigned)s.vetoed,
+               (unsigned)s.raised);
+    }
+    return 0;
+}
@@ -0,0 +1,361 @@
+/**
+ * @file json_bench.cpp
+ * @brief Host benchmark of the PapaDuck JSON forwarding path
+ *
+ * Builds CDP packets from the gateway exports in datasets/ as text
+ * payloads, binary records and batches of 12. Each packet is then
+ * forwarded two ways. The legacy path copies the packet fields into
+ * std::strings, concatenates the topic, serializes into a string,
+ * pretty-prints it for Serial and hex-dumps the packet. The new path is
+ * PapaJson into a static buffer with a precomputed topic prefix.
+ * ArduinoJson is not available on the host, so the legacy serializer is a
+ * std::string stand-in with the same output; its allocation count is a
+ * lower bound for the old code. Both outputs are compared message by
+ * message.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/common -Iducks/papa_duck ducks/tools/json_bench.cpp -o /tmp/json_bench
+ *   /tmp/json_bench datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "DuckPayload.h"
+#include "DuckBatch.h"
+#include "PapaJson.h"
+#include "DatasetReader.h"
+
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// The fields of a CdpPacket the forwarding path reads
+struct Packet {
+    std::vector<uint8_t> sduid, dduid, muid, path, data;
+    uint8_t topic;
+    uint8_t hopCount;
+    uint8_t duckType;
+};
+
+static const uint8_t TOPIC_LOCATION = 0x16;
+static const char* THING = "owl-papa-duck-01";
+
+// --- legacy path ---------------------------------------------------------
+
+static std::string convertToHex(const uint8_t* data, size_t size) {
+    std::string buf;
+    buf.reserve(size * 2);
+    const char* cs = "0123456789ABCDEF";
+    for (size_t i = 0; i < size; i++) {
+        buf += cs[(data[i] >> 4) & 0x0F];
+        buf += cs[data[i] & 0x0F];
+    }
+    return buf;
+}
+
+static std::string quote(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// Key/value list serialized compact or pretty, in insertion order
+struct LegacyDoc {
+    std::vector<std::pair<std::string, std::string>> fields;
+
+    void set(const std::string& key, const std::string& json) {
+        for (auto& f : fields) {
+            if (f.first == key) {
+                f.second = json;
+                return;
+            }
+        }
+        fields.push_back(std::make_pair(key, json));
+    }
+
+    std::string serialize(bool pretty) const {
+        std::string out = pretty ? "{\n" : "{";
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (i) out += pretty ? ",\n" : ",";
+            if (pretty) out += "  ";
+            out += quote(fields[i].first) + (pretty ? ": " : ":") + fields[i].second;
+        }
+        return out + (pretty ? "\n}" : "}");
+    }
+};
+
+static std::string ageJson(uint32_t tenths) {
+    char buf[16];
+    if (tenths % 10) {
+        snprintf(buf, sizeof(buf), "%u.%u", tenths / 10, tenths % 10);
+    } else {
+        snprintf(buf, sizeof(buf), "%u", tenths / 10);
+    }
+    return buf;
+}
+
+static size_t legacySink = 0;
+
+static void legacyPublish(const LegacyDoc& doc, const std::string& topic,
+                          std::vector<std::string>* out) {
+    std::string json = doc.serialize(false);
+    std::string pretty = doc.serialize(true);  // serializeJsonPretty(doc, Serial)
+    legacySink += json.size() + pretty.size() + topic.size();
+    if (out) out->push_back(json);
+}
+
+static void legacyForward(Packet packet, std::vector<std::string>* out) {
+    std::string dump = std::string("[PAPA] got packet: ") + convertToHex(packet.data.data(), packet.data.size());
+    legacySink += dump.size();
+
+    std::string payload(packet.data.begin(), packet.data.end());
+    std::string sduid(packet.sduid.begin(), packet.sduid.end());
+    std::string dduid(packet.dduid.begin(), packet.dduid.end());
+    std::string muid(packet.muid.begin(), packet.muid.end());
+    std::string path(packet.path.begin(), packet.path.end());
+
+    LegacyDoc doc;
+    doc.set("DeviceID", quote(sduid));
+    doc.set("MessageID", quote(muid));
+    doc.set("path", quote(path));
+    doc.set("hops", std::to_string(packet.hopCount));
+    doc.set("duckType", std::to_string(packet.duckType));
+
+    std::string topic = "owl/device/" + std::string(THING) + "/evt/" + std::string("gps");
+
+    DuckPayload::Reading reading;
+    char text[DuckPayload::TEXT_SIZE];
+    if (DuckBatch::isBatch(packet.data.data(), packet.data.size())) {
+        DuckBatch::Decoder decoder(packet.data.data(), packet.data.size());
+        DuckBatch::Entry entry;
+        uint8_t count = 0;
+        uint32_t newest = 0;
+        while (decoder.next(entry)) {
+            newest = entry.timestamp;
+            count++;
+        }
+        DuckBatch::Decoder readings(packet.data.data(), packet.data.size());
+        for (uint8_t i = 0; i < count && readings.next(entry); i++) {
+            DuckBatch::toReading(entry, reading);
+            DuckPayload::toText(reading, text, sizeof(text));
+            doc.set("MessageID", quote(muid + "-" + std::to_string(i)));
+            doc.set("Payload", quote(text));
+            doc.set("age", ageJson(newest - entry.timestamp));
+            legacyPublish(doc, topic, out);
+        }
+        return;
+    }
+    if (DuckPayload::decode(packet.data.data(), packet.data.size(), reading)) {
+        DuckPayload::toText(reading, text, sizeof(text));
+        doc.set("Payload", quote(text));
+    } else {
+        doc.set("Payload", quote(payload));
+    }
+    legacyPublish(doc, topic, out);
+}
+
+// --- new path, as in PapaDuck::quackJson --------------------------------
+
+static char jsonBuffer[PapaJson::BUFFER_SIZE];
+static PapaJson::Topic evtTopic;
+static size_t sink = 0;
+
+static void publish(const char* topic, size_t length, std::vector<std::string>* out) {
+    sink += length + strlen(topic);
+    if (out) out->push_back(std::string(jsonBuffer, length));
+}
+
+static void forward(const Packet& packet, std::vector<std::string>* out) {
+    PapaJson::Message message = PapaJson::message();
+    message.deviceId = PapaJson::span(packet.sduid.data(), packet.sduid.size());
+    message.messageId = PapaJson::span(packet.muid.data(), packet.muid.size());
+    message.path = PapaJson::span(packet.path.data(), packet.path.size());
+    message.payload = PapaJson::span(packet.data.data(), packet.data.size());
+    message.hops = packet.hopCount;
+    message.duckType = packet.duckType;
+
+    const char* topic = evtTopic.with("gps");
+
+    DuckPayload::Reading reading;
+    char text[DuckPayload::TEXT_SIZE];
+    if (DuckBatch::isBatch(packet.data.data(), packet.data.size())) {
+        DuckBatch::Decoder decoder(packet.data.data(), packet.data.size());
+        DuckBatch::Entry entry;
+        uint8_t count = 0;
+        uint32_t newest = 0;
+        while (decoder.next(entry)) {
+            newest = entry.timestamp;
+            count++;
+        }
+        DuckBatch::Decoder readings(packet.data.data(), packet.data.size());
+        for (uint8_t i = 0; i < count && readings.next(entry); i++) {
+            DuckBatch::toReading(entry, reading);
+            int length = DuckPayload::toText(reading, text, sizeof(text));
+            message.payload = PapaJson::span((const uint8_t*)text, length > 0 ? strnlen(text, sizeof(text)) : 0);
+            message.readingIndex = i;
+            message.ageTenths = newest - entry.timestamp;
+            publish(topic, PapaJson::serialize(message, jsonBuffer, sizeof(jsonBuffer)), out);
+        }
+        return;
+    }
+    if (DuckPayload::decode(packet.data.data(), packet.data.size(), reading)) {
+        int length = DuckPayload::toText(reading, text, sizeof(text));
+        message.payload = PapaJson::span((const uint8_t*)text, length > 0 ? strnlen(text, sizeof(text)) : 0);
+    }
+    publish(topic, PapaJson::serialize(message, jsonBuffer, sizeof(jsonBuffer)), out);
+}
+
+// ArduinoJson wrote control characters other than \b\f\n\r\t raw, PapaJson
+// escapes them; undo that before comparing
+static std::string unescapeControls(const std::string& json) {
+    std::string out;
+    for (size_t i = 0; i < json.size(); i++) {
+        if (json.compare(i, 4, "\\u00") == 0 && i + 6 <= json.size()) {
+            out += (char)strtol(json.substr(i + 4, 2).c_str(), NULL, 16);
+            i += 5;
+        } else {
+            out += json[i];
+        }
+    }
+    return out;
+}
+
+// --- packets ---------------------------------------------------------------
+
+static std::vector<uint8_t> bytes(const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+static Packet makePacket(const std::string& device, uint32_t n, std::vector<uint8_t> data) {
+    std::string id = device.substr(device.rfind(':') + 1);
+    id.resize(8, '0');
+    char muid[5];
+    snprintf(muid, sizeof(muid), "%04X", n & 0xFFFF);
+    Packet p;
+    p.sduid = bytes(id);
+    p.dduid = bytes("PAPADUCK");
+    p.muid = bytes(muid);
+    p.path = bytes(id + "MAMA0002");
+    p.data = data;
+    p.topic = TOPIC_LOCATION;
+    p.hopCount = 2;
+    p.duckType = 2;
+    return p;
+}
+
+enum class Mix { TEXT, RECORD, BATCH };
+
+static std::vector<Packet> buildPackets(const DeviceSeries& devices, Mix mix) {
+    std::vector<Packet> packets;
+    uint32_t n = 0;
+    for (const auto& device : devices) {
+        DuckBatch::Encoder encoder;
+        for (const Sample& s : device.second) {
+            if (mix == Mix::TEXT) {
+                char text[DuckPayload::TEXT_SIZE];
+                DuckPayload::toText(s.reading, text, sizeof(text));
+                packets.push_back(makePacket(device.first, n++, bytes(text)));
+            } else if (mix == Mix::RECORD) {
+                std::vector<uint8_t> record(DuckPayload::RECORD_SIZE);
+                DuckPayload::encode(s.reading, record.data(), record.size());
+                packets.push_back(makePacket(device.first, n++, record));
+            } else {
+                DuckBatch::Entry e = DuckBatch::fromReading(s.reading, (uint32_t)s.timeMs);
+                if (encoder.count() >= 12 || !encoder.append(e)) {
+                    const uint8_t* data = encoder.data();
+                    packets.push_back(makePacket(device.first, n++, std::vector<uint8_t>(data, data + encoder.size())));
+                    encoder.reset();
+                    encoder.append(e);
+                }
+            }
+        }
+    }
+    return packets;
+}
+
+struct Run {
+    double packetsPerSecond;
+    double messagesPerSecond;
+    double allocationsPerPacket;
+};
+
+template <typename Forward>
+static Run measure(const std::vector<Packet>& packets, size_t messages, Forward f) {
+    size_t rounds = 0;
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    while (elapsed < 1.0) {
+        for (const Packet& p : packets) f(p);
+        rounds++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    Run r;
+    r.packetsPerSecond = rounds * packets.size() / elapsed;
+    r.messagesPerSecond = rounds * messages / elapsed;
+    r.allocationsPerPacket = (double)(allocations - before) / (rounds * packets.size());
+    return r;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    DeviceSeries devices = loadDatasets(argc - 1, argv + 1);
+    evtTopic.begin(THING);
+
+    static const struct { Mix mix; const char* label; } MIXES[] = {
+        {Mix::TEXT, "text payload"},
+        {Mix::RECORD, "binary record"},
+        {Mix::BATCH, "batch of 12"},
+    };
+    int failures = 0;
+    for (const auto& m : MIXES) {
+        std::vector<Packet> packets = buildPackets(devices, m.mix);
+
+        std::vector<std::string> legacyOut, newOut;
+        for (const Packet& p : packets) {
+            legacyForward(p, &legacyOut);
+            forward(p, &newOut);
+        }
+        size_t mismatches = legacyOut.size() == newOut.size() ? 0 : 1;
+        size_t escaped = 0;
+        for (size_t i = 0; i < legacyOut.size() && i < newOut.size(); i++) {
+            if (legacyOut[i] == newOut[i]) continue;
+            if (legacyOut[i] == unescapeControls(newOut[i])) {
+                escaped++;
+            } else {
+                if (!mismatches) printf("  first mismatch:\n    %s\n    %s\n", legacyOut[i].c_str(), newOut[i].c_str());
+                mismatches++;
+            }
+        }
+        failures += mismatches != 0;
+
+        Run legacy = measure(packets, legacyOut.size(), [](const Packet& p) { legacyForward(p, NULL); });
+        Run fresh = measure(packets, newOut.size(), [](const Packet& p) { forward(p, NULL); });
+        printf("%-14s %6zu packets %6zu messages  legacy %8.0f pkt/s %8.0f msg/s %5.1f allocs/pkt"
+               "  static %8.0f pkt/s %8.0f msg/s %5.1f allocs/pkt  %4.1fx  %zu mismatches, %zu escaped\n",
+               m.label, packets.size(), newOut.size(),
+               legacy.packetsPerSecond, legacy.messagesPerSecond, legacy.allocationsPerPacket,
+               fresh.packetsPerSecond, fresh.messagesPerSecond, fresh.allocationsPerPacket,
+               fresh.packetsPerSecond / legacy.packetsPerSecond, mismatches, escaped);
+    }
+    if (legacySink == 42 && sink == 42) printf("\n");  // keep the sinks live
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file link_sim.cpp
+ * @brief Host comparison of the blocking PapaDuck reconnect loop and PapaLink
+ *
+ * Replays a 30 s outage on a virtual 1 ms clock and counts the LoRa
+ * packets the gateway never reads. The radio holds one received packet
+ * until duck.run() picks it up; a packet arriving while the previous one
+ * is still waiting overwrites it and is lost. Packets read while offline
+ * go to the store and are not counted as lost.
+ *
+ * Old loop: a blocking duck.reconnectWifi() every 5 s while WiFi is down,
+ * and a blocking client.connect() on every pass while the broker is
+ * unreachable, with handleDuckData subscribing to the command topic after
+ * every packet. New loop: PapaLink::Manager polled next to duck.run(),
+ * with the connect running elsewhere.
+ *
+ * How long a failed connect or WiFi join blocks depends on the network
+ * (TCP/TLS timeouts, scan time), so both are swept.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/common -Iducks/papa_duck ducks/tools/link_sim.cpp -o /tmp/link_sim
+ *   /tmp/link_sim
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "PapaLink.h"
+
+static const uint32_t RUN_TIME = 120000;
+static const uint32_t OUTAGE_START = 30000;
+static const uint32_t OUTAGE_END = 60000;
+static const uint32_t CONNECT_TIME = 400;   // successful TLS + MQTT connect
+static const uint32_t JOIN_TIME = 2500;     // successful WiFi association
+static const uint32_t NODES = 20;
+static const uint32_t NODE_INTERVAL = 10000;
+
+enum Outage { BROKER, ACCESS_POINT };
+
+struct Network {
+    Outage outage;
+    bool up(uint32_t t) const { return t < OUTAGE_START || t >= OUTAGE_END; }
+    bool apUp(uint32_t t) const { return outage != ACCESS_POINT || up(t); }
+    bool brokerUp(uint32_t t) const { return apUp(t) && up(t); }
+};
+
+// One-packet receive buffer fed by nodes on fixed, staggered schedules
+struct Radio {
+    std::vector<uint32_t> arrivals;
+    size_t next = 0;
+    bool holding = false;
+    uint32_t received = 0, lost = 0, read = 0;
+
+    Radio() {
+        uint32_t seed = 12345;
+        for (uint32_t n = 0; n < NODES; n++) {
+            seed = seed * 1103515245 + 12345;
+            uint32_t phase = (seed >> 8) % NODE_INTERVAL;
+            for (uint32_t t = phase; t < RUN_TIME; t += NODE_INTERVAL) arrivals.push_back(t);
+        }
+        std::sort(arrivals.begin(), arrivals.end());
+    }
+
+    // Advances the air to time t
+    void air(uint32_t t) {
+        while (next < arrivals.size() && arrivals[next] <= t) {
+            received++;
+            if (holding) lost++;
+            holding = true;
+            next++;
+        }
+    }
+
+    // duck.run(): true if a packet was handed to handleDuckData
+    bool run() {
+        if (!holding) return false;
+        holding = false;
+        read++;
+        return true;
+    }
+};
+
+struct Result {
+    uint32_t received, lost, subscribes, sessions;
+};
+
+// The loop before PapaLink, reduced to its timing
+static Result oldLoop(const Network& net, uint32_t connectBlock, uint32_t wifiBlock) {
+    Radio radio;
+    Result r = {};
+    uint32_t t = 0, retryAt = 0;
+    bool retry = true, wifi = true, connected = false;
+    while (t < RUN_TIME) {
+        radio.air(t);
+        if (!net.apUp(t)) wifi = false;
+        if (connected && !net.brokerUp(t)) connected = false;
+
+        if (!wifi && retry) {
+            // duck.reconnectWifi(): scan and join, blocking either way
+            bool ok = net.apUp(t);
+            t += ok ? JOIN_TIME : wifiBlock;
+            radio.air(t);
+            wifi = ok && net.apUp(t);
+            if (!wifi) retry = false;
+            retryAt = t + 5000;
+        }
+        if (!connected && wifi) {
+            // mqttConnect(): client.connect() blocks until it succeeds or times out
+            bool ok = net.brokerUp(t);
+            t += ok ? CONNECT_TIME : connectBlock;
+            radio.air(t);
+            connected = ok && net.brokerUp(t);
+            if (connected) {
+                r.sessions++;
+            } else if (retry) {
+                retry = false;
+                retryAt = t + 5000;
+            }
+        }
+        if (!retry && (int32_t)(t - retryAt) >= 0) retry = true;
+
+        if (radio.run() && connected) r.subscribes++;  // subscribeTo() in handleDuckData
+        t++;
+    }
+    r.received = radio.received;
+    r.lost = radio.lost;
+    return r;
+}
+
+// Simulated platform behind PapaLink: WiFi joins and MQTT connects finish
+// in the background after their nominal duration
+class FakeLink : public PapaLink::Link {
+public:
+    const Network& net;
+    uint32_t now = 0, connectBlock, wifiBlock;
+    bool wifi = true, connected = false;
+    bool joining = false, connecting = false;
+    uint32_t doneAt = 0, joinAt = 0;
+    bool outcome = false, joinOutcome = false;
+    uint32_t subscribes = 0;
+
+    FakeLink(const Network& n, uint32_t connectBlock, uint32_t wifiBlock)
+        : net(n), connectBlock(connectBlock), wifiBlock(wifiBlock) {}
+
+    void advance(uint32_t t) {
+        now = t;
+        if (!net.apUp(t)) {
+            wifi = false;
+            joining = false;
+        }
+        if (joining && (int32_t)(t - joinAt) >= 0) {
+            joining = false;
+            wifi = joinOutcome && net.apUp(t);
+        }
+        if (connected && !net.brokerUp(t)) connected = false;
+    }
+
+    bool wifiConnected() override { return wifi; }
+    void wifiBegin() override {
+        joining = true;
+        joinOutcome = net.apUp(now);
+        joinAt = now + (joinOutcome ? JOIN_TIME : wifiBlock);
+    }
+    void mqttStart() override {
+        connecting = true;
+        outcome = net.brokerUp(now);
+        doneAt = now + (outcome ? CONNECT_TIME : connectBlock);
+    }
+    int8_t mqttResult() override {
+        if (connecting && (int32_t)(now - doneAt) < 0) return -1;
+        connecting = false;
+        connected = outcome && net.brokerUp(now);
+        return connected ? 1 : 0;
+    }
+    bool mqttConnected() override { return connected; }
+    void mqttStop() override { connected = false; }
+    bool subscribe() override {
+        subscribes++;
+        return true;
+    }
+};
+
+static Result newLoop(const Network& net, uint32_t connectBlock, uint32_t wifiBlock) {
+    Radio radio;
+    FakeLink fake(net, connectBlock, wifiBlock);
+    PapaLink::Manager manager;
+    manager.begin(fake, 0x1234567, 0);
+    for (uint32_t t = 0; t < RUN_TIME; t++) {
+        radio.air(t);
+        fake.advance(t);
+        manager.poll(t);
+        radio.run();
+    }
+    Result r = {radio.received, radio.lost, fake.subscribes, manager.counters().sessions};
+    return r;
+}
+
+int main() {
+    static const struct { const char* label; Outage outage; } CASES[] = {
+        {"broker unreachable, WiFi up", BROKER},
+        {"access point down", ACCESS_POINT},
+    };
+    static const uint32_t BLOCKS[] = {3000, 10000, 15000};
+    printf("%u nodes every %u s, %u s outage in a %u s run\n", (unsigned)NODES,
+           (unsigned)(NODE_INTERVAL / 1000), (unsigned)((OUTAGE_END - OUTAGE_START) / 1000),
+           (unsigned)(RUN_TIME / 1000));
+    int failures = 0;
+    for (const auto& c : CASES) {
+        printf("%s\n", c.label);
+        Network net = {c.outage};
+        for (uint32_t block : BLOCKS) {
+            Result before = oldLoop(net, block, block);
+            Result after = newLoop(net, block, block);
+            printf("  failed attempt blocks %2u s: lost %3u/%u before, %3u/%u after;"
+                   "  SUBSCRIBE %3u before, %u after; sessions %u/%u\n",
+                   (unsigned)(block / 1000), (unsigned)before.lost, (unsigned)before.received,
+                   (unsigned)after.lost, (unsigned)after.received, (unsigned)before.subscribes,
+                   (unsigned)after.subscribes, (unsigned)before.sessions, (unsigned)after.sessions);
+            failures += after.lost != 0 || after.sessions < 2;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,754 @@
+/**
+ * @file mesh_sim.cpp
+ * @brief Discrete-event simulation of a MamaDuck mesh reporting to one PapaDuck
+ *
+ * Every virtual MamaDuck runs the mama_duck_v6 pipeline on replayed gateway
+ * exports: the real SensorManager features and random forest, the report
+ * policy, DuckBatch coalescing of routine readings, the DuckSequence send
+ * window and the DuckSchedule TX slots (with GPS time). The PapaDuck runs
+ * the steps of forwardPacket() with the real receive ring, duplicate
+ * filter, sequence table, ack ring and JSON serializer; its publish task
+ * takes PUBLISH_MS per MQTT message.
+ *
+ * Radio model: ducks on a jittered grid with the gateway in the middle,
+ * log-distance path loss with fixed per-link shadowing, and the LoRa
+ * sensitivity and time on air for the chosen SF and bandwidth. A receiver
+ * locks onto the first packet it hears; it is lost if another one overlaps
+ * it less than CAPTURE_DB weaker, if the receiver starts transmitting, or
+ * to random fading. Radios are half duplex. MamaDucks relay every packet
+ * they have not seen before up to MAX_HOPS, as CDP does, optionally after
+ * a random delay; a PapaDedup filter stands in for the CDP bloom filter.
+ *
+ * Reports per scenario: reading delivery, end-to-end latency from sensing
+ * to MQTT for alerts and routine readings, readings published per hour,
+ * channel airtime, flooded duplicates the gateway filtered and any that
+ * reached MQTT, queue overflows, and simulated node-hours per second.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/tools/host -Iducks/mama_duck/mama_duck_v6 -Iducks/common -Iducks/papa_duck \
+ *       ducks/tools/mesh_sim.cpp -o /tmp/mesh_sim
+ *   /tmp/mesh_sim [--ducks N] [--hours H] [--sf 7] [--bw 125] [--spacing m] [--loss p]
+ *                 [--relay-jitter ms] [--hops N] [--seed S] datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ * Without --ducks it sweeps 25 to 200 ducks, with and without relay jitter.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <queue>
+#include <random>
+#include <vector>
+#include "Arduino.h"
+#include "DatasetReader.h"
+#include "DuckConfig.h"
+#include "DuckSensor.h"
+#include "random_forest_10_v3.h"
+#include "DuckReportPolicy.h"
+#include "DuckBatch.h"
+#include "DuckSequence.h"
+#include "DuckSchedule.h"
+#include "PapaConfig.h"
+#include "PapaDedup.h"
+#include "PapaJson.h"
+#include "PapaQueue.h"
+#include "PapaSequence.h"
+
+using DuckConfig::SystemConfig;
+using DuckConfig::ScheduleConfig;
+using DuckConfig::AckConfig;
+using DuckConfig::BatchConfig;
+
+// CDP topic values and framing
+static const uint8_t TOPIC_STATUS = 0x10;
+static const uint8_t TOPIC_ALERT = 0x13;
+static const uint8_t TOPIC_LOCATION = 0x14;
+static const size_t CDP_HEADER = 27;
+
+static const double TX_POWER_DBM = 14.0;
+static const double PATH_LOSS_1M = 40.0;     // dB, 915 MHz
+static const double PATH_EXPONENT = 2.7;
+static const double SHADOWING_DB = 4.0;
+static const double CAPTURE_DB = 6.0;
+static const double PUBLISH_MS = 4.0;        // one MQTT message on the publish task
+static const uint32_t NODE_DEDUP = 256;      // relay filter entries per duck
+static const size_t RECORD_SLOTS = 256;      // well beyond the sequence numbers a window holds
+
+struct Params {
+    size_t ducks = 100;
+    double hours = 2.0;
+    int sf = 7;
+    double bwKHz = 125.0;
+    double spacing = 1500.0;                 // m between grid points
+    double loss = 0.02;                      // random fading per reception
+    double relayJitterMs = 0.0;              // CDP relays at once
+    uint8_t maxHops = 6;
+    uint32_t seed = 1;
+};
+
+static double sensitivityDbm(int sf, double bwKHz) {
+    static const double AT_125[] = {-123.0, -126.0, -129.0, -132.0, -134.5, -137.0};  // SF7..SF12
+    return AT_125[std::min(std::max(sf, 7), 12) - 7] + 10 * log10(bwKHz / 125.0);
+}
+
+// LoRa time on air in microseconds, explicit header, CRC on, CR 4/5
+static uint64_t airtimeUs(size_t bytes, int sf, double bwKHz) {
+    double symbol = (1 << sf) / (bwKHz * 1000.0) * 1e6;
+    int de = (symbol > 16000) ? 1 : 0;
+    double n = 8.0 * bytes - 4.0 * sf + 28 + 16;
+    double payloadSymbols = 8 + std::max(ceil(n / (4.0 * (sf - 2 * de))) * 5, 0.0);
+    return (uint64_t)((8 + 4.25 + payloadSymbols) * symbol);
+}
+
+struct Frame {
+    uint8_t sduid[8];
+    uint8_t dduid[8];
+    bool addressed;
+    uint32_t muid;
+    uint8_t topic;
+    uint8_t hops;
+    uint16_t length;
+    uint32_t origin;                         // packet record, or UINT32_MAX for acks
+    uint8_t data[DuckBatch::MAX_PAYLOAD];
+};
+
+// Readings carried by one window packet, for latency and duplicate checks
+struct PacketRecord {
+    bool urgent;
+    uint32_t published;
+    std::vector<uint64_t> sensedAt;          // us
+};
+
+typedef DuckSequence::Window<AckConfig::WINDOW, DuckBatch::MAX_PAYLOAD - DuckSequence::HEADER_SIZE> SendWindow;
+
+struct Link {
+    uint32_t node;
+    float power;                             // dBm received
+};
+
+struct Radio {
+    std::deque<uint32_t> queue;              // frames waiting to be sent
+    std::vector<Link> neighbors;
+};
+
+// Kept apart from Radio so a transmission touches 12 bytes per neighbour
+struct Receiver {
+    int32_t locked = -1;                     // frame being received
+    float power = 0;
+    bool corrupted = false;
+    bool transmitting = false;
+};
+
+struct Mama {
+    uint8_t id[8];
+    SensorManager sensors;
+    DuckReport::Policy policy;
+    DuckBatch::Encoder batch;
+    uint64_t batchOpenedAt = 0;
+    std::vector<uint64_t> batchSensed;
+    SendWindow window;
+    uint32_t windowRecords[RECORD_SLOTS];    // record per sequence number in flight
+    DuckSchedule::Scheduler schedule;
+    PapaDedup::Filter<NODE_DEDUP> relayed;
+    const std::vector<Sample>* series = nullptr;
+    size_t position = 0;
+    uint32_t counter = 1;
+    uint64_t cycleBegin = 0;
+
+    Mama()
+        : policy({DuckConfig::ReportConfig::TEMP_DEADBAND, DuckConfig::ReportConfig::HUMIDITY_DEADBAND,
+                  DuckConfig::ReportConfig::PRESSURE_DEADBAND, DuckConfig::ReportConfig::GAS_DEADBAND,
+                  DuckConfig::ReportConfig::POSITION_DEADBAND, DuckConfig::ReportConfig::HEARTBEAT_INTERVAL}),
+          batch(DuckBatch::MAX_PAYLOAD - DuckSequence::HEADER_SIZE),
+          window({AckConfig::ACK_TIMEOUT, AckConfig::RESEND_HOLDOFF, AckConfig::MAX_TRANSMISSIONS}),
+          schedule({SystemConfig::BME_READ_INTERVAL, ScheduleConfig::SLOT_LENGTH, ScheduleConfig::MAX_SYNC_AGE,
+                    ScheduleConfig::SENSE_MARGIN, ScheduleConfig::BUSY_FRAMES}) {}
+};
+
+struct Result {
+    uint64_t sensed = 0, suppressed = 0, offered = 0, published = 0, alertsOffered = 0, alertsPublished = 0;
+    uint64_t transmissions = 0, airUs = 0, gatewayFrames = 0, floodDuplicates = 0, resends = 0, duplicatesOut = 0;
+    uint64_t windowFull = 0, radioFull = 0, ringFull = 0, ackRingFull = 0;
+    std::vector<float> alertLatency, routineLatency;
+    double meanHops = 0;
+    uint32_t maxHops = 0, unreachable = 0;
+    double wallSeconds = 0;
+};
+
+class Mesh {
+public:
+    Mesh(const Params& p, const DeviceSeries& data) : p(p), rng(p.seed), mamas(p.ducks), radios(p.ducks + 1),
+                                                  receivers(p.ducks + 1) {
+        HostRandom::seed(p.seed);
+        lossThreshold = (uint32_t)(p.loss * 4294967295.0);
+        for (size_t length = 0; length <= DuckBatch::MAX_PAYLOAD; length++) {
+            airtime.push_back(airtimeUs(CDP_HEADER + length, p.sf, p.bwKHz));
+        }
+        place();
+        size_t i = 0;
+        std::vector<const std::vector<Sample>*> series;
+        for (const auto& device : data) {
+            if (device.second.size() > 1) series.push_back(&device.second);
+        }
+        for (Mama& m : mamas) {
+            char id[sizeof(m.id) + 1];
+            snprintf(id, sizeof(id), "D%07u", (unsigned)i);
+            memcpy(m.id, id, sizeof(m.id));
+            m.series = series[i % series.size()];
+            m.position = rng() % m.series->size();
+            m.window.begin((uint16_t)rng());
+            m.schedule.begin(m.id, sizeof(m.id), rng());
+            m.relayed.begin();
+            // Ducks come up over the first frame
+            at(std::uniform_int_distribution<uint64_t>(0, SystemConfig::BME_READ_INTERVAL * 1000ULL)(rng),
+               CYCLE, (uint32_t)i);
+            i++;
+        }
+        dedup.begin();
+        memcpy(gatewayId, "PAPADUCK", sizeof(gatewayId));
+    }
+
+    Result run() {
+        auto wallStart = std::chrono::steady_clock::now();
+        uint64_t end = (uint64_t)(p.hours * 3600e6);
+        while (!events.empty() && events.top().time < end) {
+            Event e = events.top();
+            events.pop();
+            now = e.time;
+            HostClock::set(now / 1000);
+            switch (e.kind) {
+                case CYCLE: cycle(e.node); break;
+                case SLOT: slot(e.node); break;
+                case TX_START: startTx(e.node); break;
+                case TX_END: endTx(e.node, e.value); break;
+                case RELAY: enqueue(e.node, e.value); break;
+                case PUBLISH: publish(); break;
+            }
+        }
+        r.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+        return r;
+    }
+
+private:
+    enum Kind : uint8_t { CYCLE, SLOT, TX_START, TX_END, RELAY, PUBLISH };
+    struct Event {
+        uint64_t time;
+        uint32_t node;
+        uint32_t value;
+        Kind kind;
+        bool operator>(const Event& o) const { return time > o.time; }
+    };
+
+    Params p;
+    std::mt19937 rng;
+    uint32_t lossThreshold;                   // raw rng() values below this are faded out
+    std::vector<uint64_t> airtime;            // us by payload length
+    std::vector<Mama> mamas;
+    std::vector<Radio> radios;                // mamas, then the gateway
+    std::vector<Receiver> receivers;
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+    std::vector<Frame> frames;
+    std::vector<uint32_t> freeFrames;
+    std::vector<PacketRecord> records;
+    uint64_t now = 0;
+    uint32_t nextMuid = 1;
+    Result r;
+
+    // Gateway
+    uint8_t gatewayId[8];
+    PapaQueue::PacketRing<PapaConfig::TaskConfig::PACKET_SLOTS, sizeof(Frame)> rxRing;
+    PapaQueue::PacketRing<PapaConfig::SequenceConfig::ACK_SLOTS,
+                          PapaConfig::SequenceConfig::ID_SIZE + DuckSequence::ACK_SIZE> ackRing;
+    PapaDedup::Filter<> dedup;
+    PapaSequence::Table<> sequences;
+    char jsonBuffer[1024];
+    bool publishing = false;
+
+    uint32_t gateway() const { return (uint32_t)p.ducks; }
+
+    void at(uint64_t time, Kind kind, uint32_t node, uint32_t value = 0) {
+        events.push(Event{time, node, value, kind});
+    }
+
+    uint32_t allocFrame() {
+        if (freeFrames.empty()) {
+            frames.emplace_back();
+            return (uint32_t)frames.size() - 1;
+        }
+        uint32_t f = freeFrames.back();
+        freeFrames.pop_back();
+        return f;
+    }
+
+    // Grid positions, gateway in the middle, and the links each radio hears
+    void place() {
+        size_t n = p.ducks + 1;
+        size_t side = (size_t)ceil(sqrt((double)n));
+        std::uniform_real_distribution<double> jitter(-p.spacing / 4, p.spacing / 4);
+        std::normal_distribution<double> shadow(0, SHADOWING_DB);
+        std::vector<double> x(n), y(n);
+        size_t centre = (side / 2) * side + side / 2;
+        for (size_t i = 0, cell = 0; i < n; cell++) {
+            if (cell == centre) continue;
+            x[i] = (cell % side) * p.spacing + jitter(rng);
+            y[i] = (cell / side) * p.spacing + jitter(rng);
+            if (++i == p.ducks) break;
+        }
+        x[gateway()] = (centre % side) * p.spacing;
+        y[gateway()] = (centre / side) * p.spacing;
+        double floor = sensitivityDbm(p.sf, p.bwKHz);
+        for (size_t a = 0; a < n; a++) {
+            for (size_t b = a + 1; b < n; b++) {
+                double d = std::max(1.0, hypot(x[a] - x[b], y[a] - y[b]));
+                double power = TX_POWER_DBM - PATH_LOSS_1M - 10 * PATH_EXPONENT * log10(d) + shadow(rng);
+                if (power < floor) continue;
+                radios[a].neighbors.push_back(Link{(uint32_t)b, (float)power});
+                radios[b].neighbors.push_back(Link{(uint32_t)a, (float)power});
+            }
+        }
+        // Hop distances from the gateway
+        std::vector<int> hops(n, -1);
+        std::deque<size_t> q(1, gateway());
+        hops[gateway()] = 0;
+        while (!q.empty()) {
+            size_t a = q.front();
+            q.pop_front();
+            for (const Link& link : radios[a].neighbors) {
+                if (hops[link.node] < 0) {
+                    hops[link.node] = hops[a] + 1;
+                    q.push_back(link.node);
+                }
+            }
+        }
+        uint32_t reached = 0;
+        for (size_t i = 0; i < p.ducks; i++) {
+            if (hops[i] < 0 || hops[i] > p.maxHops + 1) {
+                r.unreachable++;
+                continue;
+            }
+            r.meanHops += hops[i];
+            r.maxHops = std::max(r.maxHops, (uint32_t)hops[i]);
+            reached++;
+        }
+        r.meanHops /= std::max(reached, 1u);
+    }
+
+    // ---- MamaDuck: ML task ----
+
+    void cycle(uint32_t node) {
+        Mama& m = mamas[node];
+        m.cycleBegin = now;
+        const Sample& s = (*m.series)[m.position];
+        m.position = (m.position + 1) % m.series->size();
+
+        SensorData data;
+        data.reset();
+        data.temp = s.reading.temp;
+        data.humidity = s.reading.humidity;
+        data.pressure = s.reading.pressure;
+        data.gas = s.reading.gas;
+        m.sensors.processSensorData(data);
+        float features[] = {data.scaled_temp, data.scaled_humidity, data.scaled_pressure, data.scaled_gas,
+                            data.temp_volatility, data.humidity_volatility, data.pressure_volatility,
+                            data.gas_volatility, data.temp_velocity, data.humidity_velocity,
+                            data.pressure_velocity, data.gas_velocity};
+        Eloquent::ML::Port::RandomForest forest;
+        DuckPayload::Reading reading = s.reading;
+        reading.prediction = forest.predict(features);
+        reading.counter = m.counter++;
+        r.sensed++;
+
+        // The cycle ends on a fresh NMEA sentence, 100 ms after the UTC second
+        uint64_t readyMs = now / 1000 + 300;
+        readyMs = (readyMs + 999) / 1000 * 1000 + 100;
+        m.schedule.sync((uint32_t)((readyMs - 100) % DuckSchedule::DAY_MS), (uint32_t)readyMs);
+        uint64_t ready = readyMs * 1000 + 20000;
+        HostClock::set(ready / 1000);
+
+        uint32_t nowMs = (uint32_t)(ready / 1000);
+        if (DuckConfig::ReportConfig::ENABLED &&
+            m.policy.evaluate(reading, nowMs) == DuckReport::Reason::SUPPRESSED) {
+            r.suppressed++;
+        } else if (reading.prediction == 1) {
+            uint8_t payload[DuckPayload::RECORD_SIZE];
+            size_t length = DuckPayload::encode(reading, payload, sizeof(payload));
+            r.offered++;
+            r.alertsOffered++;
+            queuePacket(node, TOPIC_ALERT, payload, length, true, std::vector<uint64_t>(1, m.cycleBegin));
+            flushBatch(node);
+        } else {
+            r.offered++;
+            batchReading(node, reading, nowMs);
+        }
+        if (m.batch.count() && nowMs - (uint32_t)(m.batchOpenedAt / 1000) >= BatchConfig::MAX_AGE) {
+            flushBatch(node);
+        }
+
+        m.schedule.sensed((uint32_t)(m.cycleBegin / 1000), nowMs);
+        uint32_t delay = m.schedule.senseDelay(nowMs);
+        at(ready + delay * 1000ULL, CYCLE, node);
+        at(ready + m.schedule.timeUntilSlot(nowMs) * 1000ULL, SLOT, node);
+    }
+
+    void batchReading(uint32_t node, const DuckPayload::Reading& reading, uint32_t nowMs) {
+        Mama& m = mamas[node];
+        if (m.batch.count() >= BatchConfig::MAX_READINGS || !m.batch.append(DuckBatch::fromReading(reading, nowMs))) {
+            flushBatch(node);
+            if (m.batch.count() >= BatchConfig::MAX_READINGS ||
+                !m.batch.append(DuckBatch::fromReading(reading, nowMs))) {
+                r.windowFull++;                           // dropRoutine()
+                return;
+            }
+        }
+        if (m.batch.count() == 1) m.batchOpenedAt = now;
+        m.batchSensed.push_back(m.cycleBegin);
+        if (m.batch.count() >= BatchConfig::MAX_READINGS) flushBatch(node);
+    }
+
+    void flushBatch(uint32_t node) {
+        Mama& m = mamas[node];
+        if (!m.batch.count() || !m.window.hasRoom()) return;
+        queuePacket(node, TOPIC_LOCATION, m.batch.data(), m.batch.size(), false, m.batchSensed);
+        m.batch.reset();
+        m.batchSensed.clear();
+    }
+
+    void queuePacket(uint32_t node, uint8_t topic, const uint8_t* data, size_t length, bool urgent,
+                     const std::vector<uint64_t>& sensed) {
+        Mama& m = mamas[node];
+        SendWindow::Slot* s = m.window.add(topic, data, length, urgent);
+        if (!s) {
+            r.windowFull += sensed.size();
+            return;
+        }
+        records.push_back(PacketRecord{urgent, 0, sensed});
+        m.windowRecords[s->sequence % RECORD_SLOTS] = (uint32_t)records.size() - 1;
+    }
+
+    // ---- MamaDuck: TX task ----
+
+    void processAcks(uint32_t node, const DuckSequence::Ack* ack) {
+        Mama& m = mamas[node];
+        uint32_t nowMs = (uint32_t)(now / 1000);
+        uint32_t acked = m.window.counters().acked;
+        uint32_t unacked = m.window.counters().unacked;
+        if (ack) m.window.onAck(*ack, nowMs);
+        m.window.poll(nowMs);
+        if (m.window.counters().unacked != unacked) {
+            m.schedule.outcome(false, nowMs);
+        } else if (m.window.counters().acked != acked) {
+            m.schedule.outcome(true, nowMs);
+        }
+    }
+
+    void slot(uint32_t node) {
+        Mama& m = mamas[node];
+        uint32_t nowMs = (uint32_t)(now / 1000);
+        if (!m.schedule.inSlot(nowMs)) return;           // moved since this was scheduled
+        processAcks(node, nullptr);
+        if (m.batch.count() && nowMs - (uint32_t)(m.batchOpenedAt / 1000) >= BatchConfig::MAX_AGE) {
+            flushBatch(node);
+        }
+        SendWindow::Slot* s;
+        while ((s = m.window.due()) != nullptr) {
+            m.window.sending(s);
+            uint32_t f = allocFrame();
+            Frame& fr = frames[f];
+            memcpy(fr.sduid, m.id, 8);
+            fr.addressed = false;
+            fr.muid = nextMuid++;
+            fr.topic = s->topic;
+            fr.hops = 0;
+            fr.length = s->length;
+            fr.origin = m.windowRecords[s->sequence % RECORD_SLOTS];
+            memcpy(fr.data, s->data, s->length);
+            m.relayed.seen(fr.sduid, 8, (const uint8_t*)&fr.muid, 4, nowMs);
+            if (s->transmissions > 0) r.resends++;
+            m.window.sent(s, nowMs);
+            enqueue(node, f);
+        }
+    }
+
+    // ---- Radio ----
+
+    void enqueue(uint32_t node, uint32_t frame) {
+        Radio& radio = radios[node];
+        if (radio.queue.size() >= 8) {
+            r.radioFull++;
+            freeFrames.push_back(frame);
+            return;
+        }
+        radio.queue.push_back(frame);
+        if (!receivers[node].transmitting && radio.queue.size() == 1) at(now, TX_START, node);
+    }
+
+    void startTx(uint32_t node) {
+        Radio& radio = radios[node];
+        Receiver& self = receivers[node];
+        if (self.transmitting || radio.queue.empty()) return;
+        uint32_t f = radio.queue.front();
+        radio.queue.pop_front();
+        self.transmitting = true;
+        self.locked = -1;                               // a reception in progress is lost
+        uint64_t air = airtime[frames[f].length];
+        r.transmissions++;
+        r.airUs += air;
+        for (const Link& link : radio.neighbors) {
+            Receiver& rx = receivers[link.node];
+            if (rx.transmitting) continue;
+            if (rx.locked < 0) {
+                rx.locked = (int32_t)f;
+                rx.power = link.power;
+                rx.corrupted = false;
+            } else if (link.power > rx.power - CAPTURE_DB) {
+                rx.corrupted = true;
+            }
+        }
+        at(now + air, TX_END, node, f);
+    }
+
+    void endTx(uint32_t node, uint32_t f) {
+        Radio& radio = radios[node];
+        receivers[node].transmitting = false;
+        for (const Link& link : radio.neighbors) {
+            Receiver& rx = receivers[link.node];
+            if (rx.locked != (int32_t)f) continue;
+            rx.locked = -1;
+            if (!rx.corrupted && rng() >= lossThreshold) receive(link.node, frames[f]);
+        }
+        freeFrames.push_back(f);
+        if (!radio.queue.empty()) at(now + 1000, TX_START, node);  // turnaround
+    }
+
+    void receive(uint32_t node, const Frame& frame) {
+        if (node == gateway()) {
+            r.gatewayFrames++;
+            if (!rxRing.push((const uint8_t*)&frame, sizeof(frame))) {
+                r.ringFull++;
+                return;
+            }
+            if (!publishing) {
+                publishing = true;
+                at(now, PUBLISH, node);
+            }
+            return;
+        }
+        Mama& m = mamas[node];
+        uint32_t nowMs = (uint32_t)(now / 1000);
+        m.schedule.heard(nowMs);
+        if (frame.addressed && memcmp(frame.dduid, m.id, 8) == 0) {
+            DuckSequence::Ack ack;
+            if (DuckSequence::decodeAck(frame.data, frame.length, ack)) processAcks(node, &ack);
+            return;
+        }
+        // CDP relay: once per message, up to the hop limit
+        if (m.relayed.seen(frame.sduid, 8, (const uint8_t*)&frame.muid, 4, nowMs) || frame.hops >= p.maxHops) {
+            return;
+        }
+        uint32_t f = allocFrame();
+        frames[f] = frame;
+        frames[f].hops++;
+        if (p.relayJitterMs > 0) {
+            at(now + rng() % (uint64_t)(p.relayJitterMs * 1000), RELAY, node, f);
+        } else {
+            enqueue(node, f);
+        }
+    }
+
+    // ---- PapaDuck: publish task running forwardPacket() ----
+
+    void publish() {
+        const auto* slot = rxRing.front();
+        if (!slot) {
+            publishing = false;
+            return;
+        }
+        Frame frame;
+        memcpy(&frame, slot->data, sizeof(frame));
+        rxRing.pop();
+        double cost = forward(frame);
+        at(now + (uint64_t)(cost * 1000) + 1, PUBLISH, gateway());
+    }
+
+    // Returns the publish task time spent in ms
+    double forward(const Frame& frame) {
+        uint32_t nowMs = (uint32_t)(now / 1000);
+        DuckSequence::Ack ack;
+        if (DuckSequence::decodeAck(frame.data, frame.length, ack)) return 0;          // own ack relayed back
+        if (dedup.seen(frame.sduid, 8, (const uint8_t*)&frame.muid, 4, nowMs)) {
+            r.floodDuplicates++;
+            return 0;
+        }
+        const uint8_t* data = frame.data;
+        size_t size = frame.length;
+        uint16_t sequence = 0;
+        if (DuckSequence::unwrap(data, size, sequence)) {
+            bool fresh = sequences.receive(frame.sduid, 8, sequence, nowMs, ack);
+            uint8_t slot[PapaConfig::SequenceConfig::ID_SIZE + DuckSequence::ACK_SIZE];
+            memcpy(slot, frame.sduid, 8);
+            DuckSequence::encodeAck(ack, slot + 8, DuckSequence::ACK_SIZE);
+            if (!ackRing.push(slot, sizeof(slot))) r.ackRingFull++;
+            sendAcks();
+            if (!fresh) return 0;
+        }
+
+        // quackJson(): one MQTT message per reading
+        PapaJson::Message message = PapaJson::message();
+        message.deviceId = PapaJson::span(frame.sduid, 8);
+        message.messageId = PapaJson::span((const uint8_t*)&frame.muid, 4);
+        message.hops = frame.hops;
+        message.sequence = sequence;
+        size_t messages = 0;
+        char text[DuckPayload::TEXT_SIZE];
+        DuckPayload::Reading reading;
+        if (DuckBatch::isBatch(data, size)) {
+            DuckBatch::Decoder decoder(data, size);
+            DuckBatch::Entry entry;
+            while (decoder.next(entry)) {
+                DuckBatch::toReading(entry, reading);
+                DuckPayload::toText(reading, text, sizeof(text));
+                message.payload = PapaJson::span((const uint8_t*)text, strnlen(text, sizeof(text)));
+                message.readingIndex = (int)messages;
+                PapaJson::serialize(message, jsonBuffer, sizeof(jsonBuffer));
+                messages++;
+            }
+        } else if (DuckPayload::decode(data, size, reading)) {
+            DuckPayload::toText(reading, text, sizeof(text));
+            message.payload = PapaJson::span((const uint8_t*)text, strnlen(text, sizeof(text)));
+            PapaJson::serialize(message, jsonBuffer, sizeof(jsonBuffer));
+            messages = 1;
+        }
+
+        double cost = messages * PUBLISH_MS;
+        if (frame.origin != UINT32_MAX) {
+            PacketRecord& record = records[frame.origin];
+            if (record.published++) {
+                r.duplicatesOut += messages;
+            } else {
+                uint64_t out = now + (uint64_t)(cost * 1000);
+                for (uint64_t sensed : record.sensedAt) {
+                    (record.urgent ? r.alertLatency : r.routineLatency).push_back((out - sensed) / 1e6f);
+                }
+                r.published += record.sensedAt.size();
+                if (record.urgent) r.alertsPublished++;
+            }
+        }
+        return cost;
+    }
+
+    // Radio task: sendAcks()
+    void sendAcks() {
+        const auto* slot = ackRing.front();
+        while (slot) {
+            uint32_t f = allocFrame();
+            Frame& fr = frames[f];
+            memcpy(fr.sduid, gatewayId, 8);
+            memcpy(fr.dduid, slot->data, 8);
+            fr.addressed = true;
+            fr.muid = nextMuid++;
+            fr.topic = TOPIC_STATUS;
+            fr.hops = 0;
+            fr.length = DuckSequence::ACK_SIZE;
+            fr.origin = UINT32_MAX;
+            memcpy(fr.data, slot->data + 8, DuckSequence::ACK_SIZE);
+            ackRing.pop();
+            enqueue(gateway(), f);
+            slot = ackRing.front();
+        }
+    }
+};
+
+static float percentile(std::vector<float>& v, double q) {
+    if (v.empty()) return 0;
+    size_t k = std::min(v.size() - 1, (size_t)(q * v.size()));
+    std::nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+static void printHeader() {
+    printf("%5s %6s %5s %9s %25s %25s %9s %7s %8s %6s %18s %8s\n", "ducks", "jitter", "hops", "delivered",
+           "alert p50/p95/p99/max s", "routine p50/p95/p99/max s", "readings/h", "duty %", "dup rx %", "dup out",
+           "overflow win/rad/gw", "node-h/s");
+}
+
+static void printResult(const Params& p, Result& r) {
+    double delivered = r.offered ? 100.0 * r.published / r.offered : 0;
+    float a[4] = {percentile(r.alertLatency, 0.5), percentile(r.alertLatency, 0.95),
+                  percentile(r.alertLatency, 0.99), percentile(r.alertLatency, 1.0)};
+    float b[4] = {percentile(r.routineLatency, 0.5), percentile(r.routineLatency, 0.95),
+                  percentile(r.routineLatency, 0.99), percentile(r.routineLatency, 1.0)};
+    char alert[32], routine[32], overflow[32];
+    if (r.alertLatency.empty()) {
+        snprintf(alert, sizeof(alert), "-");
+    } else {
+        snprintf(alert, sizeof(alert), "%.1f/%.1f/%.1f/%.0f", a[0], a[1], a[2], a[3]);
+    }
+    snprintf(routine, sizeof(routine), "%.0f/%.0f/%.0f/%.0f", b[0], b[1], b[2], b[3]);
+    snprintf(overflow, sizeof(overflow), "%llu/%llu/%llu", (unsigned long long)r.windowFull,
+             (unsigned long long)r.radioFull, (unsigned long long)(r.ringFull + r.ackRingFull));
+    printf("%5u %4.0fms %2.1f/%u %8.2f%% %25s %25s %9.0f %6.1f%% %7.1f%% %6llu %18s %8.0f\n", (unsigned)p.ducks,
+           p.relayJitterMs, r.meanHops, r.maxHops, delivered, alert, routine, r.published / p.hours,
+           100.0 * r.airUs / (p.hours * 3600e6) / (p.ducks + 1), r.gatewayFrames ? 100.0 * r.floodDuplicates / r.gatewayFrames : 0,
+           (unsigned long long)r.duplicatesOut, overflow, p.ducks * p.hours / std::max(r.wallSeconds, 1e-9));
+}
+
+int main(int argc, char** argv) {
+    Params base;
+    bool sweep = true;
+    int first = 1;
+    for (; first + 1 < argc && strncmp(argv[first], "--", 2) == 0; first += 2) {
+        const char* key = argv[first] + 2;
+        double value = atof(argv[first + 1]);
+        if (!strcmp(key, "ducks")) { base.ducks = (size_t)value; sweep = false; }
+        else if (!strcmp(key, "hours")) base.hours = value;
+        else if (!strcmp(key, "sf")) base.sf = (int)value;
+        else if (!strcmp(key, "bw")) base.bwKHz = value;
+        else if (!strcmp(key, "spacing")) base.spacing = value;
+        else if (!strcmp(key, "loss")) base.loss = value;
+        else if (!strcmp(key, "relay-jitter")) base.relayJitterMs = value;
+        else if (!strcmp(key, "hops")) base.maxHops = (uint8_t)value;
+        else if (!strcmp(key, "seed")) base.seed = (uint32_t)value;
+        else {
+            fprintf(stderr, "unknown option --%s\n", key);
+            return 1;
+        }
+    }
+    if (first >= argc) {
+        fprintf(stderr, "usage: %s [--ducks N] [--hours H] [--sf 7] [--bw 125] [--spacing m] [--loss p] "
+                        "[--relay-jitter ms] [--hops N] [--seed S] <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    DeviceSeries data = loadDatasets(argc - first, argv + first);
+    if (data.empty()) {
+        fprintf(stderr, "no telemetry rows in the given files\n");
+        return 1;
+    }
+
+    printf("SF%d/%.0f kHz, %.0f m grid, %.0f%% fading loss, %u hop limit, %.1f h per run, %u byte reading on air %.0f ms\n",
+           base.sf, base.bwKHz, base.spacing, base.loss * 100, (unsigned)base.maxHops, base.hours,
+           (unsigned)(CDP_HEADER + DuckSequence::HEADER_SIZE + DuckPayload::RECORD_SIZE),
+           airtimeUs(CDP_HEADER + DuckSequence::HEADER_SIZE + DuckPayload::RECORD_SIZE, base.sf, base.bwKHz) / 1000.0);
+    printHeader();
+    std::vector<Params> runs;
+    if (sweep) {
+        for (double jitter : {0.0, 200.0}) {
+            for (size_t n : {25, 50, 100, 200}) {
+                Params p = base;
+                p.ducks = n;
+                p.relayJitterMs = jitter;
+                runs.push_back(p);
+            }
+        }
+    } else {
+        runs.push_back(base);
+    }
+    for (const Params& p : runs) {
+        Mesh mesh(p, data);
+        Result r = mesh.run();
+        printResult(p, r);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file policy_bench.cpp
+ * @brief Host replay of the report-by-exception policy on recorded traffic
+ *
+ * Runs every reading of the gateway exports in datasets/ through
+ * DuckReport::Policy with the MamaDuck thresholds and reports how many
+ * packets would still be sent, and why.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/common ducks/tools/policy_bench.cpp -o /tmp/policy_bench
+ *   /tmp/policy_bench datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include "DuckPayload.h"
+#include "DuckReportPolicy.h"
+#include "DatasetReader.h"
+
+// Keep in sync with DuckConfig::ReportConfig in mama_duck_v6
+static const DuckReport::Thresholds MAMA_THRESHOLDS = {
+    1.0f, 5.0f, 100.0f, 0.10f, 0.0005, 600000
+};
+
+struct Result {
+    size_t readings = 0;
+    size_t counts[(size_t)DuckReport::Reason::COUNT] = {};
+};
+
+static void replay(const DeviceSeries& devices, const DuckReport::Thresholds& t, Result& result) {
+    for (const auto& device : devices) {
+        DuckReport::Policy policy(t);
+        for (const Sample& s : device.second) {
+            result.counts[(size_t)policy.evaluate(s.reading, (uint32_t)s.timeMs)]++;
+            result.readings++;
+        }
+    }
+}
+
+static void report(const char* label, const Result& r) {
+    size_t sent = r.readings - r.counts[(size_t)DuckReport::Reason::SUPPRESSED];
+    printf("%-34s %6zu readings  %5zu sent (%5.1f%%, %5.1fx fewer)  "
+           "prediction %5zu  deadband %5zu  heartbeat %4zu\n",
+           label, r.readings, sent, 100.0 * sent / r.readings, (double)r.readings / sent,
+           r.counts[(size_t)DuckReport::Reason::PREDICTION],
+           r.counts[(size_t)DuckReport::Reason::DEADBAND],
+           r.counts[(size_t)DuckReport::Reason::HEARTBEAT]);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    DeviceSeries devices = loadDatasets(argc - 1, argv + 1);
+
+    Result recorded;
+    replay(devices, MAMA_THRESHOLDS, recorded);
+    report("recorded predictions", recorded);
+
+    // The recorded predictions flip often on these no-fire days; replay
+    // with the prediction held at 0 to isolate the deadband and heartbeat
+    DeviceSeries quiet = devices;
+    for (auto& device : quiet) {
+        for (Sample& s : device.second) s.reading.prediction = 0;
+    }
+    Result quietResult;
+    replay(quiet, MAMA_THRESHOLDS, quietResult);
+    report("predictions held at 0", quietResult);
+
+    static const float SCALES[] = {0.5f, 2.0f};
+    for (float scale : SCALES) {
+        DuckReport::Thresholds t = MAMA_THRESHOLDS;
+        t.temp *= scale;
+        t.humidity *= scale;
+        t.pressure *= scale;
+        t.gasFraction *= scale;
+        Result r;
+        replay(quiet, t, r);
+        char label[64];
+        snprintf(label, sizeof(label), "predictions held at 0, bands x%.1f", scale);
+        report(label, r);
+    }
+    return 0;
+}
@@ -0,0 +1,345 @@
+/**
+ * @file priority_sim.cpp
+ * @brief Host simulation of MamaDuck alert queueing delay
+ *
+ * Drives the real SensorRecordPool, DuckErrorHandler retry scheduler and
+ * DuckBatcher from mama_duck_v6 on a virtual clock. The dispatch functions
+ * below mirror packetTransmissionLoop. Each send costs the LoRa airtime of
+ * the packet and fails with a configurable probability. The workload and
+ * channel draw from their own seeded generators, so every discipline sees
+ * the same readings and alerts. Disciplines compared:
+ *   v5 blocking   mama_duck_v5: 5-deep transmitQueue, each reading retried
+ *                 in place with a blocking 1 s delay, 100 ms task delay
+ *   fifo          one lane and one retry class for every reading (the
+ *                 non-blocking scheduler before priority lanes, no batching)
+ *   lanes         alert lane, alert retry budget, reserved retry slot
+ *   lanes+batch   as above, routine readings coalesced into DuckBatch packets
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/tools/host -Iducks/mama_duck/mama_duck_v6 -Iducks/common \
+ *       ducks/tools/priority_sim.cpp -o /tmp/priority_sim
+ *   /tmp/priority_sim
+ */
+
+#include <deque>
+#include <random>
+#include <vector>
+#include "Arduino.h"
+#include "DuckConfig.h"
+#include "DuckError.h"
+#include "DuckPool.h"
+#include "DuckBatcher.h"
+
+enum class Discipline { V5_BLOCKING, FIFO, LANES, LANES_BATCH };
+
+struct Scenario {
+    const char* name;
+    uint32_t readingInterval;  // ms between readings
+    double alertProbability;   // per reading
+    double sendFailure;        // per attempt
+    uint32_t duration;         // ms
+};
+
+static const size_t CDP_HEADER_SIZE = 27;
+static const uint32_t MAX_ALERT_DELAY = 300000;
+static const uint32_t PROMPT_DELIVERY = 5000;  // "delivered promptly" threshold, ms
+static const size_t V5_QUEUE_DEPTH = 5;
+
+// LoRa time on air in ms: SF7, BW125, CR4/5, 8 symbol preamble, explicit header, CRC
+static double airtimeMs(size_t payloadBytes) {
+    const double sf = 7, bw = 125000, cr = 1;
+    double symbol = pow(2, sf) / bw * 1000;
+    double payloadSymbols = 8 + std::max(ceil((8.0 * payloadBytes - 4 * sf + 28 + 16) / (4 * sf)) * (cr + 4), 0.0);
+    return (8 + 4.25) * symbol + payloadSymbols * symbol;
+}
+
+// Simulation state shared with the firmware callbacks
+static SensorRecordPool recordPool;
+static Discipline discipline;
+static double sendFailure;
+static uint64_t nextReadingAt;
+static uint32_t readingInterval;
+static double alertProbability;
+static uint64_t endAt;
+static std::mt19937 workloadRng;
+static std::mt19937 channelRng;
+static std::deque<SensorData*> v5Queue;
+
+struct Stats {
+    uint32_t alerts = 0;
+    uint32_t alertsDelivered = 0;
+    uint32_t alertsLost = 0;
+    uint32_t alertsPrompt = 0;
+    uint32_t routine = 0;
+    uint32_t routineDelivered = 0;
+    uint32_t routineLost = 0;
+    uint32_t poolFull = 0;
+    uint32_t packets = 0;
+    double airtime = 0;
+    std::vector<uint32_t> alertQueueing;  // publish -> first attempt
+    std::vector<uint32_t> alertDelivery;  // publish -> successful send
+};
+static Stats stats;
+
+static double uniform(std::mt19937& rng) { return rng() / 4294967296.0; }
+
+static void onRecordTransmitted(void* context, bool success);
+
+// The ML task, run whenever the virtual clock passes a reading time
+static void publishDue() {
+    while (nextReadingAt <= HostClock::nowMs() && nextReadingAt < endAt) {
+        SensorData* record = recordPool.acquire();
+        uint64_t at = nextReadingAt;
+        nextReadingAt += readingInterval;
+        bool alert = uniform(workloadRng) < alertProbability;
+        if (!record) {
+            stats.poolFull++;
+            if (alert) { stats.alerts++; stats.alertsLost++; } else { stats.routine++; stats.routineLost++; }
+            continue;
+        }
+        record->prediction = alert ? 1 : 0;
+        record->queuedAt = (uint32_t)at;
+        record->temp = 20 + uniform(workloadRng);
+        record->humidity = 30 + uniform(workloadRng);
+        record->pressure = 96000 + 10 * uniform(workloadRng);
+        record->gas = 100000 + 100 * uniform(workloadRng);
+        if (alert) stats.alerts++; else stats.routine++;
+        if (discipline == Discipline::V5_BLOCKING) {
+            // xQueueSend on a full transmitQueue fails and the reading is lost
+            if (v5Queue.size() >= V5_QUEUE_DEPTH) {
+                onRecordTransmitted(record, false);
+            } else {
+                v5Queue.push_back(record);
+            }
+            continue;
+        }
+        bool alertLane = alert && discipline != Discipline::FIFO;
+        recordPool.publish(record, alertLane ? Lane::ALERT : Lane::ROUTINE);
+    }
+}
+
+// Radio send: occupies the channel for the packet's airtime; the ML task
+// keeps publishing meanwhile
+static bool sendPacket(size_t length) {
+    double ms = airtimeMs(CDP_HEADER_SIZE + length);
+    stats.packets++;
+    stats.airtime += ms;
+    HostClock::advance((uint64_t)ceil(ms));
+    publishDue();
+    return uniform(channelRng) >= sendFailure;
+}
+
+static uint32_t ageOf(const SensorData* record) {
+    return (uint32_t)(millis() - record->queuedAt);
+}
+
+static bool transmitRecord(void* context) {
+    SensorData* record = static_cast<SensorData*>(context);
+    if (record->prediction == 1 && record->timestamp == 0) {
+        // First attempt of an alert: record its queueing delay
+        stats.alertQueueing.push_back(ageOf(record));
+        record->timestamp = 1;
+    }
+    return sendPacket(DuckPayload::RECORD_SIZE);
+}
+
+static void onRecordTransmitted(void* context, bool success) {
+    SensorData* record = static_cast<SensorData*>(context);
+    if (record->prediction == 1) {
+        if (success) {
+            stats.alertsDelivered++;
+            stats.alertDelivery.push_back(ageOf(record));
+            if (ageOf(record) <= PROMPT_DELIVERY) stats.alertsPrompt++;
+        } else {
+            stats.alertsLost++;
+        }
+    } else {
+        if (success) stats.routineDelivered++; else stats.routineLost++;
+    }
+    recordPool.release(record);
+}
+
+static bool transmitBatch(void*) {
+    return sendPacket(DuckBatcher::length());
+}
+
+static void onBatchTransmitted(void*, bool success) {
+    if (success) stats.routineDelivered += DuckBatcher::count();
+    else stats.routineLost += DuckBatcher::count();
+    DuckBatcher::complete();
+}
+
+static void flushBatch() {
+    if (!DuckErrorHandler::routineSlotAvailable() || !DuckBatcher::seal()) {
+        return;
+    }
+    if (!DuckErrorHandler::retryAsync("Send Batch", transmitBatch, nullptr, onBatchTransmitted)) {
+        onBatchTransmitted(nullptr, false);
+    }
+}
+
+static void batchRecord(SensorData* record) {
+    DuckPayload::Reading reading = {};
+    reading.temp = record->temp;
+    reading.humidity = record->humidity;
+    reading.pressure = record->pressure;
+    reading.gas = record->gas;
+    uint32_t now = millis();
+    if (!DuckBatcher::add(reading, now)) {
+        flushBatch();
+        if (!DuckBatcher::add(reading, now)) {
+            stats.routineLost++;
+            recordPool.release(record);
+            return;
+        }
+    }
+    // Counted as delivered when its batch is sent
+    recordPool.release(record);
+    if (DuckBatcher::flushDue(now)) {
+        flushBatch();
+    }
+}
+
+static void dispatchAlerts() {
+    SensorData* record;
+    bool dispatched = false;
+    while ((record = recordPool.receive(Lane::ALERT)) != nullptr) {
+        if (!DuckErrorHandler::retryAsync("Send Alert", transmitRecord, record, onRecordTransmitted,
+                                          DuckConfig::SystemConfig::ALERT_MAX_RETRY_COUNT,
+                                          RetryPriority::ALERT)) {
+            onRecordTransmitted(record, false);
+        }
+        dispatched = true;
+    }
+    if (dispatched && discipline == Discipline::LANES_BATCH) {
+        flushBatch();
+    }
+}
+
+static void dispatchRoutine(SensorData* record) {
+    if (discipline == Discipline::FIFO) {
+        // Previous behaviour: every reading is equal, all four slots shared
+        if (!DuckErrorHandler::retryAsync("Send Data", transmitRecord, record, onRecordTransmitted,
+                                          DuckConfig::SystemConfig::MAX_RETRY_COUNT,
+                                          RetryPriority::ALERT)) {
+            onRecordTransmitted(record, false);
+        }
+    } else if (discipline == Discipline::LANES_BATCH && record->prediction != 1) {
+        batchRecord(record);
+    } else if (!DuckErrorHandler::retryAsync("Send Data", transmitRecord, record, onRecordTransmitted)) {
+        stats.routineLost++;
+        recordPool.release(record);
+    }
+}
+
+// One iteration of the v5 packetTransmissionLoop: sendData() retried in
+// place with a blocking delay, then a 100 ms task delay
+static void v5TransmissionPass() {
+    if (!v5Queue.empty()) {
+        SensorData* record = v5Queue.front();
+        v5Queue.pop_front();
+        bool sent = false;
+        for (uint8_t attempt = 0; attempt < DuckConfig::SystemConfig::MAX_RETRY_COUNT && !sent; attempt++) {
+            if (attempt > 0) {
+                HostClock::advance(DuckConfig::SystemConfig::TRANSMISSION_RETRY_DELAY);
+                publishDue();
+            }
+            sent = transmitRecord(record);
+        }
+        onRecordTransmitted(record, sent);
+    }
+    HostClock::advance(100);
+    publishDue();
+}
+
+// One iteration of packetTransmissionLoop
+static void transmissionPass() {
+    if (discipline == Discipline::V5_BLOCKING) {
+        v5TransmissionPass();
+        return;
+    }
+    dispatchAlerts();
+    DuckErrorHandler::processRetries();
+    SensorData* record;
+    while ((record = recordPool.receive(Lane::ROUTINE)) != nullptr) {
+        dispatchRoutine(record);
+        dispatchAlerts();
+    }
+    if (DuckBatcher::flushDue(millis())) {
+        flushBatch();
+    }
+}
+
+static uint32_t percentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, (size_t)(p / 100.0 * v.size()))];
+}
+
+static void run(const Scenario& s, Discipline d, const char* label) {
+    // Fresh firmware state for every run
+    new (&recordPool) SensorRecordPool();
+    recordPool.begin();
+    while (DuckErrorHandler::pendingRetryCount()) {
+        HostClock::advance(DuckConfig::SystemConfig::MAX_RETRY_BACKOFF);
+        DuckErrorHandler::processRetries();
+    }
+    while (DuckBatcher::seal()) DuckBatcher::complete();
+    DuckBatcher::complete();
+    v5Queue.clear();
+    stats = Stats();
+    HostRandom::seed(12345);
+    workloadRng.seed(1);
+    channelRng.seed(2);
+    HostClock::set(1000);
+
+    discipline = d;
+    sendFailure = s.sendFailure;
+    readingInterval = s.readingInterval;
+    alertProbability = s.alertProbability;
+    nextReadingAt = HostClock::nowMs();
+    endAt = HostClock::nowMs() + s.duration;
+
+    // Event loop: wake on a new reading, a due retry or an aging batch
+    while (HostClock::nowMs() < endAt + MAX_ALERT_DELAY) {
+        publishDue();
+        transmissionPass();
+        uint64_t wake = nextReadingAt < endAt ? nextReadingAt : endAt + MAX_ALERT_DELAY;
+        uint32_t retryDelay = DuckErrorHandler::nextRetryDelay();
+        if (retryDelay != UINT32_MAX) wake = std::min<uint64_t>(wake, HostClock::nowMs() + std::max<uint32_t>(retryDelay, 1));
+        uint32_t batchDelay = DuckBatcher::timeUntilDue(millis());
+        if (batchDelay != UINT32_MAX && d == Discipline::LANES_BATCH) {
+            wake = std::min<uint64_t>(wake, HostClock::nowMs() + std::max<uint32_t>(batchDelay, 1));
+        }
+        if (d == Discipline::V5_BLOCKING && !v5Queue.empty()) continue;
+        if (wake > HostClock::nowMs()) HostClock::set(wake);
+    }
+    // Anything still open in a batch at the end is not counted as lost
+    printf("  %-12s alerts %4u: delivered %5.1f%% (%5.1f%% within 5 s), queueing p50 %5u p95 %6u max %6u ms, "
+           "delivery p50 %5u p95 %6u ms | routine delivered %5.1f%% | airtime %4.1f%%\n",
+           label, stats.alerts, 100.0 * stats.alertsDelivered / std::max<uint32_t>(stats.alerts, 1),
+           100.0 * stats.alertsPrompt / std::max<uint32_t>(stats.alerts, 1),
+           percentile(stats.alertQueueing, 50), percentile(stats.alertQueueing, 95),
+           percentile(stats.alertQueueing, 100),
+           percentile(stats.alertDelivery, 50), percentile(stats.alertDelivery, 95),
+           100.0 * stats.routineDelivered / std::max<uint32_t>(stats.routine, 1),
+           100.0 * stats.airtime / s.duration);
+}
+
+int main() {
+    static const Scenario SCENARIOS[] = {
+        {"10 s readings, clean channel",        10000, 0.05, 0.0, 24 * 3600000u},
+        {"10 s readings, 30% send failures",    10000, 0.05, 0.3, 24 * 3600000u},
+        {"10 s readings, 60% send failures",    10000, 0.05, 0.6, 24 * 3600000u},
+        {"2 s readings, 60% send failures",      2000, 0.05, 0.6, 6 * 3600000u},
+        {"0.5 s readings, 30% send failures",     500, 0.05, 0.3, 2 * 3600000u},
+    };
+    for (const Scenario& s : SCENARIOS) {
+        printf("%s\n", s.name);
+        run(s, Discipline::V5_BLOCKING, "v5 blocking");
+        run(s, Discipline::FIFO, "fifo");
+        run(s, Discipline::LANES, "lanes");
+        run(s, Discipline::LANES_BATCH, "lanes+batch");
+    }
+    return 0;
+}
@@ -0,0 +1,266 @@
+/**
+ * @file publish_sim.cpp
+ * @brief Host check and comparison of the PapaDuck MQTT publish policies
+ *
+ * Turns the readings in the gateway exports in datasets/ into the JSON
+ * messages quackJson forwards. Fire predictions go to evt/alert as urgent,
+ * the rest to evt/gps. The messages are fed through PapaPublish::Publisher
+ * on a virtual clock. The sink is a broker stand-in in the role of a local
+ * Mosquitto: it parses the MQTT byte stream, unpacks JSON arrays and checks
+ * that every message arrives once and in order per topic. TLS cost is
+ * modelled as AES-GCM records: 29 bytes of overhead per record of at most
+ * 16 KB, one or more records per transport write.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/common -Iducks/papa_duck ducks/tools/publish_sim.cpp -o /tmp/publish_sim
+ *   /tmp/publish_sim datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include "DuckPayload.h"
+#include "PapaJson.h"
+#include "PapaPublish.h"
+#include "DatasetReader.h"
+
+static const char* GPS_TOPIC = "owl/device/owl-papa-duck-01/evt/gps";
+static const char* ALERT_TOPIC = "owl/device/owl-papa-duck-01/evt/alert";
+static const size_t TLS_RECORD_OVERHEAD = 29;  // 5 header + 8 nonce + 16 tag
+static const size_t TLS_RECORD_MAX = 16384;
+
+struct Message {
+    std::string json;
+    bool alert;
+};
+
+static uint32_t now = 0;
+
+// Parses PUBLISH frames like a broker would and records what arrives
+class BrokerStandIn : public PapaPublish::Sink {
+public:
+    std::vector<uint8_t> stream;
+    std::map<std::string, std::vector<std::pair<std::string, uint32_t>>> received;
+    size_t frames = 0, arrays = 0, writes = 0, tlsRecords = 0, tlsBytes = 0, malformed = 0;
+    bool keep = true;  // false measures throughput without the bookkeeping
+
+    size_t write(const uint8_t* data, size_t length) override {
+        writes++;
+        size_t records = (length + TLS_RECORD_MAX - 1) / TLS_RECORD_MAX;
+        tlsRecords += records;
+        tlsBytes += length + records * TLS_RECORD_OVERHEAD;
+        stream.insert(stream.end(), data, data + length);
+        parse();
+        return length;
+    }
+
+private:
+    void parse() {
+        size_t pos = 0;
+        while (pos + 2 <= stream.size()) {
+            if (stream[pos] != 0x30) {
+                malformed++;
+                stream.clear();
+                return;
+            }
+            size_t remaining = 0, multiplier = 1, i = pos + 1;
+            while (i < stream.size()) {
+                remaining += (stream[i] & 0x7F) * multiplier;
+                multiplier *= 128;
+                if (!(stream[i++] & 0x80)) break;
+            }
+            if (i + remaining > stream.size()) break;
+            size_t topicLength = (stream[i] << 8) | stream[i + 1];
+            std::string topic((const char*)&stream[i + 2], topicLength);
+            std::string payload((const char*)&stream[i + 2 + topicLength], remaining - 2 - topicLength);
+            frames++;
+            if (keep) deliver(topic, payload);
+            pos = i + remaining;
+        }
+        stream.erase(stream.begin(), stream.begin() + pos);
+    }
+
+    // Splits a JSON array of objects at top-level commas
+    void deliver(const std::string& topic, const std::string& payload) {
+        if (payload.empty() || payload[0] != '[') {
+            received[topic].push_back(std::make_pair(payload, now));
+            return;
+        }
+        arrays++;
+        int depth = 0;
+        bool quoted = false;
+        size_t start = 1;
+        for (size_t i = 1; i < payload.size(); i++) {
+            char c = payload[i];
+            if (quoted) {
+                if (c == '\\') i++;
+                else if (c == '"') quoted = false;
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == '{') {
+                depth++;
+            } else if (c == '}') {
+                depth--;
+            } else if (depth == 0 && (c == ',' || c == ']')) {
+                received[topic].push_back(std::make_pair(payload.substr(start, i - start), now));
+                start = i + 1;
+            }
+        }
+    }
+};
+
+static std::vector<Message> buildMessages(const DeviceSeries& devices) {
+    std::vector<Message> messages;
+    char jsonBuffer[PapaJson::BUFFER_SIZE];
+    uint32_t n = 0;
+    for (const auto& device : devices) {
+        std::string id = device.first.substr(device.first.rfind(':') + 1);
+        for (const Sample& s : device.second) {
+            char text[DuckPayload::TEXT_SIZE];
+            int length = DuckPayload::toText(s.reading, text, sizeof(text));
+            char muid[5];
+            snprintf(muid, sizeof(muid), "%04X", n++ & 0xFFFF);
+            std::string path = id + "MAMA0002";
+            PapaJson::Message m = PapaJson::message();
+            m.deviceId = PapaJson::span((const uint8_t*)id.data(), id.size());
+            m.messageId = PapaJson::span((const uint8_t*)muid, 4);
+            m.path = PapaJson::span((const uint8_t*)path.data(), path.size());
+            m.payload = PapaJson::span((const uint8_t*)text, length > 0 ? strnlen(text, sizeof(text)) : 0);
+            m.hops = 2;
+            m.duckType = 2;
+            size_t size = PapaJson::serialize(m, jsonBuffer, sizeof(jsonBuffer));
+            Message message = {std::string(jsonBuffer, size), s.reading.prediction == 1};
+            messages.push_back(message);
+        }
+    }
+    return messages;
+}
+
+struct Result {
+    size_t messages = 0, frames = 0, arrays = 0, writes = 0, tlsRecords = 0, tlsBytes = 0;
+    size_t lost = 0, reordered = 0;
+    uint32_t gpsP95 = 0, alertP95 = 0;
+    double hostMessagesPerSecond = 0;
+};
+
+static uint32_t percentile(std::vector<uint32_t> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[(size_t)(p * (v.size() - 1))];
+}
+
+// Replays the messages arriving burst at a time every intervalMs, polling
+// the publisher every 10 ms like loop() does
+static void run(const std::vector<Message>& messages, size_t burst, uint32_t intervalMs,
+                const PapaPublish::Policy& policy, BrokerStandIn& broker,
+                std::vector<uint32_t>& sentAt) {
+    static PapaPublish::Publisher publisher;  // 13 KB, keep it off the stack
+    publisher = PapaPublish::Publisher(&broker, policy);
+    now = 0;
+    sentAt.clear();
+    size_t next = 0;
+    uint32_t nextArrival = 0;
+    while (next < messages.size() || publisher.pending()) {
+        while (next < messages.size() && nextArrival <= now) {
+            for (size_t i = 0; i < burst && next < messages.size(); i++, next++) {
+                const Message& m = messages[next];
+                sentAt.push_back(now);
+                publisher.publish(m.alert ? ALERT_TOPIC : GPS_TOPIC, m.json.data(), m.json.size(), now, m.alert);
+            }
+            nextArrival += intervalMs;
+        }
+        publisher.poll(now);
+        now += 10;
+    }
+}
+
+static Result evaluate(const std::vector<Message>& messages, size_t burst, uint32_t intervalMs,
+                       const PapaPublish::Policy& policy) {
+    Result r;
+    BrokerStandIn broker;
+    std::vector<uint32_t> sentAt;
+    run(messages, burst, intervalMs, policy, broker, sentAt);
+
+    // Check delivery per topic, in order, and collect latencies
+    std::map<std::string, size_t> cursor;
+    std::vector<uint32_t> gpsLatency, alertLatency;
+    for (size_t i = 0; i < messages.size(); i++) {
+        const char* topic = messages[i].alert ? ALERT_TOPIC : GPS_TOPIC;
+        auto& got = broker.received[topic];
+        size_t& c = cursor[topic];
+        if (c >= got.size()) {
+            r.lost++;
+            continue;
+        }
+        if (got[c].first != messages[i].json) r.reordered++;
+        uint32_t latency = got[c].second - sentAt[i];
+        (messages[i].alert ? alertLatency : gpsLatency).push_back(latency);
+        c++;
+    }
+    r.messages = messages.size();
+    r.frames = broker.frames;
+    r.arrays = broker.arrays;
+    r.writes = broker.writes;
+    r.tlsRecords = broker.tlsRecords;
+    r.tlsBytes = broker.tlsBytes;
+    r.lost += broker.malformed;
+    r.gpsP95 = percentile(gpsLatency, 0.95);
+    r.alertP95 = percentile(alertLatency, 0.95);
+
+    // Publisher and framing throughput alone, in host wall time
+    BrokerStandIn sink;
+    sink.keep = false;
+    auto start = std::chrono::steady_clock::now();
+    run(messages, burst, intervalMs, policy, sink, sentAt);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    r.hostMessagesPerSecond = messages.size() / elapsed;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    std::vector<Message> messages = buildMessages(loadDatasets(argc - 1, argv + 1));
+    size_t alerts = 0, jsonBytes = 0;
+    for (const Message& m : messages) {
+        alerts += m.alert;
+        jsonBytes += m.json.size();
+    }
+    printf("%zu messages, %zu alerts\n", messages.size(), alerts);
+
+    struct Named {
+        const char* label;
+        PapaPublish::Policy policy;
+    };
+    static const Named POLICIES[] = {
+        {"one write per message", {false, 0, 1, 0}},
+        {"pipelined 50 ms", {false, 0, 1, 50}},
+        {"arrays 2 s + pipelined", {true, 2000, 32, 50}},
+    };
+    static const struct { const char* label; size_t burst; uint32_t interval; } SCENARIOS[] = {
+        {"live, 20 nodes every 10 s", 1, 500},
+        {"live, 20 nodes batching 12 readings", 12, 6000},
+        {"backlog drain, 50/s", 50, 1000},
+    };
+
+    int failures = 0;
+    for (const auto& s : SCENARIOS) {
+        printf("%s\n", s.label);
+        for (const Named& p : POLICIES) {
+            Result r = evaluate(messages, s.burst, s.interval, p.policy);
+            printf("  %-24s frames %6zu (arrays %5zu) writes %6zu  TLS %7.1f KB, %5.1f B/msg over the JSON"
+                   "  p95 gps %5u ms alert %4u ms  host %8.0f msg/s  lost %zu reordered %zu\n",
+                   p.label, r.frames, r.arrays, r.writes, r.tlsBytes / 1024.0,
+                   (double)(r.tlsBytes - jsonBytes) / r.messages,
+                   r.gpsP95, r.alertP95, r.hostMessagesPerSecond, r.lost, r.reordered);
+            failures += r.lost || r.reordered;
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,235 @@
+/**
+ * @file queue_bench.cpp
+ * @brief Host benchmark of the PapaDuck radio/publish task split
+ *
+ * Part 1 runs PapaQueue::PacketRing between two real threads, producer
+ * and consumer on separate cores like the radio and publish tasks, and
+ * checks every packet arrives once, intact and in order. Both sides yield
+ * when they find the ring full or empty, so the figure is meaningful on a
+ * single core host too.
+ *
+ * Part 2 replays LoRa bursts on a virtual 1 ms clock against two gateway
+ * models:
+ *   single task  duck.run() and the publish path share loop(); while a
+ *                packet is being published or a TLS write is stalled the
+ *                radio holds one more packet, the next overwrites it
+ *   two tasks    the radio task copies each packet into the ring within a
+ *                millisecond and the publish task empties it on its own
+ * Publish costs: 2 ms per packet for parsing and JSON, a 5 ms TLS write of
+ * the pipeline every 50 ms, and one stalled write of the given length at
+ * the start of the burst (TCP retransmit or a full send window). Packets
+ * arrive back to back at LoRa airtime spacing.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -pthread -Iducks/papa_duck ducks/tools/queue_bench.cpp -o /tmp/queue_bench
+ *   /tmp/queue_bench
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include "PapaConfig.h"
+#include "PapaQueue.h"
+
+using PapaConfig::TaskConfig;
+typedef PapaQueue::PacketRing<TaskConfig::PACKET_SLOTS, TaskConfig::PACKET_SIZE> Ring;
+
+// ---- Part 1: threaded throughput and integrity ----
+
+static void threaded(uint32_t packets) {
+    static Ring ring;
+    uint32_t corrupt = 0, reordered = 0, received = 0;
+    uint32_t fullSpins = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread consumer([&]() {
+        uint32_t expected = 0;
+        while (expected < packets) {
+            const Ring::Slot* slot = ring.front();
+            if (!slot) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint32_t seq;
+            memcpy(&seq, slot->data, sizeof(seq));
+            if (seq != expected) reordered++;
+            size_t length = 40 + seq % 200;
+            if (slot->length != length) {
+                corrupt++;
+            } else {
+                for (size_t i = sizeof(seq); i < length; i++) {
+                    if (slot->data[i] != (uint8_t)(seq + i)) {
+                        corrupt++;
+                        break;
+                    }
+                }
+            }
+            ring.pop();
+            received++;
+            expected = seq + 1;
+        }
+    });
+
+    uint8_t packet[256];
+    for (uint32_t seq = 0; seq < packets; seq++) {
+        size_t length = 40 + seq % 200;
+        memcpy(packet, &seq, sizeof(seq));
+        for (size_t i = sizeof(seq); i < length; i++) packet[i] = (uint8_t)(seq + i);
+        while (!ring.push(packet, length)) {
+            fullSpins++;
+            std::this_thread::yield();
+        }
+    }
+    consumer.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const PapaQueue::Stats& s = ring.counters();
+    printf("threaded: %u packets in %.2f s, %.2f M packets/s, received %u, corrupt %u, reordered %u,"
+           " producer found it full %u times, high water %u/%u\n",
+           (unsigned)packets, elapsed, packets / elapsed / 1e6, (unsigned)received, (unsigned)corrupt,
+           (unsigned)reordered, (unsigned)fullSpins, (unsigned)s.highWater, (unsigned)Ring::capacity());
+}
+
+// ---- Part 2: burst simulation ----
+
+static const uint32_t PER_PACKET = 2;
+static const uint32_t WRITE_COST = 5;
+static const uint32_t FLUSH_INTERVAL = 50;
+
+struct Burst {
+    uint32_t packets;
+    uint32_t spacing;  // ms between arrivals
+    uint32_t stall;    // ms of the first TLS write in the burst
+};
+
+struct Result {
+    uint32_t delivered, radioLost, ringOverflows;
+    uint32_t lastDelivery;
+};
+
+// Publish side shared by both models: returns the ms the next step takes
+struct Publish {
+    const Burst& burst;
+    uint32_t pipelined = 0, lastFlush = 0;
+    bool stalled = false;
+
+    explicit Publish(const Burst& b) : burst(b) {}
+
+    uint32_t packet() {
+        pipelined++;
+        return PER_PACKET;
+    }
+
+    // Pipeline write due at time t, with its cost
+    uint32_t poll(uint32_t t, uint32_t& flushed) {
+        flushed = 0;
+        if (!pipelined || t - lastFlush < FLUSH_INTERVAL) return 0;
+        lastFlush = t;
+        flushed = pipelined;
+        pipelined = 0;
+        if (!stalled) {
+            stalled = true;
+            return WRITE_COST + burst.stall;
+        }
+        return WRITE_COST;
+    }
+};
+
+static Result singleTask(const Burst& burst) {
+    Result r = {};
+    Publish publish(burst);
+    uint32_t next = 0, arrivedAt = 0;
+    bool holding = false;
+    uint32_t t = 0;
+    // Packets arriving while loop() is busy until 'until'
+    auto air = [&](uint32_t until) {
+        while (next < burst.packets && (arrivedAt = next * burst.spacing) <= until) {
+            if (holding) r.radioLost++;
+            holding = true;
+            next++;
+        }
+    };
+    while (next < burst.packets || holding || publish.pipelined) {
+        air(t);
+        if (holding) {
+            holding = false;
+            t += publish.packet();
+            air(t);
+        }
+        uint32_t flushed;
+        uint32_t cost = publish.poll(t, flushed);
+        t += cost;
+        air(t);
+        if (flushed) {
+            r.delivered += flushed;
+            r.lastDelivery = t;
+        }
+        t++;
+    }
+    return r;
+}
+
+static Result twoTasks(const Burst& burst) {
+    Result r = {};
+    static Ring ring;  // 16 KB, keep it off the stack; every run leaves it empty
+    uint32_t overflows = ring.counters().overflows;
+    Publish publish(burst);
+    uint8_t packet[64] = {0};
+    uint32_t next = 0, busyUntil = 0;
+    for (uint32_t t = 0; next < burst.packets || ring.size() || publish.pipelined; t++) {
+        // Radio task: read and copy within the millisecond
+        while (next < burst.packets && next * burst.spacing <= t) {
+            ring.push(packet, sizeof(packet));
+            next++;
+        }
+        // Publish task on the other core
+        if (t < busyUntil) continue;
+        if (ring.front()) {
+            ring.pop();
+            busyUntil = t + publish.packet();
+            continue;
+        }
+        uint32_t flushed;
+        uint32_t cost = publish.poll(t, flushed);
+        if (flushed) {
+            r.delivered += flushed;
+            r.lastDelivery = t + cost;
+        }
+        busyUntil = t + cost;
+    }
+    r.ringOverflows = ring.counters().overflows - overflows;
+    return r;
+}
+
+static void report(const char* label, const Burst& b, const Result& r) {
+    double seconds = r.lastDelivery / 1000.0;
+    printf("    %-12s delivered %4u/%-4u  lost %4u (radio %u, ring %u)  drop rate %5.1f%%  sustained %5.1f packets/s\n",
+           label, (unsigned)r.delivered, (unsigned)b.packets, (unsigned)(r.radioLost + r.ringOverflows),
+           (unsigned)r.radioLost, (unsigned)r.ringOverflows,
+           100.0 * (r.radioLost + r.ringOverflows) / b.packets, seconds > 0 ? r.delivered / seconds : 0);
+}
+
+int main() {
+    threaded(2000000);
+
+    static const uint32_t SIZES[] = {16, 64, 256};
+    static const uint32_t SPACINGS[] = {60, 25};   // SF7 BW125 ~60 ms frame; 25 ms for several channels
+    static const uint32_t STALLS[] = {0, 500, 2000};
+    int failures = 0;
+    for (uint32_t spacing : SPACINGS) {
+        for (uint32_t stall : STALLS) {
+            printf("bursts every %u ms, first TLS write stalls %u ms\n", (unsigned)spacing, (unsigned)stall);
+            for (uint32_t size : SIZES) {
+                Burst b = {size, spacing, stall};
+                printf("  %u packets\n", (unsigned)size);
+                Result before = singleTask(b);
+                Result after = twoTasks(b);
+                report("single task", b, before);
+                report("two tasks", b, after);
+                failures += after.delivered + after.ringOverflows != b.packets;
+            }
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+/**
+ * @file slot_sim.cpp
+ * @brief Host simulation of LoRa collisions between MamaDucks with and without TX slots
+ *
+ * N MamaDucks in range of each other run the sensing loop for an hour on
+ * one channel. Every duck powers up within 200 ms of the others, as after
+ * a site-wide power cut, and its clock is off by up to 20 ppm. Two timing
+ * schemes are compared:
+ *   interval   the sensing loop sleeps BME_READ_INTERVAL after each cycle
+ *              and the reading is sent as soon as it is ready
+ *   slots      the real DuckSchedule::Scheduler with the firmware settings:
+ *              the cycle is started to finish just before the duck's slot
+ * each with a GPS fix (NMEA sentences arrive 100-140 ms after the UTC
+ * second; the slotted loop waits for a fresh one) and without (the GPS
+ * read runs into its 5 s timeout). A duck learns whether a packet got
+ * through from the next ack about a frame later, and every duck hears the
+ * packets of the others that did not collide. Two loads:
+ * every reading sent on its own (a fire, or batching off) and one batch
+ * per 12 readings. Airtime is SF7, 125 kHz, CR 4/5 for a CDP frame with
+ * the sequence header; packets that overlap in time are both lost, and
+ * another 5% are lost to the mesh. Resends are not modelled.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/tools/host -Iducks/mama_duck/mama_duck_v6 -Iducks/common \
+ *       ducks/tools/slot_sim.cpp -o /tmp/slot_sim
+ *   /tmp/slot_sim
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <random>
+#include <vector>
+#include "DuckConfig.h"
+#include "DuckSchedule.h"
+
+using DuckConfig::SystemConfig;
+using DuckConfig::ScheduleConfig;
+
+static const double HOUR = 3600000.0;
+static const double BOOT_SPREAD = 200.0;
+static const double MAX_PPM = 20.0;
+static const double NMEA_DELAY = 100.0;         // first position sentence after the UTC second
+static const double NMEA_SPREAD = 40.0;         // module and task scheduling differences
+static const double MESH_LOSS = 0.05;
+static const size_t SINGLE_FRAME = 27 + 3 + 51; // CDP header, sequence header, one reading
+static const size_t BATCH_FRAME = 27 + 3 + 137; // twelve readings
+
+// LoRa time on air in ms, explicit header, CRC on, 8 symbol preamble
+static double airtime(size_t bytes, int sf = 7, double bwHz = 125000.0, int cr = 1) {
+    double symbol = (1 << sf) / bwHz * 1000.0;
+    int de = sf >= 11 ? 1 : 0;
+    double n = 8.0 * bytes - 4.0 * sf + 28 + 16;
+    double payloadSymbols = 8 + std::max(ceil(n / (4.0 * (sf - 2 * de))) * (cr + 4), 0.0);
+    return (8 + 4.25 + payloadSymbols) * symbol;
+}
+
+struct Tx {
+    double start, end;
+    size_t node;
+};
+
+struct Node {
+    double boot, ppm, nmeaDelay, processing;
+    DuckSchedule::Scheduler schedule;
+    std::mt19937 rng;
+    uint32_t cycles = 0, late = 0, minGap = UINT32_MAX;
+    double lastWake = -1;
+    double radioFree = 0;   // packets from one duck go out back to back
+
+    Node() : schedule({SystemConfig::BME_READ_INTERVAL, ScheduleConfig::SLOT_LENGTH,
+                       ScheduleConfig::MAX_SYNC_AGE, ScheduleConfig::SENSE_MARGIN,
+                       ScheduleConfig::BUSY_FRAMES}) {}
+
+    uint32_t local(double t) const { return (uint32_t)((t - boot) * (1 + ppm * 1e-6)); }
+    double global(uint32_t ms) const { return boot + ms / (1 + ppm * 1e-6); }
+};
+
+enum class Load { EVERY_READING, BATCHED };
+
+struct Result {
+    uint32_t packets = 0, collided = 0, reselections = 0, late = 0, cycles = 0, minGap = UINT32_MAX;
+};
+
+static Result run(size_t n, bool slots, bool fix, Load load, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> u(0, 1);
+    std::vector<Node> nodes(n);
+    for (size_t i = 0; i < n; i++) {
+        Node& d = nodes[i];
+        d.boot = u(rng) * BOOT_SPREAD;
+        d.ppm = (2 * u(rng) - 1) * MAX_PPM;
+        d.nmeaDelay = NMEA_DELAY + u(rng) * NMEA_SPREAD;
+        d.processing = 280 + 40 * u(rng);
+        d.rng.seed(seed * 1000 + i);
+        uint8_t id[8] = {'D', 'U', 'C', 'K', (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i, 0};
+        d.schedule.begin(id, sizeof(id), d.rng());
+    }
+
+    // Events: sensing cycle starts, packets ending, and acks showing
+    // whether a packet got through
+    typedef std::pair<double, std::pair<int, size_t> > Event;     // time, (kind, index)
+    std::priority_queue<Event, std::vector<Event>, std::greater<Event> > events;
+    enum { WAKE = 0, HEAR = 1, CHECK = 2 };
+    for (size_t i = 0; i < n; i++) {
+        events.push(Event(nodes[i].boot + 3000, std::make_pair((int)WAKE, i)));  // setup() takes ~3 s
+    }
+    std::vector<Tx> sent;
+    std::vector<uint8_t> meshLost;
+    std::multimap<double, size_t> byStart;
+    const double frameAir = airtime(load == Load::BATCHED ? BATCH_FRAME : SINGLE_FRAME);
+    Result r;
+
+    auto collided = [&](size_t index) {
+        const Tx& tx = sent[index];
+        for (auto it = byStart.lower_bound(tx.start - frameAir); it != byStart.end() && it->first < tx.end; ++it) {
+            if (it->second != index && tx.start < sent[it->second].end) return true;
+        }
+        return false;
+    };
+
+    while (!events.empty() && events.top().first < HOUR) {
+        double t = events.top().first;
+        int kind = events.top().second.first;
+        size_t index = events.top().second.second;
+        events.pop();
+
+        if (kind == HEAR) {
+            if (!collided(index)) {
+                for (size_t i = 0; i < n; i++) {
+                    if (i != sent[index].node) nodes[i].schedule.heard(nodes[i].local(t));
+                }
+            }
+            continue;
+        }
+        if (kind == CHECK) {
+            Node& d = nodes[sent[index].node];
+            d.schedule.outcome(!meshLost[index] && !collided(index), d.local(t));
+            continue;
+        }
+
+        Node& d = nodes[index];
+        std::uniform_real_distribution<double> jitter(-10, 10);
+        if (d.lastWake >= 0) d.minGap = std::min(d.minGap, (uint32_t)(t - d.lastWake));
+        d.lastWake = t;
+        double ready = t + d.processing + jitter(d.rng);
+        if (!fix) {
+            ready += SystemConfig::GPS_TIMEOUT;
+        } else if (slots) {
+            // Wait for the first sentence after the UART was flushed
+            double second = ceil((ready - d.nmeaDelay) / 1000.0) * 1000.0;
+            ready = second + d.nmeaDelay;
+            d.schedule.sync((uint32_t)fmod(second, (double)DuckSchedule::DAY_MS), d.local(ready));
+        }
+        ready += 20;  // prediction and hand-over
+        d.cycles++;
+
+        double txAt = ready;
+        uint32_t next;
+        if (slots) {
+            d.schedule.sensed(d.local(t), d.local(ready));
+            txAt = d.global(d.local(ready) + d.schedule.timeUntilSlot(d.local(ready)));
+            next = d.schedule.senseDelay(d.local(ready));
+        } else {
+            next = SystemConfig::BME_READ_INTERVAL;
+        }
+        events.push(Event(d.global(d.local(ready) + next), std::make_pair((int)WAKE, index)));
+
+        if (load == Load::BATCHED && d.rng() % DuckConfig::BatchConfig::MAX_READINGS != 0) continue;
+        txAt = std::max(txAt, d.radioFree);
+        d.radioFree = txAt + frameAir;
+        sent.push_back(Tx{txAt, txAt + frameAir, index});
+        meshLost.push_back(u(rng) < MESH_LOSS);
+        byStart.insert(std::make_pair(txAt, sent.size() - 1));
+        if (slots) {
+            events.push(Event(txAt + frameAir, std::make_pair((int)HEAR, sent.size() - 1)));
+            events.push(Event(txAt + SystemConfig::BME_READ_INTERVAL, std::make_pair((int)CHECK, sent.size() - 1)));
+        }
+    }
+
+    r.packets = sent.size();
+    for (size_t i = 0; i < sent.size(); i++) r.collided += collided(i);
+    for (const Node& d : nodes) {
+        r.reselections += d.schedule.counters().reselections;
+        r.late += d.schedule.counters().late;
+        r.cycles += d.cycles;
+        r.minGap = std::min(r.minGap, d.minGap);
+    }
+    return r;
+}
+
+int main() {
+    static const size_t SIZES[] = {10, 25, 50, 100, 200};
+    static const struct { const char* name; bool slots; bool fix; } SCHEMES[] = {
+        {"interval, no fix", false, false},
+        {"interval, fix", false, true},
+        {"slots, no fix", true, false},
+        {"slots, fix", true, true},
+    };
+    static const struct { const char* name; Load load; size_t bytes; } LOADS[] = {
+        {"every reading", Load::EVERY_READING, SINGLE_FRAME},
+        {"batched", Load::BATCHED, BATCH_FRAME},
+    };
+
+    printf("frame %u ms, %u ms slots (%u per frame), all ducks booted within %.0f ms, 1 hour\n",
+           (unsigned)SystemConfig::BME_READ_INTERVAL, (unsigned)ScheduleConfig::SLOT_LENGTH,
+           (unsigned)(SystemConfig::BME_READ_INTERVAL / ScheduleConfig::SLOT_LENGTH), BOOT_SPREAD);
+    for (const auto& l : LOADS) {
+        printf("\n%s: %u byte frames, %.0f ms on air; share of packets collided\n", l.name, (unsigned)l.bytes,
+               airtime(l.bytes));
+        printf("%5s", "ducks");
+        for (const auto& s : SCHEMES) printf("  %17s", s.name);
+        printf("  %s\n", "slot changes/duck/h, late cycles, min cycle gap (slots, fix)");
+        for (size_t n : SIZES) {
+            printf("%5u", (unsigned)n);
+            Result last;
+            for (const auto& s : SCHEMES) {
+                last = run(n, s.slots, s.fix, l.load, 42 + (uint32_t)n);
+                printf("  %16.1f%%", 100.0 * last.collided / std::max(last.packets, 1u));
+            }
+            printf("  %.1f, %.2f%%, %u ms\n", (double)last.reselections / n, 100.0 * last.late / last.cycles,
+                   last.minGap);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file store_sim.cpp
+ * @brief Host checks and sizing for the PapaDuck store-and-forward log
+ *
+ * Runs PapaStore::RingLog on a file-backed NOR flash emulator. It checks
+ * persistence of the backlog and read cursor across reboots, torn writes,
+ * CRC corruption and ring overwrite. It then fills the partition sizes
+ * from partitions_duckstore_*.csv to report how many days of mesh traffic
+ * they hold and how long a full backlog takes to drain.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/papa_duck -Iducks/tools/host ducks/tools/store_sim.cpp -o /tmp/store_sim
+ *   /tmp/store_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "PapaStore.h"
+#include "PapaConfig.h"
+#include "FileFlash.h"
+
+static const size_t SECTOR = 4096;
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    printf("  %-58s %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+// Fake CDP packet; the first four bytes carry the id so order can be checked
+static size_t makePacket(uint32_t id, size_t length, uint8_t* out) {
+    for (size_t i = 0; i < length; i++) out[i] = (uint8_t)(id * 31 + i);
+    memcpy(out, &id, 4);
+    return length;
+}
+
+static uint32_t packetId(const uint8_t* data) {
+    uint32_t id;
+    memcpy(&id, data, 4);
+    return id;
+}
+
+static bool samePacket(uint32_t id, const uint8_t* data, size_t length) {
+    uint8_t expected[PapaStore::MAX_RECORD];
+    makePacket(id, length, expected);
+    return memcmp(expected, data, length) == 0;
+}
+
+struct TempImage {
+    char path[64];
+    TempImage() {
+        snprintf(path, sizeof(path), "/tmp/duckstore-%d-XXXXXX", (int)getpid());
+        int fd = mkstemp(path);
+        if (fd >= 0) close(fd);
+        unlink(path);
+    }
+    ~TempImage() { unlink(path); }
+};
+
+// Drains everything, returning the number of records that were in order
+static uint32_t drainAll(PapaStore::RingLog& log, uint32_t firstId, size_t length, bool& inOrder) {
+    uint8_t buffer[PapaStore::MAX_RECORD];
+    size_t got;
+    uint32_t expected = firstId, count = 0;
+    inOrder = true;
+    while (log.peek(buffer, sizeof(buffer), got)) {
+        if (got != length || packetId(buffer) != expected || !samePacket(expected, buffer, got)) {
+            inOrder = false;
+        }
+        expected = packetId(buffer) + 1;
+        log.consume();
+        count++;
+    }
+    return count;
+}
+
+static void testCrc() {
+    printf("crc32\n");
+    const char* text = "123456789";
+    check(PapaStore::crc32((const uint8_t*)text, 9) == 0xCBF43926, "check value of \"123456789\"");
+}
+
+static void testReboot() {
+    printf("reboot persistence\n");
+    TempImage image;
+    uint8_t packet[PapaStore::MAX_RECORD];
+    {
+        FileFlash flash(image.path, 16 * SECTOR, SECTOR);
+        PapaStore::RingLog log;
+        check(log.begin(flash), "formats a blank region");
+        for (uint32_t id = 0; id < 300; id++) {
+            log.append(packet, makePacket(id, 120, packet));
+        }
+        check(log.pending() == 300, "300 records pending before reboot");
+    }
+    {
+        FileFlash flash(image.path, 16 * SECTOR, SECTOR);
+        PapaStore::RingLog log;
+        log.begin(flash);
+        check(log.pending() == 300, "300 records pending after reboot");
+        uint8_t buffer[PapaStore::MAX_RECORD];
+        size_t got;
+        bool inOrder = true;
+        for (uint32_t id = 0; id < 100 && log.peek(buffer, sizeof(buffer), got); id++) {
+            if (packetId(buffer) != id || !samePacket(id, buffer, got)) inOrder = false;
+            log.consume();
+        }
+        check(inOrder && log.pending() == 200, "drains 100 oldest first");
+    }
+    {
+        FileFlash flash(image.path, 16 * SECTOR, SECTOR);
+        PapaStore::RingLog log;
+        log.begin(flash);
+        check(log.pending() == 200, "read cursor survives a reboot");
+        for (uint32_t id = 300; id < 310; id++) {
+            log.append(packet, makePacket(id, 120, packet));
+        }
+        bool inOrder;
+        check(drainAll(log, 100, 120, inOrder) == 210 && inOrder, "appends after reboot follow the old backlog");
+        check(log.pending() == 0, "backlog empty");
+    }
+}
+
+static void testTornWrite() {
+    printf("power cut during append\n");
+    TempImage image;
+    uint8_t packet[PapaStore::MAX_RECORD];
+    {
+        FileFlash flash(image.path, 8 * SECTOR, SECTOR);
+        PapaStore::RingLog log;
+        log.begin(flash);
+        for (uint32_t id = 0; id < 20; id++) {
+            log.append(packet, makePacket(id, 100, packet));
+        }
+        flash.cutPowerAfter(40);  // header and part of the data
+        check(!log.append(packet, makePacket(20, 100, packet)), "torn append reports failure");
+    }
+    {
+        FileFlash flash(image.path, 8 * SECTOR, SECTOR);
+        PapaStore::RingLog log;
+        log.begin(flash);
+        for (uint32_t id = 21; id < 25; id++) {
+            log.append(packet, makePacket(id, 100, packet));
+        }
+        uint8_t buffer[PapaStore::MAX_RECORD];
+        size_t got;
+        uint32_t count = 0, last = 0;
+        bool intact = true;
+        while (log.peek(buffer, sizeof(buffer), got)) {
+            last = packetId(buffer);
+            if (!samePacket(last, buffer, got)) intact = false;
+            log.consume();
+            count++;
+        }
+        check(count == 24 && last == 24 && intact, "keeps the 24 whole records after reboot");
+        check(log.counters().corrupt == 1, "torn record counted as corrupt");
+    }
+}
+
+static void testCorruption() {
+    printf("bit rot\n");
+    TempImage image;
+    uint8_t packet[PapaStore::MAX_RECORD];
+    FileFlash flash(image.path, 8 * SECTOR, SECTOR);
+    PapaStore::RingLog log;
+    log.begin(flash);
+    for (uint32_t id = 0; id < 10; id++) {
+        log.append(packet, makePacket(id, 64, packet));
+    }
+    // Clear a bit in the data of the fourth record
+    size_t offset = PapaStore::SECTOR_HEADER_SIZE + 3 * PapaStore::recordSize(64) + PapaStore::RECORD_HEADER_SIZE + 10;
+    uint8_t byte;
+    flash.read(offset, &byte, 1);
+    byte &= byte - 1;  // clear the lowest set bit
+    flash.write(offset, &byte, 1);
+
+    uint8_t buffer[PapaStore::MAX_RECORD];
+    size_t got;
+    uint32_t count = 0;
+    bool skipped = true;
+    while (log.peek(buffer, sizeof(buffer), got)) {
+        if (packetId(buffer) == 3) skipped = false;
+        log.consume();
+        count++;
+    }
+    check(count == 9 && skipped, "skips the damaged record, forwards the other 9");
+    check(log.counters().corrupt == 1 && log.pending() == 0, "counts it as corrupt");
+}
+
+static void testOverwrite() {
+    printf("ring overwrite\n");
+    TempImage image;
+    uint8_t packet[PapaStore::MAX_RECORD];
+    FileFlash flash(image.path, 8 * SECTOR, SECTOR);
+    PapaStore::RingLog log;
+    log.begin(flash);
+    const uint32_t total = 2000;
+    for (uint32_t id = 0; id < total; id++) {
+        log.append(packet, makePacket(id, 80, packet));
+    }
+    const PapaStore::Stats& s = log.counters();
+    check(s.dropped > 0 && s.dropped + log.pending() == total, "oldest records dropped, nothing else lost");
+    bool inOrder;
+    uint32_t first = s.dropped;
+    uint32_t drained = drainAll(log, first, 80, inOrder);
+    check(inOrder && drained + s.dropped == total, "remaining backlog is the newest, in order");
+
+    // Keep cycling with a reader and check erases are spread evenly
+    for (uint32_t id = total; id < total + 20000; id++) {
+        log.append(packet, makePacket(id, 80, packet));
+        uint8_t buffer[PapaStore::MAX_RECORD];
+        size_t got;
+        if (id % 2 && log.peek(buffer, sizeof(buffer), got)) log.consume();
+        if (id % 2 && log.peek(buffer, sizeof(buffer), got)) log.consume();
+    }
+    uint32_t lo = flash.sectorErases[0], hi = lo;
+    for (uint32_t e : flash.sectorErases) {
+        lo = e < lo ? e : lo;
+        hi = e > hi ? e : hi;
+    }
+    printf("  sector erases after 22000 appends: min %u max %u\n", lo, hi);
+    check(hi - lo <= 2, "wear is level across sectors");
+}
+
+struct Traffic {
+    const char* label;
+    size_t packetBytes;       // CDP header + payload
+    double packetsPerDay;     // per MamaDuck
+    uint8_t messagesPerPacket;
+};
+
+static void sizing() {
+    // Per node: one reading every 10 s (BME_READ_INTERVAL). Sizes and the
+    // report-by-exception ratio are from batch_bench and policy_bench on
+    // the datasets/ exports.
+    static const Traffic TRAFFIC[] = {
+        {"v5 text, every reading", 27 + 106, 8640, 1},
+        {"v6 binary record, report-by-exception", 27 + 24, 8640 / 3.5, 1},
+        {"v6 batch of 12", 137, 720, 12},
+    };
+    static const struct { const char* label; size_t bytes; } PARTITIONS[] = {
+        {"4MB layout 1.375 MB", 0x160000},
+        {"8MB layout 4.875 MB", 0x4E0000},
+    };
+    static const unsigned NODES = 10;
+    const double messagesPerSecond = PapaConfig::StoreConfig::DRAIN_MESSAGES * 1000.0 /
+                                     PapaConfig::StoreConfig::DRAIN_INTERVAL;
+
+    printf("sizing, %u MamaDucks, drain at %.0f MQTT messages/s\n", NODES, messagesPerSecond);
+    uint8_t packet[PapaStore::MAX_RECORD];
+    for (const auto& p : PARTITIONS) {
+        for (const Traffic& t : TRAFFIC) {
+            TempImage image;
+            FileFlash flash(image.path, p.bytes, SECTOR);
+            PapaStore::RingLog log;
+            log.begin(flash);
+            uint32_t id = 0;
+            while (log.counters().dropped == 0) {
+                log.append(packet, makePacket(id++, t.packetBytes, packet));
+            }
+            uint32_t held = log.pending();
+            {
+                FileFlash reopened(image.path, p.bytes, SECTOR);
+                PapaStore::RingLog recovered;
+                recovered.begin(reopened);
+                printf("  %-20s %-40s %6u packets  %5.1f days  drain %5.1f min  boot scan %u reads\n",
+                       p.label, t.label, held, held / (t.packetsPerDay * NODES),
+                       held * t.messagesPerPacket / messagesPerSecond / 60.0, (unsigned)reopened.reads);
+            }
+        }
+    }
+}
+
+int main() {
+    testCrc();
+    testReboot();
+    testTornWrite();
+    testCorruption();
+    testOverwrite();
+    sizing();
+    printf("%s\n", failures ? "FAILED" : "all checks passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file summary_sim.cpp
+ * @brief Host check of the PapaDuck per-device summaries against the raw rows
+ *
+ * Replays the readings in the gateway exports in datasets/ through
+ * PapaSummary::Table on their recorded timestamps, flushing every
+ * SummaryConfig::INTERVAL like the publish task. Each summary is checked
+ * against min/max/mean/count computed directly from the rows it covers,
+ * and the bytes and messages a long-range query would fetch are compared
+ * with the raw forwarded JSON.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/common -Iducks/papa_duck ducks/tools/summary_sim.cpp -o /tmp/summary_sim
+ *   /tmp/summary_sim datasets/Mar13th.csv datasets/Data_NoFire_Apr3.csv ...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "DuckPayload.h"
+#include "PapaJson.h"
+#include "PapaSummary.h"
+#include "DatasetReader.h"
+
+struct Row {
+    uint64_t timeMs;
+    std::string id;
+    DuckPayload::Reading reading;
+    size_t rawJson;
+};
+
+struct Expected {
+    unsigned readings = 0, fire = 0;
+    double min = 1e30, max = -1e30, sum = 0;
+};
+
+// Pulls "Temp":[min,max,mean,last] and the counts back out of a summary
+static bool parseSummary(const char* json, std::string& id, unsigned& readings, unsigned& fire,
+                         double temp[4]) {
+    const char* p = strstr(json, "\"DeviceID\":\"");
+    const char* r = strstr(json, "\"Readings\":");
+    const char* f = strstr(json, "\"Fire\":");
+    const char* t = strstr(json, "\"Temp\":[");
+    if (!p || !r || !f || !t) return false;
+    // Device IDs in the exports carry control bytes, written as \u00XX
+    id.clear();
+    for (p += 12; *p && *p != '"'; p++) {
+        if (p[0] == '\\' && p[1] == 'u') {
+            id += (char)strtoul(std::string(p + 2, 4).c_str(), NULL, 16);
+            p += 5;
+        } else {
+            id += *p;
+        }
+    }
+    readings = strtoul(r + 11, NULL, 10);
+    fire = strtoul(f + 7, NULL, 10);
+    return sscanf(t + 8, "%lf,%lf,%lf,%lf", &temp[0], &temp[1], &temp[2], &temp[3]) == 4;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <gateway export.csv>...\n", argv[0]);
+        return 1;
+    }
+    DeviceSeries devices = loadDatasets(argc - 1, argv + 1);
+
+    // One timeline per file, devices interleaved by time, with the size of
+    // the JSON quackJson forwards for each row
+    std::map<std::string, std::vector<Row>> files;
+    char jsonBuffer[PapaJson::BUFFER_SIZE];
+    for (const auto& device : devices) {
+        std::string file = device.first.substr(0, device.first.rfind(':'));
+        std::string id = device.first.substr(device.first.rfind(':') + 1);
+        std::string path = id + "MAMA0002";
+        for (const Sample& s : device.second) {
+            char text[DuckPayload::TEXT_SIZE];
+            int length = DuckPayload::toText(s.reading, text, sizeof(text));
+            PapaJson::Message m = PapaJson::message();
+            m.deviceId = PapaJson::span((const uint8_t*)id.data(), id.size());
+            m.messageId = PapaJson::span((const uint8_t*)"ABCD", 4);
+            m.path = PapaJson::span((const uint8_t*)path.data(), path.size());
+            m.payload = PapaJson::span((const uint8_t*)text, length > 0 ? strnlen(text, sizeof(text)) : 0);
+            m.hops = 2;
+            m.duckType = 2;
+            Row row = {s.timeMs, id, s.reading, PapaJson::serialize(m, jsonBuffer, sizeof(jsonBuffer))};
+            files[file].push_back(row);
+        }
+    }
+
+    size_t rawMessages = 0, rawBytes = 0, summaryMessages = 0, summaryBytes = 0, mismatches = 0;
+    uint64_t spanMs = 0;
+    char summaryBuffer[PapaJson::BUFFER_SIZE];
+    for (auto& f : files) {
+        std::vector<Row>& rows = f.second;
+        std::stable_sort(rows.begin(), rows.end(),
+                         [](const Row& a, const Row& b) { return a.timeMs < b.timeMs; });
+        uint64_t origin = rows.front().timeMs;
+        spanMs += rows.back().timeMs - origin;
+
+        PapaSummary::Table<>* table = new PapaSummary::Table<>();
+        std::map<std::string, Expected> expected;
+        table->begin(0);
+        uint32_t nextFlush = PapaSummary::SummaryConfig::INTERVAL;
+
+        auto emit = [&](const char* json, size_t length) {
+            std::string id;
+            unsigned readings, fire;
+            double temp[4];
+            summaryMessages++;
+            summaryBytes += length;
+            if (!parseSummary(json, id, readings, fire, temp)) {
+                mismatches++;
+                return true;
+            }
+            Expected& e = expected[id];
+            double mean = e.sum / e.readings;
+            if (readings != e.readings || fire != e.fire || fabs(temp[0] - e.min) > 0.006 ||
+                fabs(temp[1] - e.max) > 0.006 || fabs(temp[2] - mean) > 0.006) {
+                if (mismatches++ < 5) {
+                    printf("mismatch %s: %u/%u readings, %u/%u fire, temp %.2f/%.2f %.2f/%.2f %.2f/%.2f\n",
+                           id.c_str(), readings, e.readings, fire, e.fire, temp[0], e.min, temp[1], e.max,
+                           temp[2], mean);
+                }
+            }
+            e = Expected();
+            return true;
+        };
+
+        for (const Row& row : rows) {
+            uint32_t at = (uint32_t)(row.timeMs - origin);
+            while (at >= nextFlush) {
+                table->flush(nextFlush, summaryBuffer, sizeof(summaryBuffer), emit);
+                nextFlush += PapaSummary::SummaryConfig::INTERVAL;
+            }
+            table->add((const uint8_t*)row.id.data(), row.id.size(), row.reading, at);
+            Expected& e = expected[row.id];
+            e.readings++;
+            e.fire += row.reading.prediction == 1;
+            e.min = std::min(e.min, (double)row.reading.temp);
+            e.max = std::max(e.max, (double)row.reading.temp);
+            e.sum += row.reading.temp;
+            rawMessages++;
+            rawBytes += row.rawJson;
+        }
+        table->flush(nextFlush, summaryBuffer, sizeof(summaryBuffer), emit);
+        if (table->counters().evictions) {
+            printf("%s: %u evictions\n", f.first.c_str(), (unsigned)table->counters().evictions);
+        }
+        delete table;
+    }
+
+    printf("%zu files, %.1f h of data, %u s summaries\n", files.size(), spanMs / 3600000.0,
+           (unsigned)(PapaSummary::SummaryConfig::INTERVAL / 1000));
+    printf("raw rows:  %7zu messages, %9zu bytes of JSON\n", rawMessages, rawBytes);
+    printf("summaries: %7zu messages, %9zu bytes of JSON (%.1fx fewer messages, %.1fx fewer bytes)\n",
+           summaryMessages, summaryBytes, (double)rawMessages / summaryMessages,
+           (double)rawBytes / summaryBytes);
+    printf("summaries checked against the rows they cover: %zu mismatches\n", mismatches);
+    return mismatches ? 1 : 0;
+}
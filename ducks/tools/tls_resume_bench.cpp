@@ -0,0 +1,394 @@
+/**
+ * @file tls_resume_bench.cpp
+ * @brief Host measurement of the PapaDuck reconnect path: TLS resumption and persistent MQTT sessions
+ *
+ * An in-process broker stands in for Mosquitto/AWS IoT on loopback: mutual
+ * TLS 1.2 with RSA-2048 certificates made at startup, and just enough MQTT
+ * for the gateway's reconnect (CONNECT/CONNACK, SUBSCRIBE, PUBLISH). While
+ * the gateway is offline the "cloud" issues one command on its command
+ * topic; the broker only keeps it for a persistent session subscribed at
+ * QoS1, as AWS IoT does.
+ *
+ * Each reconnect is timed from the TCP connect to the broker receiving the
+ * first PUBLISH, in the firmware's order: handshake, CONNECT, wait for
+ * CONNACK, SUBSCRIBE, PUBLISH. The session is carried between reconnects
+ * through PapaTls::SessionCache exactly as the firmware stores it in RTC
+ * memory. Reported per reconnect:
+ *   cpu          gateway-side crypto and protocol time on this host
+ *   round trips  network round trips before the PUBLISH leaves
+ *   bytes        handshake and MQTT bytes on the wire, both directions
+ * Loopback has no latency, so the estimate columns add the round trips at
+ * typical WiFi-to-cloud RTTs; on the ESP32 the cpu column is far larger
+ * (the RSA-2048 client signature and certificate checks take hundreds of ms), which only
+ * widens the gap in favour of resumption.
+ *
+ * Build and run from the repository root:
+ *   g++ -std=gnu++11 -O2 -Iducks/papa_duck ducks/tools/tls_resume_bench.cpp -o /tmp/tls_resume_bench \
+ *       -lssl -lcrypto -pthread
+ *   /tmp/tls_resume_bench
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <openssl/x509v3.h>
+#include "PapaTls.h"
+
+static const int RECONNECTS = 50;
+static const char* CLIENT_ID = "papa-gateway";
+
+typedef std::chrono::steady_clock Clock;
+
+static void fail(const char* what) {
+    fprintf(stderr, "%s failed\n", what);
+    ERR_print_errors_fp(stderr);
+    exit(1);
+}
+
+static X509* makeCert(EVP_PKEY* key, const char* name, X509* issuer, EVP_PKEY* issuerKey, long serial) {
+    X509* cert = X509_new();
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), serial);
+    X509_gmtime_adj(X509_getm_notBefore(cert), -3600);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 86400);
+    X509_set_pubkey(cert, key);
+    X509_NAME_add_entry_by_txt(X509_get_subject_name(cert), "CN", MBSTRING_ASC, (const unsigned char*)name, -1, -1, 0);
+    X509_set_issuer_name(cert, X509_get_subject_name(issuer ? issuer : cert));
+    if (!issuer) {
+        BASIC_CONSTRAINTS* bc = BASIC_CONSTRAINTS_new();
+        bc->ca = 1;
+        X509_add1_ext_i2d(cert, NID_basic_constraints, bc, 1, 0);
+        BASIC_CONSTRAINTS_free(bc);
+    }
+    if (!X509_sign(cert, issuerKey ? issuerKey : key, EVP_sha256())) fail("X509_sign");
+    return cert;
+}
+
+// ---- MQTT 3.1.1, only the packets the reconnect uses ----
+
+static void putString(std::vector<uint8_t>& out, const char* s) {
+    size_t n = strlen(s);
+    out.push_back((uint8_t)(n >> 8));
+    out.push_back((uint8_t)n);
+    out.insert(out.end(), s, s + n);
+}
+
+static std::vector<uint8_t> frame(uint8_t header, const std::vector<uint8_t>& body) {
+    std::vector<uint8_t> out(1, header);
+    size_t length = body.size();
+    do {
+        uint8_t b = length % 128;
+        length /= 128;
+        out.push_back(length ? b | 0x80 : b);
+    } while (length);
+    out.insert(out.end(), body.begin(), body.end());
+    return out;
+}
+
+static bool readFully(SSL* ssl, uint8_t* data, size_t length) {
+    while (length) {
+        int n = SSL_read(ssl, data, (int)length);
+        if (n <= 0) return false;
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+// Returns the packet type nibble and body, or -1 on close
+static int readPacket(SSL* ssl, std::vector<uint8_t>& body) {
+    uint8_t header;
+    if (!readFully(ssl, &header, 1)) return -1;
+    size_t length = 0, shift = 0;
+    uint8_t b;
+    do {
+        if (!readFully(ssl, &b, 1)) return -1;
+        length |= (size_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    body.resize(length);
+    if (length && !readFully(ssl, body.data(), length)) return -1;
+    return header >> 4;
+}
+
+static bool writeAll(SSL* ssl, const std::vector<uint8_t>& data) {
+    return SSL_write(ssl, data.data(), (int)data.size()) == (int)data.size();
+}
+
+// ---- Broker ----
+
+struct Broker {
+    SSL_CTX* ctx;
+    int listener;
+    uint16_t port;
+    bool tickets;
+
+    // Session state for CLIENT_ID, kept only for clean session = 0
+    bool persistent = false;
+    uint8_t subscribedQos = 0;
+    bool commandPending = false;
+    std::atomic<bool> published{false};
+    Clock::time_point publishedAt;
+
+    void serve(int fd) {
+        SSL* ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, fd);
+        if (SSL_accept(ssl) != 1) fail("SSL_accept");
+        std::vector<uint8_t> body;
+        if (readPacket(ssl, body) != 1) fail("CONNECT");
+        bool clean = (body[7] & 0x02) != 0;
+        bool present = !clean && persistent;
+        if (clean) subscribedQos = 0;
+        persistent = !clean;
+        writeAll(ssl, frame(0x20, {(uint8_t)(present ? 1 : 0), 0}));
+        // Offline queue: QoS1 messages for a persistent session
+        if (commandPending && present && subscribedQos >= 1) {
+            std::vector<uint8_t> publish;
+            putString(publish, "owl/device/papa/cmd/ping");
+            publish.push_back(0);
+            publish.push_back(1);
+            publish.push_back('1');
+            writeAll(ssl, frame(0x32, publish));
+        }
+        commandPending = false;
+        int type;
+        while ((type = readPacket(ssl, body)) > 0) {
+            if (type == 8) {  // SUBSCRIBE: id, topic, qos
+                subscribedQos = body.back();
+                writeAll(ssl, frame(0x90, {body[0], body[1], subscribedQos}));
+            } else if (type == 3 && !published) {
+                publishedAt = Clock::now();
+                published = true;
+            }
+        }
+        // Without a close_notify OpenSSL drops the session from its cache
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+        close(fd);
+    }
+
+    void run() {
+        for (;;) {
+            int fd = accept(listener, NULL, NULL);
+            if (fd < 0) return;
+            serve(fd);
+        }
+    }
+};
+
+// ---- Gateway side ----
+
+struct Result {
+    double cpuMs = 0, wallMs = 0;
+    unsigned roundTrips = 0, bytes = 0, resumed = 0, commands = 0;
+};
+
+struct Trace {
+    bool sent = false;
+    unsigned roundTrips = 0;
+};
+
+// Every record received after something was sent closes a round trip
+static void onRecord(int writeP, int, int contentType, const void*, size_t, SSL*, void* arg) {
+    if (contentType != SSL3_RT_HEADER) return;
+    Trace* t = (Trace*)arg;
+    if (writeP) {
+        t->sent = true;
+    } else if (t->sent) {
+        t->sent = false;
+        t->roundTrips++;
+    }
+}
+
+static double threadCpuMs() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void reconnect(SSL_CTX* ctx, Broker& broker, PapaTls::SessionCache& cache, bool resume, bool cleanSession,
+                      uint8_t qos, Result& result) {
+    broker.published = false;
+    broker.commandPending = true;  // issued while we were offline
+    Trace trace;
+    double cpu = threadCpuMs();
+    Clock::time_point start = Clock::now();
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(broker.port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0) fail("connect");
+
+    SSL* ssl = SSL_new(ctx);
+    SSL_set_fd(ssl, fd);
+    SSL_set_msg_callback(ssl, onRecord);
+    SSL_set_msg_callback_arg(ssl, &trace);
+    size_t length = 0;
+    const uint8_t* blob = resume ? cache.load(length) : NULL;
+    if (blob) {
+        const unsigned char* p = blob;
+        SSL_SESSION* session = d2i_SSL_SESSION(NULL, &p, (long)length);
+        if (session) {
+            SSL_set_session(ssl, session);
+            SSL_SESSION_free(session);
+        }
+    }
+    if (SSL_connect(ssl) != 1) fail("SSL_connect");
+    result.resumed += SSL_session_reused(ssl);
+
+    // PubSubClient: CONNECT and wait for CONNACK, then subscribe and publish
+    std::vector<uint8_t> connectBody;
+    putString(connectBody, "MQTT");
+    connectBody.push_back(4);
+    connectBody.push_back(cleanSession ? 0x02 : 0x00);
+    connectBody.push_back(0);
+    connectBody.push_back(15);
+    putString(connectBody, CLIENT_ID);
+    writeAll(ssl, frame(0x10, connectBody));
+    std::vector<uint8_t> body;
+    if (readPacket(ssl, body) != 2) fail("CONNACK");
+
+    std::vector<uint8_t> subscribe = {0, 1};
+    putString(subscribe, "owl/device/papa/cmd/+");
+    subscribe.push_back(qos);
+    std::vector<uint8_t> publish;
+    putString(publish, "owl/device/papa/evt/status");
+    const char* json = "{\"DeviceID\":\"PAPA0001\",\"Payload\":\"online\"}";
+    publish.insert(publish.end(), json, json + strlen(json));
+    std::vector<uint8_t> flight = frame(0x82, subscribe);
+    std::vector<uint8_t> evt = frame(0x30, publish);
+    flight.insert(flight.end(), evt.begin(), evt.end());
+    writeAll(ssl, flight);
+    while (!broker.published) std::this_thread::yield();
+
+    double wall = std::chrono::duration<double, std::milli>(broker.publishedAt - start).count();
+    result.cpuMs += threadCpuMs() - cpu;
+    result.wallMs += wall;
+    result.roundTrips += trace.roundTrips + 1;  // + the TCP handshake
+
+    // Anything the broker held for us arrives with the CONNACK
+    int type;
+    while ((type = readPacket(ssl, body)) > 0 && type != 9) {
+        if (type == 3) result.commands++;
+    }
+
+    SSL_SESSION* session = SSL_get1_session(ssl);
+    int size = i2d_SSL_SESSION(session, NULL);
+    size_t capacity = 0;
+    uint8_t* buffer = cache.prepare(capacity);
+    if (size > 0 && (size_t)size <= capacity) {
+        unsigned char* p = buffer;
+        i2d_SSL_SESSION(session, &p);
+        cache.commit((size_t)size);
+    }
+    SSL_SESSION_free(session);
+
+    result.bytes += (unsigned)(BIO_number_read(SSL_get_rbio(ssl)) + BIO_number_written(SSL_get_wbio(ssl)));
+    SSL_shutdown(ssl);
+    SSL_free(ssl);
+    close(fd);
+}
+
+int main() {
+    EVP_PKEY* caKey = EVP_RSA_gen(2048);
+    EVP_PKEY* serverKey = EVP_RSA_gen(2048);
+    EVP_PKEY* clientKey = EVP_RSA_gen(2048);
+    X509* ca = makeCert(caKey, "Duck Test CA", NULL, NULL, 1);
+    X509* serverCert = makeCert(serverKey, "localhost", ca, caKey, 2);
+    X509* clientCert = makeCert(clientKey, CLIENT_ID, ca, caKey, 3);
+
+    static PapaTls::SessionBlob blob;
+    PapaTls::SessionCache cache;
+    cache.begin(blob);
+
+    static const struct {
+        const char* name;
+        bool tickets;
+        bool resume;
+        bool cleanSession;
+        uint8_t qos;
+    } MODES[] = {
+        {"full handshake, clean, QoS0", true, false, true, 0},
+        {"resumed (session ID), persistent, QoS1", false, true, false, 1},
+        {"resumed (ticket), persistent, QoS1", true, true, false, 1},
+    };
+
+    printf("%d reconnects each, TLS 1.2 mutual auth, RSA-2048, loopback\n", RECONNECTS);
+    printf("%-40s %8s %8s %7s %7s %9s %9s %9s\n", "", "cpu ms", "wall ms", "RTs", "bytes", "resumed",
+           "@50ms", "@150ms");
+    for (const auto& mode : MODES) {
+        SSL_CTX* server = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_set_max_proto_version(server, TLS1_2_VERSION);
+        SSL_CTX_use_certificate(server, serverCert);
+        SSL_CTX_use_PrivateKey(server, serverKey);
+        X509_STORE_add_cert(SSL_CTX_get_cert_store(server), ca);
+        SSL_CTX_set_verify(server, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+        SSL_CTX_set_session_id_context(server, (const unsigned char*)"duck", 4);
+        if (!mode.tickets) SSL_CTX_set_options(server, SSL_OP_NO_TICKET);
+
+        SSL_CTX* client = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_max_proto_version(client, TLS1_2_VERSION);
+        SSL_CTX_use_certificate(client, clientCert);
+        SSL_CTX_use_PrivateKey(client, clientKey);
+        X509_STORE_add_cert(SSL_CTX_get_cert_store(client), ca);
+        SSL_CTX_set_verify(client, SSL_VERIFY_PEER, NULL);
+        SSL_CTX_set_session_cache_mode(client, SSL_SESS_CACHE_OFF);
+
+        Broker broker;
+        broker.ctx = server;
+        broker.tickets = mode.tickets;
+        broker.listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addrLength = sizeof(addr);
+        if (bind(broker.listener, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(broker.listener, 4) != 0) {
+            fail("listen");
+        }
+        getsockname(broker.listener, (sockaddr*)&addr, &addrLength);
+        broker.port = ntohs(addr.sin_port);
+        std::thread thread(&Broker::run, &broker);
+
+        cache.clear();
+        Result r;
+        // The first connect is always full and primes the caches
+        Result warmup;
+        reconnect(client, broker, cache, mode.resume, mode.cleanSession, mode.qos, warmup);
+        for (int i = 0; i < RECONNECTS; i++) {
+            reconnect(client, broker, cache, mode.resume, mode.cleanSession, mode.qos, r);
+        }
+        shutdown(broker.listener, SHUT_RDWR);
+        close(broker.listener);
+        thread.join();
+
+        double rts = (double)r.roundTrips / RECONNECTS;
+        double cpu = r.cpuMs / RECONNECTS;
+        printf("%-40s %8.2f %8.2f %7.1f %7u %8d%% %9.0f %9.0f   commands delivered %u/%d\n", mode.name, cpu,
+               r.wallMs / RECONNECTS, rts, r.bytes / RECONNECTS, (int)(100 * r.resumed / RECONNECTS),
+               cpu + rts * 50, cpu + rts * 150, r.commands, RECONNECTS);
+        SSL_CTX_free(server);
+        SSL_CTX_free(client);
+    }
+    return 0;
+}